@@ -0,0 +1,73 @@
+// ============================================
+// ARCHIVO: Alfabeto.cxx
+// ============================================
+#include "Alfabeto.h"
+
+template <typename A>
+static bool cubre(const bool presentes[256]) {
+    for (int c = 0; c < 256; c++) {
+        if (presentes[c] && TablasAlfabeto<A>::RANGO[c] < 0) return false;
+    }
+    return true;
+}
+
+static TipoAlfabeto elegir(const bool presentes[256]) {
+    if (cubre<AlfabetoADN>(presentes)) return ALFABETO_ADN;
+    if (cubre<AlfabetoIUPAC>(presentes)) return ALFABETO_IUPAC;
+    if (cubre<AlfabetoProteina>(presentes)) return ALFABETO_PROTEINA;
+    return ALFABETO_BYTES;
+}
+
+template <typename A>
+static void marcarSimbolos(bool presentes[256]) {
+    for (int r = 0; r < A::TAMANO; r++) presentes[(unsigned char)A::simbolo(r)] = true;
+}
+
+static void marcarBytes(const char* bases, size_t n, bool presentes[256]) {
+    for (size_t i = 0; i < n; i++) presentes[(unsigned char)bases[i]] = true;
+}
+
+TipoAlfabeto Alfabeto::detectar(const char* bases, size_t n) {
+    bool presentes[256] = {};
+    marcarBytes(bases, n, presentes);
+    return elegir(presentes);
+}
+
+TipoAlfabeto Alfabeto::ampliar(TipoAlfabeto actual, const char* bases, size_t n) {
+    bool presentes[256] = {};
+    switch (actual) {
+        case ALFABETO_ADN: marcarSimbolos<AlfabetoADN>(presentes); break;
+        case ALFABETO_IUPAC: marcarSimbolos<AlfabetoIUPAC>(presentes); break;
+        case ALFABETO_PROTEINA: marcarSimbolos<AlfabetoProteina>(presentes); break;
+        case ALFABETO_BYTES: return ALFABETO_BYTES;
+    }
+    marcarBytes(bases, n, presentes);
+    return elegir(presentes);
+}
+
+const char* Alfabeto::nombre(TipoAlfabeto tipo) {
+    switch (tipo) {
+        case ALFABETO_ADN: return "ADN";
+        case ALFABETO_IUPAC: return "IUPAC";
+        case ALFABETO_PROTEINA: return "proteína";
+        case ALFABETO_BYTES: return "bytes";
+    }
+    return "bytes";
+}
+
+template <typename A>
+static void contarEnBytes(const char* bases, size_t n, uint64_t* cuentas) {
+    uint64_t porRango[A::TAMANO];
+    contarPorRango<A>(bases, n, porRango);
+    for (int c = 0; c < 256; c++) cuentas[c] = 0;
+    for (int r = 0; r < A::TAMANO; r++) cuentas[(unsigned char)A::simbolo(r)] = porRango[r];
+}
+
+void Alfabeto::contar(TipoAlfabeto tipo, const char* bases, size_t n, uint64_t* cuentas) {
+    switch (tipo) {
+        case ALFABETO_ADN: contarEnBytes<AlfabetoADN>(bases, n, cuentas); break;
+        case ALFABETO_IUPAC: contarEnBytes<AlfabetoIUPAC>(bases, n, cuentas); break;
+        case ALFABETO_PROTEINA: contarEnBytes<AlfabetoProteina>(bases, n, cuentas); break;
+        case ALFABETO_BYTES: contarEnBytes<AlfabetoBytes>(bases, n, cuentas); break;
+    }
+}
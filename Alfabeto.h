@@ -0,0 +1,134 @@
+// ============================================
+// ARCHIVO: Alfabeto.h
+// ============================================
+#ifndef ALFABETO_H
+#define ALFABETO_H
+
+#include <cstdint>
+#include <cstddef>
+
+// Alfabetos de menor a mayor: cada secuencia usa el primero que cubre
+// todos sus símbolos, y los bucles internos indexan arreglos densos por
+// rango en lugar de mapas por carácter
+enum TipoAlfabeto { ALFABETO_ADN, ALFABETO_IUPAC, ALFABETO_PROTEINA, ALFABETO_BYTES };
+
+constexpr int rangoEnSimbolos(const char* simbolos, int c, int i) {
+    return simbolos[i] == '\0' ? -1 : simbolos[i] == c ? i : rangoEnSimbolos(simbolos, c, i + 1);
+}
+
+// Peso de la arista entre dos bases del grafo
+constexpr double pesoEntreBases(int base1, int base2) {
+    return 1.0 / (1.0 + (base1 > base2 ? base1 - base2 : base2 - base1));
+}
+
+struct AlfabetoADN {
+    static constexpr TipoAlfabeto TIPO = ALFABETO_ADN;
+    static constexpr int TAMANO = 4;
+    static constexpr int rango(int c) { return rangoEnSimbolos("ACGT", c, 0); }
+    static constexpr char simbolo(int r) { return "ACGT"[r]; }
+    static constexpr char complemento(int c) {
+        return c == 'A' ? 'T' : c == 'T' ? 'A' : c == 'C' ? 'G' : c == 'G' ? 'C' : (char)c;
+    }
+};
+
+// Los 15 códigos IUPAC de nucleótidos más el hueco
+struct AlfabetoIUPAC {
+    static constexpr TipoAlfabeto TIPO = ALFABETO_IUPAC;
+    static constexpr int TAMANO = 16;
+    static constexpr int rango(int c) { return rangoEnSimbolos("ACGTRYSWKMBDHVN-", c, 0); }
+    static constexpr char simbolo(int r) { return "ACGTRYSWKMBDHVN-"[r]; }
+    // Cada código con su complementario en la misma posición
+    static constexpr char complemento(int c) {
+        return rangoEnSimbolos("ACGTRYSWKMBDHVN-", c, 0) < 0 ? (char)c
+             : "TGCAYRSWMKVHDBN-"[rangoEnSimbolos("ACGTRYSWKMBDHVN-", c, 0)];
+    }
+};
+
+struct AlfabetoProteina {
+    static constexpr TipoAlfabeto TIPO = ALFABETO_PROTEINA;
+    static constexpr int TAMANO = 20;
+    static constexpr int rango(int c) { return rangoEnSimbolos("ACDEFGHIKLMNPQRSTVWY", c, 0); }
+    static constexpr char simbolo(int r) { return "ACDEFGHIKLMNPQRSTVWY"[r]; }
+    static constexpr char complemento(int c) { return (char)c; }
+};
+
+struct AlfabetoBytes {
+    static constexpr TipoAlfabeto TIPO = ALFABETO_BYTES;
+    static constexpr int TAMANO = 256;
+    static constexpr int rango(int c) { return c; }
+    static constexpr char simbolo(int r) { return (char)r; }
+    static constexpr char complemento(int c) { return (char)c; }
+};
+
+// Secuencia 0..N-1 de enteros en tiempo de compilación, para inicializar
+// arreglos constexpr elemento por elemento
+template <int... I> struct Indices {};
+template <int N, int... I> struct GenerarIndices : GenerarIndices<N - 1, N - 1, I...> {};
+template <int... I> struct GenerarIndices<0, I...> { typedef Indices<I...> tipo; };
+
+// Rango y complemento de cada byte (rango -1 si no pertenece al alfabeto)
+template <typename A, typename I = typename GenerarIndices<256>::tipo> struct TablasAlfabeto;
+
+template <typename A, int... I> struct TablasAlfabeto<A, Indices<I...>> {
+    static constexpr int16_t RANGO[256] = { (int16_t)A::rango(I)... };
+    static constexpr char COMPLEMENTO[256] = { A::complemento(I)... };
+};
+template <typename A, int... I> constexpr int16_t TablasAlfabeto<A, Indices<I...>>::RANGO[256];
+template <typename A, int... I> constexpr char TablasAlfabeto<A, Indices<I...>>::COMPLEMENTO[256];
+
+// Matriz de pesos por par de rangos, PESO[r1 * TAMANO + r2]. Para bytes la
+// matriz ocuparía 512 KB, así que se indexa por la diferencia (+255) de
+// los bytes con signo, como char.
+template <typename A> struct IndicesPesos {
+    typedef typename GenerarIndices<A::TAMANO * A::TAMANO>::tipo tipo;
+};
+template <> struct IndicesPesos<AlfabetoBytes> { typedef GenerarIndices<511>::tipo tipo; };
+
+template <typename A, typename I = typename IndicesPesos<A>::tipo> struct PesosAlfabeto;
+
+template <typename A, int... I> struct PesosAlfabeto<A, Indices<I...>> {
+    static constexpr double PESO[sizeof...(I)] = {
+        pesoEntreBases(A::simbolo(I / A::TAMANO), A::simbolo(I % A::TAMANO))...
+    };
+    static double peso(int rango1, int rango2) { return PESO[rango1 * A::TAMANO + rango2]; }
+};
+template <typename A, int... I> constexpr double PesosAlfabeto<A, Indices<I...>>::PESO[sizeof...(I)];
+
+template <int... I> struct PesosAlfabeto<AlfabetoBytes, Indices<I...>> {
+    static constexpr double PESO[sizeof...(I)] = { pesoEntreBases(I, 255)... };
+    static double peso(int base1, int base2) { return PESO[(signed char)base1 - (signed char)base2 + 255]; }
+};
+template <int... I> constexpr double PesosAlfabeto<AlfabetoBytes, Indices<I...>>::PESO[sizeof...(I)];
+
+// Cuenta las bases por rango en cuentas[A::TAMANO]. Cuatro juegos de
+// contadores evitan que bases iguales seguidas esperen al mismo contador.
+template <typename A>
+void contarPorRango(const char* bases, size_t n, uint64_t* cuentas) {
+    const int16_t* rango = TablasAlfabeto<A>::RANGO;
+    uint64_t parciales[4][A::TAMANO] = {};
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        parciales[0][rango[(unsigned char)bases[i]]]++;
+        parciales[1][rango[(unsigned char)bases[i + 1]]]++;
+        parciales[2][rango[(unsigned char)bases[i + 2]]]++;
+        parciales[3][rango[(unsigned char)bases[i + 3]]]++;
+    }
+    for (; i < n; i++) parciales[0][rango[(unsigned char)bases[i]]]++;
+    for (int r = 0; r < A::TAMANO; r++) {
+        cuentas[r] = parciales[0][r] + parciales[1][r] + parciales[2][r] + parciales[3][r];
+    }
+}
+
+class Alfabeto {
+public:
+    // Primer alfabeto que cubre todos los bytes dados
+    static TipoAlfabeto detectar(const char* bases, size_t n);
+    // Primer alfabeto que cubre 'actual' y además los bytes dados
+    static TipoAlfabeto ampliar(TipoAlfabeto actual, const char* bases, size_t n);
+    static const char* nombre(TipoAlfabeto tipo);
+    // Cuenta cada byte en cuentas[256] con el bucle del alfabeto dado; todas
+    // las bases deben pertenecer a él
+    static void contar(TipoAlfabeto tipo, const char* bases, size_t n, uint64_t* cuentas);
+};
+
+#endif
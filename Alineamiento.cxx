@@ -0,0 +1,477 @@
+// ============================================
+// ARCHIVO: Alineamiento.cxx
+// ============================================
+#include "Alineamiento.h"
+#include "Instrumentacion.h"
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <climits>
+#include <vector>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+static const int64_t NEG = INT64_MIN / 4;
+
+struct TablaMayusculas {
+    uint8_t valor[256];
+    TablaMayusculas() {
+        for (int c = 0; c < 256; c++) valor[c] = toupper(c);
+    }
+};
+static const TablaMayusculas MAYUSCULAS;
+
+static inline int puntuar(char x, char y, const ParametrosAlineamiento& p) {
+    return MAYUSCULAS.valor[(uint8_t)x] == MAYUSCULAS.valor[(uint8_t)y] ? p.coincidencia : p.diferencia;
+}
+
+// Diagonales j - i permitidas; siempre incluye las dos esquinas
+struct Banda {
+    long dmin, dmax;
+};
+
+static Banda bandaDe(long ancho, size_t n, size_t m) {
+    Banda banda;
+    if (ancho < 0) {
+        banda.dmin = -(long)n;
+        banda.dmax = (long)m;
+    } else {
+        long diferencia = (long)m - (long)n;
+        banda.dmin = std::min(0L, diferencia) - ancho;
+        banda.dmax = std::max(0L, diferencia) + ancho;
+    }
+    return banda;
+}
+
+// La misma banda vista desde la celda (desdeA, desdeB) o, invertida, con
+// esa celda como origen de las secuencias al revés
+static Banda desplazar(Banda banda, size_t desdeA, size_t desdeB, bool invertida) {
+    long d = (long)desdeB - (long)desdeA;
+    Banda r;
+    if (invertida) {
+        r.dmin = d - banda.dmax;
+        r.dmax = d - banda.dmin;
+    } else {
+        r.dmin = banda.dmin - d;
+        r.dmax = banda.dmax - d;
+    }
+    return r;
+}
+
+static uint64_t celdasEnBanda(size_t n, size_t m, Banda banda) {
+    uint64_t total = 0;
+    for (size_t i = 1; i <= n; i++) {
+        long desde = std::max(1L, (long)i + banda.dmin), hasta = std::min((long)m, (long)i + banda.dmax);
+        if (hasta >= desde) total += hasta - desde + 1;
+    }
+    return total;
+}
+
+enum TipoDP { DP_LOCAL, DP_GLOBAL, DP_ANCLADO };
+
+// Origen de cada celda: bits 0-1 de dónde viene H (0 diagonal, 1 E, 2 F,
+// 3 cero local); bit 2 si E extiende un hueco; bit 3 si F lo extiende
+struct Traza {
+    std::vector<uint8_t> celdas;
+    std::vector<size_t> inicioFila, primeraColumna;
+};
+
+// Gotoh fila a fila dentro de la banda, con dos filas de memoria más la
+// traza opcional. DP_LOCAL devuelve el máximo y su celda, DP_GLOBAL la
+// esquina final y DP_ANCLADO (global sin esquina final fija) la primera
+// celda que alcanza 'objetivo', o NEG.
+static int64_t programacionDinamica(const char* a, size_t n, const char* b, size_t m, const ParametrosAlineamiento& p,
+                                    TipoDP tipo, Banda banda, int64_t objetivo, size_t& finA, size_t& finB,
+                                    Traza* traza, uint64_t& celdas) {
+    const int64_t abrir = p.apertura + p.extension, extender = p.extension;
+    const bool local = tipo == DP_LOCAL;
+    std::vector<int64_t> H(m + 1, NEG), F(m + 1, NEG);
+    H[0] = 0;
+    for (size_t j = 1; j <= m && (long)j <= banda.dmax; j++) H[j] = local ? 0 : -(p.apertura + (int64_t)j * extender);
+
+    int64_t mejor = 0;
+    finA = finB = 0;
+    if (traza) {
+        traza->celdas.clear();
+        traza->inicioFila.assign(n + 1, 0);
+        traza->primeraColumna.assign(n + 1, 0);
+    }
+
+    for (size_t i = 1; i <= n; i++) {
+        long lo = (long)i + banda.dmin, hi = std::min((long)m, (long)i + banda.dmax);
+        size_t desde = std::max(1L, lo);
+        int64_t diag, hIzquierda, e = NEG;
+        if (lo <= 0) {
+            diag = H[0];
+            H[0] = local ? 0 : -(p.apertura + (int64_t)i * extender);
+            hIzquierda = H[0];
+        } else {
+            diag = H[desde - 1];
+            H[desde - 1] = NEG;
+            hIzquierda = NEG;
+        }
+        if (traza) {
+            traza->inicioFila[i] = traza->celdas.size();
+            traza->primeraColumna[i] = desde;
+        }
+        if (hi >= (long)desde) celdas += hi - desde + 1;
+
+        const char ai = a[i - 1];
+        for (size_t j = desde; (long)j <= hi; j++) {
+            uint8_t origen = 0;
+            int64_t eSeguir = e - extender, eAbrir = hIzquierda - abrir;
+            if (eSeguir >= eAbrir) {
+                e = eSeguir;
+                origen |= 4;
+            } else {
+                e = eAbrir;
+            }
+            int64_t arriba = H[j];
+            int64_t fSeguir = F[j] - extender, fAbrir = arriba - abrir, f;
+            if (fSeguir >= fAbrir) {
+                f = fSeguir;
+                origen |= 8;
+            } else {
+                f = fAbrir;
+            }
+            int64_t h = diag + puntuar(ai, b[j - 1], p);
+            if (e > h) {
+                h = e;
+                origen |= 1;
+            }
+            if (f > h) {
+                h = f;
+                origen = (origen & ~3) | 2;
+            }
+            if (local && h <= 0) {
+                h = 0;
+                origen |= 3;
+            }
+            diag = arriba;
+            H[j] = h;
+            F[j] = f;
+            hIzquierda = h;
+            if (traza) traza->celdas.push_back(origen);
+
+            if (local) {
+                if (h > mejor) {
+                    mejor = h;
+                    finA = i;
+                    finB = j;
+                }
+            } else if (tipo == DP_ANCLADO && h == objetivo) {
+                finA = i;
+                finB = j;
+                return h;
+            }
+        }
+    }
+    if (local) return mejor;
+    if (tipo == DP_ANCLADO) return NEG;
+    finA = n;
+    finB = m;
+    return H[m];
+}
+
+#ifdef __SSE2__
+// __m128i dentro de un struct para guardarlo en vectores
+struct Registro {
+    __m128i v;
+};
+
+// Operaciones por carril del método rayado. Con 8 bits los valores son sin
+// signo y los puntajes llevan un sesgo que se resta tras sumarlos, así que
+// la saturación en 0 hace de cero local.
+struct Carriles8 {
+    typedef uint8_t Tipo;
+    static const int CARRILES = 16, MAXIMO = 255, RELLENO = 0;
+    static const bool SESGADO = true;
+    static __m128i repetir(int x) { return _mm_set1_epi8((char)x); }
+    static __m128i sumar(__m128i a, __m128i b) { return _mm_adds_epu8(a, b); }
+    static __m128i restar(__m128i a, __m128i b) { return _mm_subs_epu8(a, b); }
+    static __m128i maximo(__m128i a, __m128i b) { return _mm_max_epu8(a, b); }
+    static bool algunoMayor(__m128i a, __m128i b) {
+        return _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_subs_epu8(a, b), _mm_setzero_si128())) != 0xFFFF;
+    }
+    static __m128i desplazar(__m128i a) { return _mm_slli_si128(a, 1); }
+};
+
+struct Carriles16 {
+    typedef int16_t Tipo;
+    static const int CARRILES = 8, MAXIMO = 32767, RELLENO = -16384;
+    static const bool SESGADO = false;
+    static __m128i repetir(int x) { return _mm_set1_epi16((short)x); }
+    static __m128i sumar(__m128i a, __m128i b) { return _mm_adds_epi16(a, b); }
+    static __m128i restar(__m128i a, __m128i b) { return _mm_subs_epi16(a, b); }
+    static __m128i maximo(__m128i a, __m128i b) { return _mm_max_epi16(a, b); }
+    static bool algunoMayor(__m128i a, __m128i b) { return _mm_movemask_epi8(_mm_cmpgt_epi16(a, b)) != 0; }
+    static __m128i desplazar(__m128i a) { return _mm_slli_si128(a, 2); }
+};
+
+// Smith-Waterman rayado (Farrar): la base i de 'a' va en el carril
+// i / segmentos, vector i % segmentos. Falso si el puntaje puede haberse
+// saturado.
+template <typename C>
+static bool localRayado(const char* a, size_t n, const char* b, size_t m, const ParametrosAlineamiento& p,
+                        int64_t& puntaje, size_t& finA, size_t& finB) {
+    const int L = C::CARRILES;
+    const size_t segmentos = (n + L - 1) / L;
+    const int sesgo = C::SESGADO ? -p.diferencia : 0;
+    const int limite = C::MAXIMO - sesgo - p.coincidencia;
+
+    // Perfil de la consulta para cada símbolo presente en b
+    std::vector<int> indicePerfil(256, -1);
+    std::vector<Registro> perfil;
+    typename C::Tipo carriles[L];
+    for (size_t j = 0; j < m; j++) {
+        uint8_t s = MAYUSCULAS.valor[(uint8_t)b[j]];
+        if (indicePerfil[s] >= 0) continue;
+        indicePerfil[s] = perfil.size() / segmentos;
+        for (size_t t = 0; t < segmentos; t++) {
+            for (int k = 0; k < L; k++) {
+                size_t i = k * segmentos + t;
+                carriles[k] = i < n ? puntuar(a[i], (char)s, p) + sesgo : C::RELLENO;
+            }
+            Registro r = { _mm_loadu_si128((const __m128i*)carriles) };
+            perfil.push_back(r);
+        }
+    }
+
+    const __m128i cero = _mm_setzero_si128();
+    const __m128i vAbrir = C::repetir(p.apertura + p.extension), vExtender = C::repetir(p.extension);
+    const __m128i vSesgo = C::repetir(sesgo);
+    const Registro inicial = { cero };
+    std::vector<Registro> hCarga(segmentos, inicial), hGuarda(segmentos, inicial), vE(segmentos, inicial);
+    int mejor = 0;
+    finA = finB = 0;
+
+    for (size_t j = 0; j < m; j++) {
+        const Registro* vP = &perfil[indicePerfil[MAYUSCULAS.valor[(uint8_t)b[j]]] * segmentos];
+        __m128i vF = cero, vMax = cero;
+        __m128i vH = C::desplazar(hGuarda[segmentos - 1].v);
+        std::swap(hCarga, hGuarda);
+
+        for (size_t t = 0; t < segmentos; t++) {
+            vH = C::maximo(C::restar(C::sumar(vH, vP[t].v), vSesgo), cero);
+            __m128i e = vE[t].v;
+            vH = C::maximo(C::maximo(vH, e), vF);
+            vMax = C::maximo(vMax, vH);
+            hGuarda[t].v = vH;
+            vH = C::restar(vH, vAbrir);
+            vE[t].v = C::maximo(C::restar(e, vExtender), vH);
+            vF = C::maximo(C::restar(vF, vExtender), vH);
+            vH = hCarga[t].v;
+        }
+
+        // F perezosa: los huecos verticales que pasan de un carril al
+        // siguiente, solo mientras todavía mejoren alguna celda. Sin costo
+        // de apertura, una F que sube H empata con abrir desde esa H y se
+        // compara con la H anterior.
+        for (int k = 0; k < L; k++) {
+            vF = C::desplazar(vF);
+            bool sigue = true;
+            for (size_t t = 0; t < segmentos && sigue; t++) {
+                __m128i anterior = hGuarda[t].v;
+                vH = C::maximo(anterior, vF);
+                hGuarda[t].v = vH;
+                vMax = C::maximo(vMax, vH);
+                vH = C::restar(vH, vAbrir);
+                vE[t].v = C::maximo(vE[t].v, vH);
+                vF = C::restar(vF, vExtender);
+                sigue = C::algunoMayor(vF, p.apertura > 0 ? vH : C::restar(anterior, vAbrir));
+            }
+            if (!sigue) break;
+        }
+
+        if (!C::algunoMayor(vMax, C::repetir(mejor))) continue;
+        _mm_storeu_si128((__m128i*)carriles, vMax);
+        int maximo = *std::max_element(carriles, carriles + L);
+        if (maximo >= limite) return false;
+        mejor = maximo;
+        finB = j + 1;
+        finA = n + 1;
+        for (size_t t = 0; t < segmentos; t++) {
+            _mm_storeu_si128((__m128i*)carriles, hGuarda[t].v);
+            for (int k = 0; k < L; k++) {
+                size_t i = k * segmentos + t;
+                if (carriles[k] == mejor && i < n) finA = std::min(finA, i + 1);
+            }
+        }
+    }
+    puntaje = mejor;
+    return true;
+}
+#endif
+
+// Puntaje local y la celda donde termina, con la banda o sin ella
+static int64_t puntajeLocal(const char* a, size_t n, const char* b, size_t m, const ParametrosAlineamiento& p,
+                            Banda banda, bool conBanda, size_t& finA, size_t& finB, int& bits, uint64_t& celdas) {
+    finA = finB = 0;
+    bits = 64;
+    if (n == 0 || m == 0) return 0;
+#ifdef __SSE2__
+    if (!conBanda) {
+        int64_t puntaje;
+        if (localRayado<Carriles8>(a, n, b, m, p, puntaje, finA, finB)) {
+            bits = 8;
+            celdas += (uint64_t)n * m;
+            return puntaje;
+        }
+        if (localRayado<Carriles16>(a, n, b, m, p, puntaje, finA, finB)) {
+            bits = 16;
+            celdas += (uint64_t)n * m;
+            return puntaje;
+        }
+    }
+#endif
+    return programacionDinamica(a, n, b, m, p, DP_LOCAL, banda, 0, finA, finB, nullptr, celdas);
+}
+
+// CIGAR recorriendo la traza desde (i, j) hasta el origen
+static void trazar(const Traza& traza, size_t i, size_t j, const char* a, const char* b, ResultadoAlineamiento& r) {
+    std::vector<std::pair<char, size_t>> operaciones;
+    auto agregar = [&](char op) {
+        if (!operaciones.empty() && operaciones.back().first == op) operaciones.back().second++;
+        else operaciones.push_back(std::make_pair(op, (size_t)1));
+        r.columnas++;
+    };
+
+    int estado = 0;     // 0 H, 1 E, 2 F
+    while (i > 0 && j > 0) {
+        uint8_t origen = traza.celdas[traza.inicioFila[i] + (j - traza.primeraColumna[i])];
+        if (estado == 0) {
+            estado = origen & 3;
+            if (estado == 0) {
+                agregar('M');
+                if (MAYUSCULAS.valor[(uint8_t)a[i - 1]] == MAYUSCULAS.valor[(uint8_t)b[j - 1]]) r.coincidencias++;
+                i--;
+                j--;
+                continue;
+            }
+        }
+        if (estado == 1) {
+            agregar('D');
+            estado = (origen & 4) ? 1 : 0;
+            j--;
+        } else {
+            agregar('I');
+            estado = (origen & 8) ? 2 : 0;
+            i--;
+        }
+    }
+    for (; i > 0; i--) agregar('I');
+    for (; j > 0; j--) agregar('D');
+
+    r.cigar.clear();
+    for (auto it = operaciones.rbegin(); it != operaciones.rend(); ++it) {
+        r.cigar += std::to_string(it->second) + it->first;
+    }
+}
+
+// Alineamiento global con traza de a[desdeA, hastaA) contra b[desdeB, hastaB)
+static bool trazarRegion(const char* a, size_t desdeA, size_t hastaA, const char* b, size_t desdeB, size_t hastaB,
+                         const ParametrosAlineamiento& p, Banda banda, int64_t& puntaje, ResultadoAlineamiento& r,
+                         std::string& error) {
+    size_t n = hastaA - desdeA, m = hastaB - desdeB;
+    Banda region = desplazar(banda, desdeA, desdeB, false);
+    uint64_t necesarias = celdasEnBanda(n, m, region);
+    if (necesarias > Alineamiento::CELDAS_MAXIMAS_TRAZA) {
+        error = "la traza necesita " + std::to_string(necesarias) + " celdas (máximo " +
+                std::to_string(Alineamiento::CELDAS_MAXIMAS_TRAZA) + "); use --banda o --solo-puntaje";
+        return false;
+    }
+    Traza traza;
+    traza.celdas.reserve(necesarias);
+    size_t finA, finB;
+    puntaje = programacionDinamica(a + desdeA, n, b + desdeB, m, p, DP_GLOBAL, region, 0, finA, finB, &traza, r.celdas);
+    r.cigar.clear();
+    r.coincidencias = r.columnas = 0;
+    trazar(traza, n, m, a + desdeA, b + desdeB, r);
+    return true;
+}
+
+bool Alineamiento::alinear(const char* a, size_t n, const char* b, size_t m, const ParametrosAlineamiento& p,
+                           ResultadoAlineamiento& r, std::string& error) {
+    MEDIR_FASE("alinear");
+    auto inicio = std::chrono::steady_clock::now();
+    r = ResultadoAlineamiento();
+    Banda banda = bandaDe(p.banda, n, m);
+    bool conBanda = p.banda >= 0;
+
+    if (p.modo == ALINEAMIENTO_GLOBAL) {
+        r.bits = 64;
+        r.fin1 = n;
+        r.fin2 = m;
+        if (p.soloPuntaje) {
+            size_t finA, finB;
+            r.puntaje = programacionDinamica(a, n, b, m, p, DP_GLOBAL, banda, 0, finA, finB, nullptr, r.celdas);
+        } else if (!trazarRegion(a, 0, n, b, 0, m, p, banda, r.puntaje, r, error)) {
+            return false;
+        }
+    } else {
+        size_t finA, finB;
+        r.puntaje = puntajeLocal(a, n, b, m, p, banda, conBanda, finA, finB, r.bits, r.celdas);
+        r.inicio1 = r.fin1 = finA;
+        r.inicio2 = r.fin2 = finB;
+
+        if (!p.soloPuntaje && r.puntaje > 0) {
+            // El inicio es donde termina el mejor alineamiento local de los
+            // prefijos invertidos
+            std::string invA(a, finA), invB(b, finB);
+            std::reverse(invA.begin(), invA.end());
+            std::reverse(invB.begin(), invB.end());
+            Banda invertida = desplazar(banda, finA, finB, true);
+            size_t largoA, largoB;
+            int bits;
+            puntajeLocal(invA.data(), finA, invB.data(), finB, p, invertida, conBanda, largoA, largoB, bits, r.celdas);
+
+            int64_t puntaje;
+            if (!trazarRegion(a, finA - largoA, finA, b, finB - largoB, finB, p, banda, puntaje, r, error)) return false;
+            if (puntaje != r.puntaje) {
+                // Ese alineamiento no llega a (finA, finB): se busca uno que
+                // parta de la esquina de los prefijos invertidos
+                programacionDinamica(invA.data(), finA, invB.data(), finB, p, DP_ANCLADO, invertida, r.puntaje,
+                                     largoA, largoB, nullptr, r.celdas);
+                if (!trazarRegion(a, finA - largoA, finA, b, finB - largoB, finB, p, banda, puntaje, r, error)) {
+                    return false;
+                }
+            }
+            r.inicio1 = finA - largoA;
+            r.inicio2 = finB - largoB;
+        }
+    }
+
+    BYTES_FASE(n + m);
+    r.segundos = std::chrono::duration<double>(std::chrono::steady_clock::now() - inicio).count();
+    return true;
+}
+
+int64_t Alineamiento::puntajeEscalar(const char* a, size_t n, const char* b, size_t m, const ParametrosAlineamiento& p) {
+    size_t finA, finB;
+    uint64_t celdas = 0;
+    TipoDP tipo = p.modo == ALINEAMIENTO_LOCAL ? DP_LOCAL : DP_GLOBAL;
+    return programacionDinamica(a, n, b, m, p, tipo, bandaDe(p.banda, n, m), 0, finA, finB, nullptr, celdas);
+}
+
+int64_t Alineamiento::puntuarCigar(const char* a, const char* b, const std::string& cigar,
+                                   const ParametrosAlineamiento& p) {
+    int64_t puntaje = 0;
+    size_t largo = 0;
+    for (char c : cigar) {
+        if (isdigit((unsigned char)c)) {
+            largo = largo * 10 + (c - '0');
+            continue;
+        }
+        if (c == 'M') {
+            for (size_t k = 0; k < largo; k++) puntaje += puntuar(*a++, *b++, p);
+        } else {
+            puntaje -= p.apertura + (int64_t)largo * p.extension;
+            if (c == 'I') a += largo;
+            else b += largo;
+        }
+        largo = 0;
+    }
+    return puntaje;
+}
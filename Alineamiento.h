@@ -0,0 +1,58 @@
+// ============================================
+// ARCHIVO: Alineamiento.h
+// ============================================
+#ifndef ALINEAMIENTO_H
+#define ALINEAMIENTO_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+enum ModoAlineamiento { ALINEAMIENTO_LOCAL, ALINEAMIENTO_GLOBAL };
+
+// Puntajes con huecos afines: un hueco de L bases cuesta apertura + L * extension
+struct ParametrosAlineamiento {
+    ModoAlineamiento modo;
+    int coincidencia, diferencia, apertura, extension;
+    long banda;             // diagonales a cada lado de la principal; -1 sin banda
+    bool soloPuntaje;
+    ParametrosAlineamiento()
+        : modo(ALINEAMIENTO_LOCAL), coincidencia(2), diferencia(-3), apertura(5), extension(2),
+          banda(-1), soloPuntaje(false) {}
+};
+
+struct ResultadoAlineamiento {
+    int64_t puntaje;
+    int bits;                       // precisión de la pasada de puntaje: 8, 16 o 64
+    size_t inicio1, fin1;           // [inicio, fin) alineado de cada secuencia
+    size_t inicio2, fin2;
+    std::string cigar;              // M, I (solo en la 1) y D (solo en la 2)
+    size_t coincidencias, columnas;
+    uint64_t celdas;
+    double segundos;
+    ResultadoAlineamiento()
+        : puntaje(0), bits(0), inicio1(0), fin1(0), inicio2(0), fin2(0), coincidencias(0), columnas(0),
+          celdas(0), segundos(0) {}
+    double gcups() const { return segundos > 0 ? celdas / segundos / 1e9 : 0; }
+};
+
+// Alineamiento de dos secuencias. El puntaje local sin banda usa el método
+// rayado de Farrar (SSE2) con 16 carriles de 8 bits, y repite con 8 de 16
+// bits o con la versión escalar si el puntaje se satura. La traza se
+// guarda solo para la región alineada, hallada alineando los prefijos
+// invertidos; el modo solo puntaje usa memoria lineal.
+class Alineamiento {
+public:
+    static const uint64_t CELDAS_MAXIMAS_TRAZA = 1ULL << 28;
+    
+    // Falso si la traza no cabe en CELDAS_MAXIMAS_TRAZA; 'error' dice por qué
+    static bool alinear(const char* a, size_t n, const char* b, size_t m, const ParametrosAlineamiento& p,
+                        ResultadoAlineamiento& r, std::string& error);
+    // Puntaje con la programación dinámica escalar, sin el método rayado
+    static int64_t puntajeEscalar(const char* a, size_t n, const char* b, size_t m, const ParametrosAlineamiento& p);
+    // Puntaje de un CIGAR que empieza en a y b
+    static int64_t puntuarCigar(const char* a, const char* b, const std::string& cigar,
+                                const ParametrosAlineamiento& p);
+};
+
+#endif
@@ -2,6 +2,7 @@
 // ARCHIVO: ArbolHuffman.cxx
 // ============================================
 #include "ArbolHuffman.h"
+#include "Instrumentacion.h"
 #include <queue>
 #include <algorithm>
 
@@ -18,6 +19,7 @@ ArbolHuffman::~ArbolHuffman() {
 }
 
 void ArbolHuffman::construir(const std::map<char, uint64_t>& frecuencias) {
+    MEDIR_FASE("huffman.arbol");
     if (frecuencias.empty()) return;
     
     std::priority_queue<NodoHuffman*, std::vector<NodoHuffman*>, CompararNodos> cola;
@@ -37,6 +39,11 @@ void ArbolHuffman::construir(const std::map<char, uint64_t>& frecuencias) {
     raiz = cola.top();
     codigos.clear();
     construirCodigos(raiz, "");
+    
+    codigosPorByte.assign(256, std::string());
+    for (const auto& par : codigos) {
+        codigosPorByte[(unsigned char)par.first] = par.second;
+    }
 }
 
 void ArbolHuffman::construirCodigos(NodoHuffman* nodo, const std::string& codigo) {
@@ -50,16 +57,27 @@ void ArbolHuffman::construirCodigos(NodoHuffman* nodo, const std::string& codigo
     }
 }
 
-std::string ArbolHuffman::codificar(const std::string& texto) {
+std::string ArbolHuffman::codificar(const std::string& texto) const {
+    MEDIR_FASE("huffman.codificacion");
+    BYTES_FASE(texto.length());
     std::string resultado;
+    if (codigosPorByte.empty()) return resultado;
+    size_t bits = 0;
+    for (char c : texto) bits += codigosPorByte[(unsigned char)c].length();
+    resultado.reserve(bits);
     for (char c : texto) {
-        resultado += codigos[c];
+        resultado += codigosPorByte[(unsigned char)c];
     }
     return resultado;
 }
 
-std::string ArbolHuffman::decodificar(const std::string& binario) {
+std::string ArbolHuffman::decodificar(const std::string& binario) const {
+    MEDIR_FASE("huffman.decodificacion");
+    BYTES_FASE(binario.length() / 8);
     std::string resultado;
+    if (!raiz) return resultado;
+    // Con un solo símbolo cada bit es un símbolo (código "0")
+    if (raiz->esHoja()) return std::string(binario.length(), raiz->simbolo);
     int pos = 0;
     
     while (pos < (int)binario.length()) {
@@ -13,6 +13,8 @@ class ArbolHuffman {
 private:
     NodoHuffman* raiz;
     std::map<char, std::string> codigos;
+    // Código de cada byte para codificar sin buscar en el mapa
+    std::vector<std::string> codigosPorByte;
     
     void construirCodigos(NodoHuffman* nodo, const std::string& codigo);
     void decodificarRecursivo(NodoHuffman* nodo, const std::string& binario, 
@@ -23,8 +25,8 @@ public:
     ~ArbolHuffman();
     
     void construir(const std::map<char, uint64_t>& frecuencias);
-    std::string codificar(const std::string& texto);
-    std::string decodificar(const std::string& binario);
+    std::string codificar(const std::string& texto) const;
+    std::string decodificar(const std::string& binario) const;
     std::map<char, std::string> obtenerCodigos() const;
     std::map<char, uint64_t> obtenerFrecuencias() const;
 };
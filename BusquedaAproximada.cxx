@@ -0,0 +1,236 @@
+// ============================================
+// ARCHIVO: BusquedaAproximada.cxx
+// ============================================
+#include "BusquedaAproximada.h"
+#include "PoolHilos.h"
+#include "Instrumentacion.h"
+#include "IUPAC.h"
+#include <algorithm>
+
+static const size_t POSICIONES_POR_TRAMO = 1 << 20;
+
+// Posiciones [desde, hasta) de una secuencia a cargo de una tarea
+struct TramoBusqueda {
+    int secuencia;
+    size_t desde, hasta;
+};
+
+struct ResultadoTramo {
+    uint64_t cuenta;
+    std::vector<Coincidencia> coincidencias;
+};
+
+// Peq[c * numBloques + b]: bits de las posiciones del bloque b del patrón
+// donde aparece el carácter c (o uno compatible, con iupac)
+static std::vector<uint64_t> construirPeq(const std::string& patron, int numBloques, bool iupac) {
+    std::vector<uint64_t> peq(256 * numBloques, 0);
+    for (size_t i = 0; i < patron.length(); i++) {
+        if (!iupac) {
+            unsigned char c = patron[i];
+            peq[c * numBloques + i / 64] |= 1ULL << (i % 64);
+            continue;
+        }
+        for (int c = 0; c < 256; c++) {
+            if (IUPAC::compatibles((char)c, patron[i])) {
+                peq[c * numBloques + i / 64] |= 1ULL << (i % 64);
+            }
+        }
+    }
+    return peq;
+}
+
+static bool distintas(char texto, char patron, bool iupac) {
+    return iupac ? !IUPAC::compatibles(texto, patron) : texto != patron;
+}
+
+static void buscarHamming(const char* texto, size_t n, const TramoBusqueda& tramo,
+                          const std::string& patron, int k, bool iupac, ResultadoTramo& r, bool guardar) {
+    size_t m = patron.length();
+    if (n < m) return;
+    size_t fin = std::min(tramo.hasta, n - m + 1);
+    for (size_t i = tramo.desde; i < fin; i++) {
+        int d = 0;
+        if (iupac) {
+            for (size_t p = 0; p < m && d <= k; p++) {
+                if (!IUPAC::compatibles(texto[i + p], patron[p])) d++;
+            }
+        } else {
+            for (size_t p = 0; p < m && d <= k; p++) {
+                if (texto[i + p] != patron[p]) d++;
+            }
+        }
+        if (d <= k) {
+            r.cuenta++;
+            if (guardar) r.coincidencias.push_back(Coincidencia(tramo.secuencia, i, d));
+        }
+    }
+}
+
+// Una alineación con a lo sumo k ediciones abarca como mucho m + k bases,
+// así que basta empezar m + k posiciones antes del tramo
+static size_t inicioCalentamiento(const TramoBusqueda& tramo, size_t m, int k) {
+    size_t margen = m + k;
+    return tramo.desde > margen ? tramo.desde - margen : 0;
+}
+
+static void buscarMyers(const char* texto, const TramoBusqueda& tramo, const std::vector<uint64_t>& peq,
+                        int m, int k, ResultadoTramo& r, bool guardar) {
+    const uint64_t alto = 1ULL << (m - 1);
+    uint64_t Pv = ~0ULL, Mv = 0;
+    int puntaje = m;
+    
+    for (size_t j = inicioCalentamiento(tramo, m, k); j < tramo.hasta; j++) {
+        uint64_t Eq = peq[(unsigned char)texto[j]];
+        uint64_t Xv = Eq | Mv;
+        uint64_t Xh = (((Eq & Pv) + Pv) ^ Pv) | Eq;
+        uint64_t Ph = Mv | ~(Xh | Pv);
+        uint64_t Mh = Pv & Xh;
+        if (Ph & alto) puntaje++;
+        else if (Mh & alto) puntaje--;
+        // Sin acarreo en la fila 0: el patrón puede empezar en cualquier parte
+        Ph <<= 1;
+        Mh <<= 1;
+        Pv = Mh | ~(Xv | Ph);
+        Mv = Ph & Xv;
+        
+        if (j >= tramo.desde && puntaje <= k) {
+            r.cuenta++;
+            if (guardar) r.coincidencias.push_back(Coincidencia(tramo.secuencia, j, puntaje));
+        }
+    }
+}
+
+// Variante por bloques de Hyyrö: cada bloque de 64 filas pasa al siguiente
+// su delta horizontal (-1, 0, +1) en la fila inferior
+static void buscarMyersBloques(const char* texto, const TramoBusqueda& tramo, const std::vector<uint64_t>& peq,
+                               int m, int k, ResultadoTramo& r, bool guardar) {
+    const int numBloques = (m + 63) / 64;
+    const uint64_t altoUltimo = 1ULL << ((m - 1) % 64);
+    std::vector<uint64_t> P(numBloques, ~0ULL), M(numBloques, 0);
+    int puntaje = m;
+    
+    for (size_t j = inicioCalentamiento(tramo, m, k); j < tramo.hasta; j++) {
+        const uint64_t* eqs = &peq[(unsigned char)texto[j] * numBloques];
+        int h = 0;
+        for (int b = 0; b < numBloques; b++) {
+            uint64_t Pv = P[b], Mv = M[b], Eq = eqs[b];
+            uint64_t alto = b == numBloques - 1 ? altoUltimo : 1ULL << 63;
+            uint64_t Xv = Eq | Mv;
+            if (h < 0) Eq |= 1;
+            uint64_t Xh = (((Eq & Pv) + Pv) ^ Pv) | Eq;
+            uint64_t Ph = Mv | ~(Xh | Pv);
+            uint64_t Mh = Pv & Xh;
+            int salida = (Ph & alto) ? 1 : (Mh & alto) ? -1 : 0;
+            Ph <<= 1;
+            Mh <<= 1;
+            if (h < 0) Mh |= 1;
+            else if (h > 0) Ph |= 1;
+            P[b] = Mh | ~(Xv | Ph);
+            M[b] = Ph & Xv;
+            h = salida;
+        }
+        puntaje += h;
+        
+        if (j >= tramo.desde && puntaje <= k) {
+            r.cuenta++;
+            if (guardar) r.coincidencias.push_back(Coincidencia(tramo.secuencia, j, puntaje));
+        }
+    }
+}
+
+uint64_t BusquedaAproximada::contar(const std::vector<Secuencia>& secuencias, const std::string& patron,
+                                    int k, TipoDistancia tipo, int numHilos,
+                                    std::vector<Coincidencia>* coincidencias, bool iupac) {
+    MEDIR_FASE("subsecuencias.aproximada");
+    if (coincidencias) coincidencias->clear();
+    if (patron.empty() || k < 0) return 0;
+    
+    int m = patron.length();
+    int numBloques = (m + 63) / 64;
+    std::vector<uint64_t> peq = construirPeq(patron, numBloques, iupac);
+    
+    std::vector<TramoBusqueda> tramos;
+    for (size_t s = 0; s < secuencias.size(); s++) {
+        size_t n = secuencias[s].obtenerNumBases();
+        BYTES_FASE(n);
+        for (size_t desde = 0; desde < n; desde += POSICIONES_POR_TRAMO) {
+            TramoBusqueda t;
+            t.secuencia = s;
+            t.desde = desde;
+            t.hasta = std::min(n, desde + POSICIONES_POR_TRAMO);
+            tramos.push_back(t);
+        }
+    }
+    
+    std::vector<ResultadoTramo> resultados(tramos.size());
+    PoolHilos pool(numHilos);
+    for (size_t t = 0; t < tramos.size(); t++) {
+        pool.encolar([&, t](int) {
+            const TramoBusqueda& tramo = tramos[t];
+            const Secuencia& sec = secuencias[tramo.secuencia];
+            ResultadoTramo& r = resultados[t];
+            r.cuenta = 0;
+            bool guardar = coincidencias != nullptr;
+            if (tipo == DISTANCIA_HAMMING) {
+                buscarHamming(sec.obtenerBases(), sec.obtenerNumBases(), tramo, patron, k, iupac, r, guardar);
+            } else if (numBloques == 1) {
+                buscarMyers(sec.obtenerBases(), tramo, peq, m, k, r, guardar);
+            } else {
+                buscarMyersBloques(sec.obtenerBases(), tramo, peq, m, k, r, guardar);
+            }
+        });
+    }
+    pool.esperarTodo();
+    
+    uint64_t total = 0;
+    for (const auto& r : resultados) {
+        total += r.cuenta;
+        if (coincidencias) {
+            coincidencias->insert(coincidencias->end(), r.coincidencias.begin(), r.coincidencias.end());
+        }
+    }
+    return total;
+}
+
+uint64_t BusquedaAproximada::contarIngenuo(const std::vector<Secuencia>& secuencias, const std::string& patron,
+                                           int k, TipoDistancia tipo,
+                                           std::vector<Coincidencia>* coincidencias, bool iupac) {
+    if (coincidencias) coincidencias->clear();
+    if (patron.empty() || k < 0) return 0;
+    size_t m = patron.length();
+    uint64_t total = 0;
+    
+    for (size_t s = 0; s < secuencias.size(); s++) {
+        std::string texto = secuencias[s].obtenerDatos();
+        if (tipo == DISTANCIA_HAMMING) {
+            for (size_t i = 0; i + m <= texto.length(); i++) {
+                int d = 0;
+                for (size_t p = 0; p < m; p++) {
+                    if (distintas(texto[i + p], patron[p], iupac)) d++;
+                }
+                if (d <= k) {
+                    total++;
+                    if (coincidencias) coincidencias->push_back(Coincidencia(s, i, d));
+                }
+            }
+            continue;
+        }
+        
+        // D[i]: menor costo de alinear patron[0..i) terminando en la base actual
+        std::vector<int> D(m + 1), anterior(m + 1);
+        for (size_t i = 0; i <= m; i++) anterior[i] = i;
+        for (size_t j = 0; j < texto.length(); j++) {
+            D[0] = 0;
+            for (size_t i = 1; i <= m; i++) {
+                int sustitucion = anterior[i - 1] + (distintas(texto[j], patron[i - 1], iupac) ? 1 : 0);
+                D[i] = std::min(sustitucion, std::min(anterior[i] + 1, D[i - 1] + 1));
+            }
+            if (D[m] <= k) {
+                total++;
+                if (coincidencias) coincidencias->push_back(Coincidencia(s, j, D[m]));
+            }
+            anterior.swap(D);
+        }
+    }
+    return total;
+}
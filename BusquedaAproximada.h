@@ -0,0 +1,42 @@
+// ============================================
+// ARCHIVO: BusquedaAproximada.h
+// ============================================
+#ifndef BUSQUEDAAPROXIMADA_H
+#define BUSQUEDAAPROXIMADA_H
+
+#include "Secuencia.h"
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+enum TipoDistancia { DISTANCIA_HAMMING, DISTANCIA_EDICION };
+
+struct Coincidencia {
+    int secuencia;      // índice en el vector de secuencias
+    size_t posicion;    // inicio (Hamming) o última base (edición)
+    int distancia;
+    bool reversa;       // coincide con el complemento reverso del patrón
+    Coincidencia(int s, size_t p, int d, bool r = false)
+        : secuencia(s), posicion(p), distancia(d), reversa(r) {}
+};
+
+// Búsqueda de un patrón con a lo sumo k diferencias. Con distancia de
+// Hamming hay una coincidencia por cada inicio; con distancia de edición,
+// una por cada posición donde puede terminar (como el algoritmo de Myers).
+// La edición usa los vectores de bits de Myers/Hyyrö: una palabra de 64
+// bits para patrones de hasta 64 bases y bloques encadenados para más.
+// Las secuencias se parten en tramos que se buscan en paralelo. Con iupac
+// cada base es un conjunto (IUPAC.h) y coincide si los conjuntos se cortan.
+class BusquedaAproximada {
+public:
+    static uint64_t contar(const std::vector<Secuencia>& secuencias, const std::string& patron,
+                           int k, TipoDistancia tipo, int numHilos,
+                           std::vector<Coincidencia>* coincidencias = nullptr, bool iupac = false);
+    // Referencia directa (comparación base a base y programación dinámica)
+    static uint64_t contarIngenuo(const std::vector<Secuencia>& secuencias, const std::string& patron,
+                                  int k, TipoDistancia tipo,
+                                  std::vector<Coincidencia>* coincidencias = nullptr, bool iupac = false);
+};
+
+#endif
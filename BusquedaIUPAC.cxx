@@ -0,0 +1,250 @@
+// ============================================
+// ARCHIVO: BusquedaIUPAC.cxx
+// ============================================
+#include "BusquedaIUPAC.h"
+#include "IUPAC.h"
+#include "PoolHilos.h"
+#include "Instrumentacion.h"
+#include <algorithm>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+static const size_t POSICIONES_POR_TRAMO = 1 << 20;
+static const int CARRILES = 16;
+
+struct TablaCodigos {
+    uint8_t codigo[256];
+    TablaCodigos() {
+        for (int c = 0; c < 256; c++) codigo[c] = IUPAC::codigo((char)c);
+    }
+};
+static const TablaCodigos TABLA;
+
+struct TramoIUPAC {
+    int secuencia;
+    size_t desde, hasta;    // inicios de ventana
+};
+
+// Bit por hebra en cada candidato
+static const uint8_t HEBRA_DIRECTA = 1;
+static const uint8_t HEBRA_REVERSA = 2;
+
+struct Candidato {
+    size_t posicion;
+    uint8_t hebras;
+};
+
+static std::vector<TramoIUPAC> partirEnTramos(const std::vector<Secuencia>& secuencias, size_t m,
+                                              size_t& totalBases) {
+    std::vector<TramoIUPAC> tramos;
+    totalBases = 0;
+    for (size_t s = 0; s < secuencias.size(); s++) {
+        size_t n = secuencias[s].obtenerNumBases();
+        totalBases += n;
+        if (n < m) continue;
+        size_t inicios = n - m + 1;
+        for (size_t desde = 0; desde < inicios; desde += POSICIONES_POR_TRAMO) {
+            TramoIUPAC t;
+            t.secuencia = s;
+            t.desde = desde;
+            t.hasta = std::min(inicios, desde + POSICIONES_POR_TRAMO);
+            tramos.push_back(t);
+        }
+    }
+    return tramos;
+}
+
+// Recorre las ventanas del tramo y llama a alEncontrar(posicion, hebras)
+// con las que coinciden en alguna hebra. 'codigos' es el buffer del hilo.
+template <typename F>
+static void escanear(const char* texto, const TramoIUPAC& tramo, const std::vector<uint8_t>& directa,
+                     const std::vector<uint8_t>& reversa, std::vector<uint8_t>& codigos, F alEncontrar) {
+    size_t m = directa.size();
+    size_t cuantos = tramo.hasta - tramo.desde;
+    size_t largo = cuantos + m - 1;
+    // Relleno con conjuntos vacíos: las lecturas del último grupo no coinciden
+    codigos.assign(largo + CARRILES, 0);
+    const char* origen = texto + tramo.desde;
+    for (size_t i = 0; i < largo; i++) codigos[i] = TABLA.codigo[(unsigned char)origen[i]];
+    const uint8_t* cod = codigos.data();
+    
+    for (size_t i = 0; i < cuantos; i += CARRILES) {
+        uint32_t bitsD, bitsR;
+#ifdef __SSE2__
+        const __m128i cero = _mm_setzero_si128();
+        __m128i okD = _mm_cmpeq_epi8(cero, cero);
+        __m128i okR = okD;
+        for (size_t p = 0; p < m; p++) {
+            __m128i v = _mm_loadu_si128((const __m128i*)(cod + i + p));
+            __m128i vacioD = _mm_cmpeq_epi8(_mm_and_si128(v, _mm_set1_epi8(directa[p])), cero);
+            __m128i vacioR = _mm_cmpeq_epi8(_mm_and_si128(v, _mm_set1_epi8(reversa[p])), cero);
+            okD = _mm_andnot_si128(vacioD, okD);
+            okR = _mm_andnot_si128(vacioR, okR);
+            if (_mm_movemask_epi8(_mm_or_si128(okD, okR)) == 0) break;
+        }
+        bitsD = _mm_movemask_epi8(okD);
+        bitsR = _mm_movemask_epi8(okR);
+#else
+        bitsD = bitsR = 0;
+        for (int c = 0; c < CARRILES; c++) {
+            bool d = true, r = true;
+            for (size_t p = 0; p < m && (d || r); p++) {
+                d = d && (cod[i + c + p] & directa[p]);
+                r = r && (cod[i + c + p] & reversa[p]);
+            }
+            bitsD |= (uint32_t)d << c;
+            bitsR |= (uint32_t)r << c;
+        }
+#endif
+        if (cuantos - i < (size_t)CARRILES) {
+            uint32_t validos = (1u << (cuantos - i)) - 1;
+            bitsD &= validos;
+            bitsR &= validos;
+        }
+        uint32_t alguno = bitsD | bitsR;
+        while (alguno) {
+            int c = __builtin_ctz(alguno);
+            alguno &= alguno - 1;
+            uint8_t hebras = (((bitsD >> c) & 1) ? HEBRA_DIRECTA : 0) | (((bitsR >> c) & 1) ? HEBRA_REVERSA : 0);
+            alEncontrar(tramo.desde + i + c, hebras);
+        }
+    }
+}
+
+static void mascaras(const std::string& patron, std::vector<uint8_t>& directa, std::vector<uint8_t>& reversa) {
+    std::string complemento = IUPAC::complementoReverso(patron);
+    directa.resize(patron.length());
+    reversa.resize(patron.length());
+    for (size_t p = 0; p < patron.length(); p++) {
+        directa[p] = IUPAC::codigo(patron[p]);
+        reversa[p] = IUPAC::codigo(complemento[p]);
+    }
+}
+
+static std::vector<std::vector<Candidato>> buscarCandidatos(const std::vector<Secuencia>& secuencias,
+                                                            const std::vector<TramoIUPAC>& tramos,
+                                                            const std::string& patron, int numHilos) {
+    std::vector<uint8_t> directa, reversa;
+    mascaras(patron, directa, reversa);
+    
+    std::vector<std::vector<Candidato>> resultados(tramos.size());
+    PoolHilos pool(numHilos);
+    std::vector<std::vector<uint8_t>> buffers(pool.obtenerNumHilos());
+    for (size_t t = 0; t < tramos.size(); t++) {
+        pool.encolar([&, t](int hilo) {
+            const TramoIUPAC& tramo = tramos[t];
+            std::vector<Candidato>& r = resultados[t];
+            escanear(secuencias[tramo.secuencia].obtenerBases(), tramo, directa, reversa, buffers[hilo],
+                     [&r](size_t posicion, uint8_t hebras) {
+                         Candidato c;
+                         c.posicion = posicion;
+                         c.hebras = hebras;
+                         r.push_back(c);
+                     });
+        });
+    }
+    pool.esperarTodo();
+    return resultados;
+}
+
+ConteoHebras BusquedaIUPAC::contar(const std::vector<Secuencia>& secuencias, const std::string& patron,
+                                   int k, TipoDistancia tipo, int numHilos,
+                                   std::vector<Coincidencia>* coincidencias) {
+    ConteoHebras conteo;
+    if (coincidencias) coincidencias->clear();
+    if (patron.empty() || k < 0) return conteo;
+    
+    if (k > 0) {
+        std::vector<Coincidencia> reversas;
+        conteo.directa = BusquedaAproximada::contar(secuencias, patron, k, tipo, numHilos, coincidencias, true);
+        conteo.reversa = BusquedaAproximada::contar(secuencias, IUPAC::complementoReverso(patron), k, tipo,
+                                                    numHilos, coincidencias ? &reversas : nullptr, true);
+        if (coincidencias) {
+            for (Coincidencia& c : reversas) c.reversa = true;
+            coincidencias->insert(coincidencias->end(), reversas.begin(), reversas.end());
+        }
+        return conteo;
+    }
+    
+    MEDIR_FASE("subsecuencias.iupac");
+    size_t totalBases;
+    std::vector<TramoIUPAC> tramos = partirEnTramos(secuencias, patron.length(), totalBases);
+    BYTES_FASE(totalBases);
+    std::vector<std::vector<Candidato>> candidatos = buscarCandidatos(secuencias, tramos, patron, numHilos);
+    for (size_t t = 0; t < tramos.size(); t++) {
+        for (const Candidato& c : candidatos[t]) {
+            if (c.hebras & HEBRA_DIRECTA) {
+                conteo.directa++;
+                if (coincidencias) coincidencias->push_back(Coincidencia(tramos[t].secuencia, c.posicion, 0));
+            }
+            if (c.hebras & HEBRA_REVERSA) {
+                conteo.reversa++;
+                if (coincidencias) coincidencias->push_back(Coincidencia(tramos[t].secuencia, c.posicion, 0, true));
+            }
+        }
+    }
+    return conteo;
+}
+
+ConteoHebras BusquedaIUPAC::enmascarar(std::vector<Secuencia>& secuencias, const std::string& patron,
+                                       int numHilos) {
+    MEDIR_FASE("subsecuencias.enmascarado");
+    ConteoHebras conteo;
+    if (patron.empty()) return conteo;
+    
+    size_t m = patron.length();
+    size_t totalBases;
+    std::vector<TramoIUPAC> tramos = partirEnTramos(secuencias, m, totalBases);
+    BYTES_FASE(totalBases);
+    std::vector<std::vector<Candidato>> candidatos = buscarCandidatos(secuencias, tramos, patron, numHilos);
+    
+    // Los tramos de cada secuencia están seguidos y en orden: una ventana
+    // solo se enmascara si no pisa la anterior enmascarada
+    size_t t = 0;
+    while (t < tramos.size()) {
+        int s = tramos[t].secuencia;
+        std::vector<std::pair<size_t, size_t>> rangos;
+        size_t libreDesde = 0;
+        for (; t < tramos.size() && tramos[t].secuencia == s; t++) {
+            for (const Candidato& c : candidatos[t]) {
+                if (c.posicion < libreDesde) continue;
+                rangos.push_back(std::make_pair(c.posicion, m));
+                libreDesde = c.posicion + m;
+                if (c.hebras & HEBRA_DIRECTA) conteo.directa++;
+                else conteo.reversa++;
+            }
+        }
+        if (!rangos.empty()) secuencias[s].rellenar(rangos, 'X');
+    }
+    return conteo;
+}
+
+ConteoHebras BusquedaIUPAC::contarIngenuo(const std::vector<Secuencia>& secuencias, const std::string& patron,
+                                          std::vector<Coincidencia>* coincidencias) {
+    ConteoHebras conteo;
+    if (coincidencias) coincidencias->clear();
+    if (patron.empty()) return conteo;
+    std::string complemento = IUPAC::complementoReverso(patron);
+    size_t m = patron.length();
+    
+    for (size_t s = 0; s < secuencias.size(); s++) {
+        std::string texto = secuencias[s].obtenerDatos();
+        for (size_t i = 0; i + m <= texto.length(); i++) {
+            bool directa = true, reversa = true;
+            for (size_t p = 0; p < m; p++) {
+                directa = directa && IUPAC::compatibles(texto[i + p], patron[p]);
+                reversa = reversa && IUPAC::compatibles(texto[i + p], complemento[p]);
+            }
+            if (directa) {
+                conteo.directa++;
+                if (coincidencias) coincidencias->push_back(Coincidencia(s, i, 0));
+            }
+            if (reversa) {
+                conteo.reversa++;
+                if (coincidencias) coincidencias->push_back(Coincidencia(s, i, 0, true));
+            }
+        }
+    }
+    return conteo;
+}
@@ -0,0 +1,41 @@
+// ============================================
+// ARCHIVO: BusquedaIUPAC.h
+// ============================================
+#ifndef BUSQUEDAIUPAC_H
+#define BUSQUEDAIUPAC_H
+
+#include "Secuencia.h"
+#include "BusquedaAproximada.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+struct ConteoHebras {
+    uint64_t directa;   // coincidencias con el patrón
+    uint64_t reversa;   // coincidencias con su complemento reverso
+    ConteoHebras() : directa(0), reversa(0) {}
+    uint64_t total() const { return directa + reversa; }
+};
+
+// Búsqueda IUPAC en ambas hebras: cada base es un conjunto de 4 bits y una
+// ventana coincide si cada base se corta con la del patrón. El texto se
+// traduce a conjuntos por tramos y se compara de 16 en 16 posiciones (SSE2)
+// contra el patrón y su complemento reverso en la misma pasada. Un patrón
+// palíndromo cuenta en las dos hebras.
+class BusquedaIUPAC {
+public:
+    // Con k > 0 delega en BusquedaAproximada, una búsqueda por hebra
+    static ConteoHebras contar(const std::vector<Secuencia>& secuencias, const std::string& patron,
+                               int k, TipoDistancia tipo, int numHilos,
+                               std::vector<Coincidencia>* coincidencias = nullptr);
+    // Enmascara con X de izquierda a derecha sin solapes, como
+    // Utilidades::enmascararSubsecuencias; una ventana que coincide en las
+    // dos hebras cuenta como directa
+    static ConteoHebras enmascarar(std::vector<Secuencia>& secuencias, const std::string& patron,
+                                   int numHilos);
+    // Referencia directa base a base (k = 0)
+    static ConteoHebras contarIngenuo(const std::vector<Secuencia>& secuencias, const std::string& patron,
+                                      std::vector<Coincidencia>* coincidencias = nullptr);
+};
+
+#endif
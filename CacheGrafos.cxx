@@ -0,0 +1,103 @@
+// ============================================
+// ARCHIVO: CacheGrafos.cxx
+// ============================================
+#include "CacheGrafos.h"
+
+CacheGrafos::CacheGrafos()
+    : presupuesto(PRESUPUESTO_POR_DEFECTO), bytesTotales(0),
+      aciertos(0), fallos(0), desalojos(0) {}
+
+void CacheGrafos::tocar(Entrada& entrada) {
+    ordenLRU.splice(ordenLRU.begin(), ordenLRU, entrada.posicionLRU);
+}
+
+Grafo* CacheGrafos::buscar(const std::string& descripcion) {
+    auto it = entradas.find(descripcion);
+    if (it == entradas.end()) {
+        fallos++;
+        return nullptr;
+    }
+    aciertos++;
+    tocar(it->second);
+    return &it->second.grafo;
+}
+
+Grafo* CacheGrafos::obtener(const std::string& descripcion) {
+    auto it = entradas.find(descripcion);
+    return it == entradas.end() ? nullptr : &it->second.grafo;
+}
+
+Grafo& CacheGrafos::reservar(const std::string& descripcion) {
+    auto it = entradas.find(descripcion);
+    if (it != entradas.end()) {
+        tocar(it->second);
+        return it->second.grafo;
+    }
+    
+    Entrada& entrada = entradas[descripcion];
+    ordenLRU.push_front(descripcion);
+    entrada.posicionLRU = ordenLRU.begin();
+    entrada.bytes = 0;
+    return entrada.grafo;
+}
+
+void CacheGrafos::registrar(const std::string& descripcion) {
+    auto it = entradas.find(descripcion);
+    if (it == entradas.end()) return;
+    
+    bytesTotales -= it->second.bytes;
+    it->second.bytes = it->second.grafo.memoriaUsada();
+    bytesTotales += it->second.bytes;
+    desalojar(descripcion);
+}
+
+void CacheGrafos::desalojar(const std::string& conservar) {
+    auto it = ordenLRU.end();
+    while (bytesTotales > presupuesto && it != ordenLRU.begin()) {
+        --it;
+        if (*it == conservar) continue;
+        
+        auto entrada = entradas.find(*it);
+        bytesTotales -= entrada->second.bytes;
+        entradas.erase(entrada);
+        it = ordenLRU.erase(it);
+        desalojos++;
+    }
+}
+
+void CacheGrafos::eliminar(const std::string& descripcion) {
+    auto it = entradas.find(descripcion);
+    if (it == entradas.end()) return;
+    bytesTotales -= it->second.bytes;
+    ordenLRU.erase(it->second.posicionLRU);
+    entradas.erase(it);
+}
+
+void CacheGrafos::limpiar() {
+    entradas.clear();
+    ordenLRU.clear();
+    bytesTotales = 0;
+}
+
+void CacheGrafos::fijarPresupuesto(size_t bytes) {
+    presupuesto = bytes;
+    desalojar("");
+}
+
+size_t CacheGrafos::obtenerPresupuesto() const { return presupuesto; }
+size_t CacheGrafos::obtenerBytesTotales() const { return bytesTotales; }
+
+size_t CacheGrafos::obtenerBytes(const std::string& descripcion) const {
+    auto it = entradas.find(descripcion);
+    return it == entradas.end() ? 0 : it->second.bytes;
+}
+
+// En orden LRU, del más reciente al más antiguo
+std::vector<std::string> CacheGrafos::descripciones() const {
+    return std::vector<std::string>(ordenLRU.begin(), ordenLRU.end());
+}
+
+int CacheGrafos::obtenerNumGrafos() const { return entradas.size(); }
+long CacheGrafos::obtenerAciertos() const { return aciertos; }
+long CacheGrafos::obtenerFallos() const { return fallos; }
+long CacheGrafos::obtenerDesalojos() const { return desalojos; }
@@ -0,0 +1,62 @@
+// ============================================
+// ARCHIVO: CacheGrafos.h
+// ============================================
+#ifndef CACHEGRAFOS_H
+#define CACHEGRAFOS_H
+
+#include "Grafo.h"
+#include <map>
+#include <list>
+#include <string>
+#include <vector>
+#include <cstddef>
+
+// Caché de grafos construidos, indexada por descripción, con presupuesto
+// de memoria en bytes y desalojo del menos usado recientemente (LRU).
+// Las referencias devueltas siguen siendo válidas hasta que la entrada se
+// elimina o se desaloja; registrar() nunca desaloja la entrada registrada.
+class CacheGrafos {
+private:
+    struct Entrada {
+        Grafo grafo;
+        size_t bytes;
+        std::list<std::string>::iterator posicionLRU;
+    };
+    
+    std::map<std::string, Entrada> entradas;
+    std::list<std::string> ordenLRU;   // frente = usado más recientemente
+    size_t presupuesto;
+    size_t bytesTotales;
+    long aciertos, fallos, desalojos;
+    
+    void tocar(Entrada& entrada);
+    void desalojar(const std::string& conservar);
+
+public:
+    static const size_t PRESUPUESTO_POR_DEFECTO = 1024UL * 1024 * 1024;
+    
+    CacheGrafos();
+    
+    // Busca un grafo y lo marca como reciente; cuenta acierto o fallo
+    Grafo* buscar(const std::string& descripcion);
+    // Acceso sin contar ni alterar el orden LRU
+    Grafo* obtener(const std::string& descripcion);
+    // Crea una entrada vacía para construir el grafo fuera de la caché
+    Grafo& reservar(const std::string& descripcion);
+    // Recalcula los bytes de la entrada y desaloja otras si se excede el presupuesto
+    void registrar(const std::string& descripcion);
+    void eliminar(const std::string& descripcion);
+    void limpiar();
+    
+    void fijarPresupuesto(size_t bytes);
+    size_t obtenerPresupuesto() const;
+    size_t obtenerBytesTotales() const;
+    size_t obtenerBytes(const std::string& descripcion) const;
+    std::vector<std::string> descripciones() const;
+    int obtenerNumGrafos() const;
+    long obtenerAciertos() const;
+    long obtenerFallos() const;
+    long obtenerDesalojos() const;
+};
+
+#endif
@@ -0,0 +1,75 @@
+// ============================================
+// ARCHIVO: Catalogo.cxx
+// ============================================
+#include "Catalogo.h"
+#include <algorithm>
+#include <set>
+
+int Catalogo::indexar(const std::vector<Secuencia>& secuencias, size_t desde) {
+    int nuevas = 0;
+    for (size_t i = desde; i < secuencias.size(); i++) {
+        const std::string& descripcion = secuencias[i].obtenerDescripcion();
+        if (!indice.insert(std::make_pair(descripcion, i)).second) {
+            if (std::find(repetidas.begin(), repetidas.end(), descripcion) == repetidas.end()) {
+                repetidas.push_back(descripcion);
+            }
+            nuevas++;
+        }
+        indice.insert(std::make_pair(nombreCalificado(origenes[i], descripcion), i));
+    }
+    return nuevas;
+}
+
+int Catalogo::reemplazar(const std::vector<Secuencia>& secuencias, const std::string& archivo) {
+    origenes.assign(secuencias.size(), archivo);
+    indice.clear();
+    repetidas.clear();
+    indice.reserve(2 * secuencias.size());
+    return indexar(secuencias, 0);
+}
+
+int Catalogo::anadir(const std::vector<Secuencia>& secuencias, size_t desde, const std::string& archivo) {
+    origenes.resize(secuencias.size(), archivo);
+    return indexar(secuencias, desde);
+}
+
+std::vector<std::string> Catalogo::descargar(std::vector<Secuencia>& secuencias, const std::string& archivo) {
+    std::vector<std::string> nombres;
+    // Antes de mover nada: sin secuencias de 'archivo' todo queda igual
+    if (!contieneArchivo(archivo)) return nombres;
+    std::vector<Secuencia> quedan;
+    std::vector<std::string> origenesQuedan;
+    for (size_t i = 0; i < secuencias.size(); i++) {
+        if (origenes[i] == archivo) {
+            nombres.push_back(nombre(secuencias, i));
+        } else {
+            quedan.push_back(std::move(secuencias[i]));
+            origenesQuedan.push_back(origenes[i]);
+        }
+    }
+    secuencias.swap(quedan);
+    origenes.swap(origenesQuedan);
+    indice.clear();
+    repetidas.clear();
+    indexar(secuencias, 0);
+    return nombres;
+}
+
+long Catalogo::buscar(const std::string& nombre) const {
+    auto it = indice.find(nombre);
+    return it == indice.end() ? -1 : (long)it->second;
+}
+
+std::string Catalogo::nombre(const std::vector<Secuencia>& secuencias, size_t i) const {
+    const std::string& descripcion = secuencias[i].obtenerDescripcion();
+    if (buscar(descripcion) == (long)i) return descripcion;
+    return nombreCalificado(origenes[i], descripcion);
+}
+
+bool Catalogo::contieneArchivo(const std::string& archivo) const {
+    return std::find(origenes.begin(), origenes.end(), archivo) != origenes.end();
+}
+
+size_t Catalogo::numArchivos() const {
+    return std::set<std::string>(origenes.begin(), origenes.end()).size();
+}
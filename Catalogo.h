@@ -0,0 +1,48 @@
+// ============================================
+// ARCHIVO: Catalogo.h
+// ============================================
+#ifndef CATALOGO_H
+#define CATALOGO_H
+
+#include "Secuencia.h"
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Índice de las secuencias cargadas por descripción y por
+// "archivo:descripción", con el archivo del que viene cada una. Con
+// descripciones repetidas la descripción sola nombra a la primera cargada.
+class Catalogo {
+private:
+    std::vector<std::string> origenes;                  // archivo de cada secuencia
+    std::unordered_map<std::string, size_t> indice;     // nombre -> posición
+    std::vector<std::string> repetidas;
+    
+    // Indexa las secuencias desde 'desde' y devuelve cuántas repiten nombre
+    int indexar(const std::vector<Secuencia>& secuencias, size_t desde);
+
+public:
+    // Todas las secuencias vienen de 'archivo'
+    int reemplazar(const std::vector<Secuencia>& secuencias, const std::string& archivo);
+    // Las secuencias desde 'desde' se agregaron al final leídas de 'archivo'
+    int anadir(const std::vector<Secuencia>& secuencias, size_t desde, const std::string& archivo);
+    // Quita las secuencias de 'archivo' y devuelve sus nombres en el catálogo
+    std::vector<std::string> descargar(std::vector<Secuencia>& secuencias, const std::string& archivo);
+    
+    // Posición de la secuencia con ese nombre, o -1
+    long buscar(const std::string& nombre) const;
+    // Nombre que la identifica: la descripción, o archivo:descripción si
+    // la descripción sola nombra a otra
+    std::string nombre(const std::vector<Secuencia>& secuencias, size_t i) const;
+    const std::string& origen(size_t i) const { return origenes[i]; }
+    bool contieneArchivo(const std::string& archivo) const;
+    size_t numArchivos() const;
+    // Descripciones repetidas entre las cargadas
+    const std::vector<std::string>& obtenerRepetidas() const { return repetidas; }
+    
+    static std::string nombreCalificado(const std::string& archivo, const std::string& descripcion) {
+        return archivo + ":" + descripcion;
+    }
+};
+
+#endif
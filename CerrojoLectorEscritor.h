@@ -0,0 +1,65 @@
+// ============================================
+// ARCHIVO: CerrojoLectorEscritor.h
+// ============================================
+#ifndef CERROJOLECTORESCRITOR_H
+#define CERROJOLECTORESCRITOR_H
+
+#include <mutex>
+#include <condition_variable>
+
+// Cerrojo lector-escritor con preferencia de escritura (C++11 no trae
+// shared_mutex): un escritor en espera bloquea a los lectores nuevos.
+class CerrojoLectorEscritor {
+private:
+    std::mutex mtx;
+    std::condition_variable cv;
+    int lectores;
+    int escritoresEsperando;
+    bool escribiendo;
+
+public:
+    CerrojoLectorEscritor() : lectores(0), escritoresEsperando(0), escribiendo(false) {}
+    
+    void bloquearLectura() {
+        std::unique_lock<std::mutex> lock(mtx);
+        cv.wait(lock, [&] { return !escribiendo && escritoresEsperando == 0; });
+        lectores++;
+    }
+    
+    void liberarLectura() {
+        std::lock_guard<std::mutex> lock(mtx);
+        if (--lectores == 0) cv.notify_all();
+    }
+    
+    void bloquearEscritura() {
+        std::unique_lock<std::mutex> lock(mtx);
+        escritoresEsperando++;
+        cv.wait(lock, [&] { return !escribiendo && lectores == 0; });
+        escritoresEsperando--;
+        escribiendo = true;
+    }
+    
+    void liberarEscritura() {
+        std::lock_guard<std::mutex> lock(mtx);
+        escribiendo = false;
+        cv.notify_all();
+    }
+};
+
+class LecturaCompartida {
+private:
+    CerrojoLectorEscritor& cerrojo;
+public:
+    explicit LecturaCompartida(CerrojoLectorEscritor& c) : cerrojo(c) { cerrojo.bloquearLectura(); }
+    ~LecturaCompartida() { cerrojo.liberarLectura(); }
+};
+
+class EscrituraExclusiva {
+private:
+    CerrojoLectorEscritor& cerrojo;
+public:
+    explicit EscrituraExclusiva(CerrojoLectorEscritor& c) : cerrojo(c) { cerrojo.bloquearEscritura(); }
+    ~EscrituraExclusiva() { cerrojo.liberarEscritura(); }
+};
+
+#endif
@@ -0,0 +1,35 @@
+// ============================================
+// ARCHIVO: CodigosKmers.h
+// ============================================
+#ifndef CODIGOSKMERS_H
+#define CODIGOSKMERS_H
+
+#include "Alfabeto.h"
+#include <cstdint>
+
+// Codificación de k-mers común a ContadorKmers y Similitud, que deben dar
+// las mismas claves y los mismos hashes: 2 bits por base con el rango de
+// AlfabetoADN (A=0, C=1, G=2, T=3) sin distinguir mayúsculas; -1 para
+// cualquier otro byte, que corta la ventana.
+constexpr int codigoKmer(int c) {
+    return AlfabetoADN::rango(c >= 'a' && c <= 'z' ? c - ('a' - 'A') : c);
+}
+
+template <typename I = typename GenerarIndices<256>::tipo> struct CodigosKmers;
+
+template <int... I> struct CodigosKmers<Indices<I...>> {
+    static constexpr signed char CODIGO[256] = { (signed char)codigoKmer(I)... };
+};
+template <int... I> constexpr signed char CodigosKmers<Indices<I...>>::CODIGO[256];
+
+// Finalizador de MurmurHash3
+inline uint64_t mezclar(uint64_t x) {
+    x ^= x >> 33;
+    x *= 0xff51afd7ed558ccdULL;
+    x ^= x >> 33;
+    x *= 0xc4ceb9fe1a85ec53ULL;
+    x ^= x >> 33;
+    return x;
+}
+
+#endif
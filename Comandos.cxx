@@ -0,0 +1,54 @@
+// ============================================
+// ARCHIVO: Comandos.cxx
+// ============================================
+#include "Comandos.h"
+#include <map>
+
+// Cada comando de procesarComando debe figurar aquí; make check lo comprueba
+static const std::map<std::string, TipoComando>& tabla() {
+    static const std::map<std::string, TipoComando> clases = {
+        {"ayuda", CMD_LECTURA},
+        {"listar_secuencias", CMD_LECTURA},
+        {"histograma", CMD_LECTURA},
+        {"es_subsecuencia", CMD_LECTURA},
+        {"kmers", CMD_LECTURA},
+        {"similitud", CMD_LECTURA},
+        {"alinear", CMD_LECTURA},
+        
+        {"guardar", CMD_ARCHIVOS},
+        {"codificar", CMD_ARCHIVOS},
+        {"codificar_lote", CMD_ARCHIVOS},
+        {"entrenar_modelo", CMD_ARCHIVOS},
+        {"verificar", CMD_ARCHIVOS},
+        {"composicion", CMD_ARCHIVOS},
+        
+        {"ruta_mas_corta", CMD_GRAFOS},
+        {"base_remota", CMD_GRAFOS},
+        {"rutas_lote", CMD_GRAFOS},
+        {"mapa_remoto", CMD_GRAFOS},
+        {"estado_grafos", CMD_GRAFOS},
+        {"guardar_sesion", CMD_GRAFOS},
+        {"ruta_mas_corta_disco", CMD_GRAFOS},
+        
+        {"cargar", CMD_ESCRITURA},
+        {"descargar", CMD_ESCRITURA},
+        {"enmascarar", CMD_ESCRITURA},
+        {"decodificar", CMD_ESCRITURA},
+        {"presupuesto_grafos", CMD_ESCRITURA},
+        {"estadisticas", CMD_ESCRITURA},
+        {"abrir_sesion", CMD_ESCRITURA},
+        {"deshacer", CMD_ESCRITURA},
+        {"versiones", CMD_ESCRITURA},
+        {"salir", CMD_ESCRITURA},
+    };
+    return clases;
+}
+
+TipoComando Comandos::clasificar(const std::string& comando) {
+    auto it = tabla().find(comando);
+    return it == tabla().end() ? CMD_ESCRITURA : it->second;
+}
+
+bool Comandos::clasificado(const std::string& comando) {
+    return tabla().count(comando) > 0;
+}
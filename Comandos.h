@@ -0,0 +1,25 @@
+// ============================================
+// ARCHIVO: Comandos.h
+// ============================================
+#ifndef COMANDOS_H
+#define COMANDOS_H
+
+#include <string>
+
+// Qué toca cada comando, para el modo lote y el servidor. CMD_ESCRITURA
+// modifica las secuencias o el estado global y separa el script en tramos.
+// Dentro de un tramo los comandos CMD_LECTURA corren en paralelo entre sí.
+// Los CMD_GRAFOS comparten la caché de grafos y los CMD_ARCHIVOS leen o
+// escriben archivos que otro comando del tramo puede estar usando, así que
+// ambos corren en orden en un mismo hilo, en paralelo con las lecturas.
+enum TipoComando { CMD_LECTURA, CMD_ARCHIVOS, CMD_GRAFOS, CMD_ESCRITURA };
+
+class Comandos {
+public:
+    // Los comandos desconocidos se tratan como escritura
+    static TipoComando clasificar(const std::string& comando);
+    // true si el comando figura en la tabla de clases
+    static bool clasificado(const std::string& comando);
+};
+
+#endif
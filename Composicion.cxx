@@ -0,0 +1,152 @@
+// ============================================
+// ARCHIVO: Composicion.cxx
+// ============================================
+#include "Composicion.h"
+#include "Instrumentacion.h"
+#include <algorithm>
+#include <cstring>
+#include <set>
+
+static const int BASES_POR_PALABRA = 32;
+static const uint64_t BITS_BAJOS = 0x5555555555555555ULL;
+
+// Bases con código 'patron' (repetido en cada par de bits) entre las
+// marcadas por 'mascara' en una palabra empaquetada
+static inline int contarCodigo(uint64_t palabra, uint64_t patron, uint64_t mascara) {
+    uint64_t x = palabra ^ patron;
+    return __builtin_popcountll(~(x | (x >> 1)) & mascara);
+}
+
+IndiceComposicion::IndiceComposicion(const Secuencia& sec)
+    : identidad(sec.obtenerIdentidad()), version(sec.obtenerVersion()), numBases(sec.obtenerNumBases()),
+      alfabeto(sec.obtenerAlfabeto()), tamano(0) {
+    MEDIR_FASE("composicion.indice");
+    BYTES_FASE(numBases);
+    switch (alfabeto) {
+        case ALFABETO_ADN: construir<AlfabetoADN>(sec.obtenerBases()); break;
+        case ALFABETO_IUPAC: construir<AlfabetoIUPAC>(sec.obtenerBases()); break;
+        case ALFABETO_PROTEINA: construir<AlfabetoProteina>(sec.obtenerBases()); break;
+        default: construir<AlfabetoBytes>(sec.obtenerBases()); break;
+    }
+}
+
+template <typename A>
+void IndiceComposicion::construir(const char* bases) {
+    const int16_t* rango = TablasAlfabeto<A>::RANGO;
+    tamano = A::TAMANO;
+    for (int r = 0; r < A::TAMANO; r++) simbolos.push_back(A::simbolo(r));
+    
+    size_t numBloques = numBases / BLOQUE;
+    acumulados.assign((numBloques + 1) * tamano, 0);
+    if (A::TIPO == ALFABETO_ADN) {
+        empaquetadas.assign((numBases + BASES_POR_PALABRA - 1) / BASES_POR_PALABRA, 0);
+    } else {
+        rangos.resize(numBases);
+    }
+    
+    std::vector<uint32_t> cuentas(tamano, 0);
+    for (size_t i = 0; i < numBases; i++) {
+        if (i % BLOQUE == 0 && i > 0) {
+            std::copy(cuentas.begin(), cuentas.end(), acumulados.begin() + (i / BLOQUE) * tamano);
+        }
+        int r = rango[(unsigned char)bases[i]];
+        cuentas[r]++;
+        if (A::TIPO == ALFABETO_ADN) {
+            empaquetadas[i / BASES_POR_PALABRA] |= (uint64_t)r << (2 * (i % BASES_POR_PALABRA));
+        } else {
+            rangos[i] = r;
+        }
+    }
+    if (numBases % BLOQUE == 0 && numBloques > 0) {
+        std::copy(cuentas.begin(), cuentas.end(), acumulados.begin() + numBloques * tamano);
+    }
+}
+
+size_t IndiceComposicion::memoria() const {
+    return acumulados.size() * sizeof(uint32_t) + empaquetadas.size() * sizeof(uint64_t) + rangos.size();
+}
+
+// Cuentas por rango de las bases [0, pos)
+void IndiceComposicion::prefijo(size_t pos, uint64_t* cuentas) const {
+    size_t bloque = pos / BLOQUE;
+    const uint32_t* base = &acumulados[bloque * tamano];
+    for (int r = 0; r < tamano; r++) cuentas[r] = base[r];
+    size_t desde = bloque * BLOQUE;
+    
+    if (!empaquetadas.empty()) {
+        size_t palabra = desde / BASES_POR_PALABRA, ultima = pos / BASES_POR_PALABRA;
+        int resto = pos % BASES_POR_PALABRA;
+        uint64_t enBloque = pos - desde;
+        uint64_t otras = 0;
+        for (int c = 1; c < 4; c++) {
+            uint64_t patron = BITS_BAJOS * c;
+            uint64_t n = 0;
+            for (size_t p = palabra; p < ultima; p++) n += contarCodigo(empaquetadas[p], patron, BITS_BAJOS);
+            if (resto > 0) {
+                n += contarCodigo(empaquetadas[ultima], patron, BITS_BAJOS & ((1ULL << (2 * resto)) - 1));
+            }
+            cuentas[c] += n;
+            otras += n;
+        }
+        // Los bits de relleno valen 0, así que A se deduce del resto
+        cuentas[0] += enBloque - otras;
+    } else {
+        for (size_t i = desde; i < pos; i++) cuentas[rangos[i]]++;
+    }
+}
+
+void IndiceComposicion::contar(size_t inicio, size_t fin, uint64_t* cuentas) const {
+    memset(cuentas, 0, 256 * sizeof(uint64_t));
+    fin = std::min(fin, numBases);
+    if (inicio >= fin) return;
+    uint64_t hasta[256], antes[256];
+    prefijo(fin, hasta);
+    prefijo(inicio, antes);
+    for (int r = 0; r < tamano; r++) cuentas[(unsigned char)simbolos[r]] = hasta[r] - antes[r];
+}
+
+std::shared_ptr<const IndiceComposicion> Composicion::obtener(const Secuencia& sec) {
+    std::lock_guard<std::mutex> lock(mtx);
+    std::shared_ptr<const IndiceComposicion>& indice = cache[sec.obtenerIdentidad()];
+    if (!indice || indice->obtenerVersion() != sec.obtenerVersion()) {
+        indice = std::make_shared<const IndiceComposicion>(sec);
+    }
+    return indice;
+}
+
+void Composicion::podar(const std::vector<Secuencia>& secuencias) {
+    std::set<uint64_t> cargadas;
+    for (const auto& sec : secuencias) cargadas.insert(sec.obtenerIdentidad());
+    std::lock_guard<std::mutex> lock(mtx);
+    for (auto it = cache.begin(); it != cache.end();) {
+        if (cargadas.count(it->first)) ++it;
+        else it = cache.erase(it);
+    }
+}
+
+std::vector<VentanaComposicion> Composicion::ventanas(const IndiceComposicion& indice, size_t ventana, size_t paso) {
+    MEDIR_FASE("composicion.ventanas");
+    std::vector<VentanaComposicion> resultado;
+    size_t n = indice.obtenerNumBases();
+    double acumulado = 0;
+    uint64_t cuentas[256];
+    
+    for (size_t inicio = 0; inicio < n; inicio += paso) {
+        VentanaComposicion v;
+        v.inicio = inicio;
+        v.fin = std::min(n, inicio + ventana);
+        indice.contar(v.inicio, v.fin, cuentas);
+        
+        uint64_t g = cuentas['G'] + cuentas['g'], c = cuentas['C'] + cuentas['c'];
+        uint64_t fuertes = g + c + cuentas['S'] + cuentas['s'];
+        uint64_t debiles = cuentas['A'] + cuentas['a'] + cuentas['T'] + cuentas['t'] + cuentas['U'] + cuentas['u'] +
+                           cuentas['W'] + cuentas['w'];
+        v.gc = fuertes + debiles > 0 ? (double)fuertes / (fuertes + debiles) : 0;
+        v.desvio = g + c > 0 ? ((double)g - c) / (g + c) : 0;
+        acumulado += v.desvio;
+        v.desvioAcumulado = acumulado;
+        resultado.push_back(v);
+        if (v.fin == n) break;
+    }
+    return resultado;
+}
@@ -0,0 +1,66 @@
+// ============================================
+// ARCHIVO: Composicion.h
+// ============================================
+#ifndef COMPOSICION_H
+#define COMPOSICION_H
+
+#include "Secuencia.h"
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+// Índice de composición de una secuencia: cuentas acumuladas por rango al
+// inicio de cada bloque de BLOQUE bases, más las bases del bloque (en ADN
+// empaquetadas a 2 bits, contadas con popcount). Cualquier región se
+// cuenta con dos prefijos, cada uno de a lo sumo un bloque.
+class IndiceComposicion {
+public:
+    static const int BLOQUE = 512;
+    
+    explicit IndiceComposicion(const Secuencia& sec);
+    
+    uint64_t obtenerIdentidad() const { return identidad; }
+    uint64_t obtenerVersion() const { return version; }
+    size_t obtenerNumBases() const { return numBases; }
+    size_t memoria() const;
+    // Cuentas por byte de las bases [inicio, fin) en cuentas[256]
+    void contar(size_t inicio, size_t fin, uint64_t* cuentas) const;
+
+private:
+    uint64_t identidad, version;
+    size_t numBases;
+    TipoAlfabeto alfabeto;
+    int tamano;
+    std::vector<char> simbolos;             // byte de cada rango
+    std::vector<uint32_t> acumulados;       // (bloques + 1) * tamano
+    std::vector<uint64_t> empaquetadas;     // ADN: 32 bases por palabra
+    std::vector<uint8_t> rangos;            // otros alfabetos
+    
+    template <typename A> void construir(const char* bases);
+    void prefijo(size_t pos, uint64_t* cuentas) const;
+};
+
+// Contenido GC y desvío (G - C) / (G + C) de una ventana
+struct VentanaComposicion {
+    size_t inicio, fin;
+    double gc, desvio, desvioAcumulado;
+};
+
+// Índices de las secuencias cargadas, reconstruidos cuando la secuencia
+// cambia de versión
+class Composicion {
+private:
+    std::mutex mtx;
+    std::map<uint64_t, std::shared_ptr<const IndiceComposicion>> cache;    // por identidad
+
+public:
+    std::shared_ptr<const IndiceComposicion> obtener(const Secuencia& sec);
+    // Descarta los índices de secuencias que ya no están cargadas
+    void podar(const std::vector<Secuencia>& secuencias);
+    // Ventanas de 'ventana' bases cada 'paso' hasta cubrir la secuencia
+    static std::vector<VentanaComposicion> ventanas(const IndiceComposicion& indice, size_t ventana, size_t paso);
+};
+
+#endif
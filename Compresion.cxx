@@ -0,0 +1,259 @@
+// ============================================
+// ARCHIVO: Compresion.cxx
+// ============================================
+#include "Compresion.h"
+#include "PoolHilos.h"
+#include "Instrumentacion.h"
+#include <zlib.h>
+#include <fstream>
+#include <vector>
+#include <atomic>
+#include <algorithm>
+#include <cstring>
+#include <cstdint>
+
+static const size_t CABECERA_BGZF = 18;
+static const size_t COLA_GZIP = 8;          // CRC32 e ISIZE
+static const size_t MAX_BLOQUE = 65536;
+static const size_t BLOQUES_POR_TAREA = 16;
+
+// Bloque vacío que marca el final de un archivo BGZF
+static const unsigned char FIN_BGZF[28] = {
+    0x1f, 0x8b, 8, 4, 0, 0, 0, 0, 0, 0xff, 6, 0, 'B', 'C', 2, 0,
+    0x1b, 0, 3, 0, 0, 0, 0, 0, 0, 0, 0, 0
+};
+
+struct BloqueBGZF {
+    size_t inicio, largoComprimido;   // datos deflate dentro del archivo
+    size_t salida;                    // desplazamiento en el contenido
+    uint32_t largo, crc;
+};
+
+static uint32_t leer16(const unsigned char* p) {
+    return p[0] | (p[1] << 8);
+}
+
+static uint32_t leer32(const unsigned char* p) {
+    return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static void escribir16(unsigned char* p, uint32_t v) {
+    p[0] = v & 0xff;
+    p[1] = (v >> 8) & 0xff;
+}
+
+static void escribir32(unsigned char* p, uint32_t v) {
+    escribir16(p, v & 0xffff);
+    escribir16(p + 2, v >> 16);
+}
+
+static bool leerArchivo(const std::string& archivo, std::string& bytes) {
+    std::ifstream in(archivo.c_str(), std::ios::binary);
+    if (!in.is_open()) return false;
+    in.seekg(0, std::ios::end);
+    std::streamoff tam = in.tellg();
+    in.seekg(0);
+    bytes.resize(tam);
+    if (tam > 0) in.read(&bytes[0], tam);
+    return (bool)in;
+}
+
+// Tamaño del miembro BGZF que empieza en p, o 0 si no es un miembro BGZF
+static size_t tamanoMiembroBGZF(const unsigned char* p, size_t disponible) {
+    if (disponible < CABECERA_BGZF + COLA_GZIP) return 0;
+    if (p[0] != 0x1f || p[1] != 0x8b || p[2] != 8 || p[3] != 4) return 0;
+    size_t xlen = leer16(p + 10);
+    if (12 + xlen + COLA_GZIP > disponible) return 0;
+    
+    const unsigned char* extra = p + 12;
+    for (size_t k = 0; k + 4 <= xlen; ) {
+        size_t slen = leer16(extra + k + 2);
+        if (extra[k] == 'B' && extra[k + 1] == 'C' && slen == 2 && k + 6 <= xlen) {
+            size_t total = leer16(extra + k + 4) + 1;
+            if (total < 12 + xlen + COLA_GZIP || total > disponible) return 0;
+            if (leer32(p + total - 4) > MAX_BLOQUE) return 0;
+            return total;
+        }
+        k += 4 + slen;
+    }
+    return 0;
+}
+
+static bool inflarBloque(const unsigned char* entrada, size_t largoEntrada,
+                         char* salida, uint32_t largoSalida, uint32_t crcEsperado) {
+    if (largoSalida == 0) return true;
+    z_stream z;
+    memset(&z, 0, sizeof(z));
+    if (inflateInit2(&z, -15) != Z_OK) return false;
+    z.next_in = (Bytef*)entrada;
+    z.avail_in = largoEntrada;
+    z.next_out = (Bytef*)salida;
+    z.avail_out = largoSalida;
+    int r = inflate(&z, Z_FINISH);
+    bool correcto = r == Z_STREAM_END && z.avail_out == 0;
+    inflateEnd(&z);
+    return correcto && crc32(crc32(0, Z_NULL, 0), (const Bytef*)salida, largoSalida) == crcEsperado;
+}
+
+// gzip normal (uno o varios miembros): no se puede partir, un solo hilo
+static bool descomprimirSecuencial(const std::string& bytes, std::string& contenido) {
+    z_stream z;
+    memset(&z, 0, sizeof(z));
+    if (inflateInit2(&z, 15 + 16) != Z_OK) return false;
+    
+    contenido.clear();
+    std::vector<char> buffer(1 << 18);
+    size_t consumido = 0;
+    bool correcto = true;
+    
+    while (true) {
+        if (z.avail_in == 0 && consumido < bytes.size()) {
+            size_t trozo = std::min(bytes.size() - consumido, (size_t)1 << 30);
+            z.next_in = (Bytef*)bytes.data() + consumido;
+            z.avail_in = trozo;
+            consumido += trozo;
+        }
+        z.next_out = (Bytef*)buffer.data();
+        z.avail_out = buffer.size();
+        int r = inflate(&z, Z_NO_FLUSH);
+        contenido.append(buffer.data(), buffer.size() - z.avail_out);
+        
+        if (r == Z_STREAM_END) {
+            if (z.avail_in == 0 && consumido == bytes.size()) break;
+            inflateReset(&z);
+        } else if (r != Z_OK) {
+            correcto = false;
+            break;
+        }
+    }
+    
+    inflateEnd(&z);
+    return correcto;
+}
+
+bool Compresion::esGzip(const std::string& archivo) {
+    std::ifstream in(archivo.c_str(), std::ios::binary);
+    unsigned char firma[2];
+    if (!in.read((char*)firma, 2)) return false;
+    return firma[0] == 0x1f && firma[1] == 0x8b;
+}
+
+bool Compresion::pideCompresion(const std::string& archivo) {
+    auto terminaEn = [&](const std::string& sufijo) {
+        return archivo.length() > sufijo.length() &&
+               archivo.compare(archivo.length() - sufijo.length(), sufijo.length(), sufijo) == 0;
+    };
+    return terminaEn(".gz") || terminaEn(".bgz");
+}
+
+bool Compresion::descomprimir(const std::string& archivo, std::string& contenido, int numHilos) {
+    MEDIR_FASE("gzip.lectura");
+    std::string bytes;
+    if (!leerArchivo(archivo, bytes)) return false;
+    
+    // Índice de bloques; si algún miembro no es BGZF se lee como gzip normal
+    const unsigned char* p = (const unsigned char*)bytes.data();
+    std::vector<BloqueBGZF> bloques;
+    size_t total = 0;
+    for (size_t pos = 0; pos < bytes.size(); ) {
+        size_t tam = tamanoMiembroBGZF(p + pos, bytes.size() - pos);
+        if (tam == 0) {
+            bloques.clear();
+            break;
+        }
+        BloqueBGZF b;
+        b.inicio = pos + 12 + leer16(p + pos + 10);
+        b.largoComprimido = pos + tam - COLA_GZIP - b.inicio;
+        b.crc = leer32(p + pos + tam - 8);
+        b.largo = leer32(p + pos + tam - 4);
+        b.salida = total;
+        total += b.largo;
+        bloques.push_back(b);
+        pos += tam;
+    }
+    if (bloques.empty()) return descomprimirSecuencial(bytes, contenido);
+    BYTES_FASE(total);
+    
+    contenido.assign(total, '\0');
+    std::atomic<bool> correcto(true);
+    PoolHilos pool(numHilos);
+    for (size_t k = 0; k < bloques.size(); k += BLOQUES_POR_TAREA) {
+        pool.encolar([&, k](int) {
+            size_t fin = std::min(k + BLOQUES_POR_TAREA, bloques.size());
+            for (size_t b = k; b < fin && correcto; b++) {
+                const BloqueBGZF& bloque = bloques[b];
+                if (!inflarBloque(p + bloque.inicio, bloque.largoComprimido,
+                                  &contenido[0] + bloque.salida, bloque.largo, bloque.crc)) {
+                    correcto = false;
+                }
+            }
+        });
+    }
+    pool.esperarTodo();
+    return correcto;
+}
+
+// Comprime un bloque como miembro BGZF completo. Si no cabe en 64 KB
+// (datos incompresibles) se repite sin compresión, que siempre cabe.
+static bool comprimirBloque(const char* datos, size_t largo, int nivel, std::string& bloque) {
+    bloque.resize(MAX_BLOQUE);
+    unsigned char* salida = (unsigned char*)&bloque[0];
+    size_t largoComprimido = 0;
+    
+    for (int intento = nivel; ; intento = 0) {
+        z_stream z;
+        memset(&z, 0, sizeof(z));
+        if (deflateInit2(&z, intento, Z_DEFLATED, -15, 8, Z_DEFAULT_STRATEGY) != Z_OK) return false;
+        z.next_in = (Bytef*)datos;
+        z.avail_in = largo;
+        z.next_out = salida + CABECERA_BGZF;
+        z.avail_out = MAX_BLOQUE - CABECERA_BGZF - COLA_GZIP;
+        int r = deflate(&z, Z_FINISH);
+        largoComprimido = z.total_out;
+        deflateEnd(&z);
+        if (r == Z_STREAM_END) break;
+        if (intento == 0) return false;
+    }
+    
+    size_t total = CABECERA_BGZF + largoComprimido + COLA_GZIP;
+    memcpy(salida, FIN_BGZF, 16);   // la cabecera fija es la misma
+    escribir16(salida + 16, total - 1);
+    escribir32(salida + total - 8, crc32(crc32(0, Z_NULL, 0), (const Bytef*)datos, largo));
+    escribir32(salida + total - 4, largo);
+    bloque.resize(total);
+    return true;
+}
+
+bool Compresion::comprimirBGZF(const std::string& archivo, const std::string& contenido,
+                               int numHilos, int nivel) {
+    MEDIR_FASE("bgzf.escritura");
+    BYTES_FASE(contenido.size());
+    size_t numBloques = (contenido.size() + BLOQUE_BGZF - 1) / BLOQUE_BGZF;
+    std::vector<std::string> comprimidos(numBloques);
+    std::atomic<bool> correcto(true);
+    
+    PoolHilos pool(numHilos);
+    for (size_t k = 0; k < numBloques; k += BLOQUES_POR_TAREA) {
+        pool.encolar([&, k](int) {
+            size_t fin = std::min(k + BLOQUES_POR_TAREA, numBloques);
+            for (size_t b = k; b < fin && correcto; b++) {
+                size_t inicio = b * BLOQUE_BGZF;
+                size_t largo = std::min((size_t)BLOQUE_BGZF, contenido.size() - inicio);
+                if (!comprimirBloque(contenido.data() + inicio, largo, nivel, comprimidos[b])) {
+                    correcto = false;
+                }
+            }
+        });
+    }
+    pool.esperarTodo();
+    if (!correcto) return false;
+    
+    std::ofstream out(archivo.c_str(), std::ios::binary | std::ios::trunc);
+    if (!out.is_open()) return false;
+    for (const std::string& bloque : comprimidos) {
+        out.write(bloque.data(), bloque.size());
+    }
+    out.write((const char*)FIN_BGZF, sizeof(FIN_BGZF));
+    out.close();
+    return (bool)out;
+}
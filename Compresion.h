@@ -0,0 +1,27 @@
+// ============================================
+// ARCHIVO: Compresion.h
+// ============================================
+#ifndef COMPRESION_H
+#define COMPRESION_H
+
+#include <string>
+
+// Lectura de gzip y lectura/escritura de BGZF con zlib. BGZF es gzip
+// partido en miembros independientes de hasta 64 KB, cada uno con su
+// tamaño en la cabecera (subcampo "BC"), así que los bloques se pueden
+// comprimir y descomprimir en paralelo. Un gzip normal se lee en un solo
+// hilo.
+class Compresion {
+public:
+    static const int BLOQUE_BGZF = 0xff00;  // bytes sin comprimir por bloque
+    
+    // true si el archivo empieza con la firma de gzip
+    static bool esGzip(const std::string& archivo);
+    // true si el nombre pide salida comprimida (.gz, .bgz)
+    static bool pideCompresion(const std::string& archivo);
+    static bool descomprimir(const std::string& archivo, std::string& contenido, int numHilos);
+    static bool comprimirBGZF(const std::string& archivo, const std::string& contenido,
+                              int numHilos, int nivel = 6);
+};
+
+#endif
@@ -0,0 +1,316 @@
+// ============================================
+// ARCHIVO: ContadorKmers.cxx
+// ============================================
+#include "ContadorKmers.h"
+#include "PoolHilos.h"
+#include "Instrumentacion.h"
+#include "CodigosKmers.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <deque>
+
+// Ninguna clave canónica es todo unos: su complemento reverso sería 0
+static const uint64_t VACIA = ~0ULL;
+static const size_t VENTANAS_POR_TRAMO = 1 << 18;
+static const size_t VENTANAS_POR_TRAMO_MINIMO = 1 << 12;
+static const double CARGA_MAXIMA = 0.7;
+static const size_t BYTES_POR_RANURA = sizeof(uint64_t) + sizeof(uint32_t);
+static const int BITS_INICIALES = 12;
+static const size_t CUENTAS_DIRECTAS = 1024;
+
+// Tabla de direccionamiento abierto con sondeo lineal. No crece más allá
+// de limiteBytes (contando el arreglo viejo durante el rehash).
+class TablaKmers {
+private:
+    std::vector<uint64_t> claves;
+    std::vector<uint32_t> cuentas;
+    size_t ocupadas;
+    int bits;
+    size_t limiteBytes;
+    
+    // De mezclar(clave) los bits bajos eligen la pasada y los altos el
+    // dueño; la ranura sale de otro hash multiplicativo encima
+    size_t ranura(uint64_t clave) const {
+        return (mezclar(clave) * 0x9E3779B97F4A7C15ULL) >> (64 - bits);
+    }
+    
+    bool crecer() {
+        size_t nueva = claves.size() * 2;
+        if ((nueva + claves.size()) * BYTES_POR_RANURA > limiteBytes) return false;
+        std::vector<uint64_t> viejasClaves(nueva, VACIA);
+        std::vector<uint32_t> viejasCuentas(nueva, 0);
+        viejasClaves.swap(claves);
+        viejasCuentas.swap(cuentas);
+        bits++;
+        
+        size_t mascara = claves.size() - 1;
+        for (size_t i = 0; i < viejasClaves.size(); i++) {
+            if (viejasClaves[i] == VACIA) continue;
+            size_t r = ranura(viejasClaves[i]);
+            while (claves[r] != VACIA) r = (r + 1) & mascara;
+            claves[r] = viejasClaves[i];
+            cuentas[r] = viejasCuentas[i];
+        }
+        return true;
+    }
+
+public:
+    TablaKmers() : ocupadas(0), bits(0), limiteBytes(0) {}
+    
+    void preparar(size_t limite) {
+        limiteBytes = limite;
+        bits = BITS_INICIALES;
+        claves.assign((size_t)1 << bits, VACIA);
+        cuentas.assign((size_t)1 << bits, 0);
+        ocupadas = 0;
+    }
+    
+    void liberar() {
+        std::vector<uint64_t>().swap(claves);
+        std::vector<uint32_t>().swap(cuentas);
+        ocupadas = 0;
+    }
+    
+    // false si la clave es nueva y la tabla ya no puede crecer
+    bool sumar(uint64_t clave) {
+        size_t mascara = claves.size() - 1;
+        size_t r = ranura(clave);
+        while (claves[r] != VACIA && claves[r] != clave) r = (r + 1) & mascara;
+        if (claves[r] == clave) {
+            if (cuentas[r] != UINT32_MAX) cuentas[r]++;
+            return true;
+        }
+        if (ocupadas + 1 > claves.size() * CARGA_MAXIMA) {
+            return crecer() && sumar(clave);
+        }
+        claves[r] = clave;
+        cuentas[r] = 1;
+        ocupadas++;
+        return true;
+    }
+    
+    size_t tamano() const { return claves.size(); }
+    uint64_t clave(size_t i) const { return claves[i]; }
+    uint32_t cuenta(size_t i) const { return cuentas[i]; }
+};
+
+// Ventanas [desde, hasta) de una secuencia: las bases leídas llegan hasta hasta + k - 1
+struct TramoKmers {
+    const char* bases;
+    size_t desde, hasta;
+};
+
+// Fracción del espacio de claves: las de hash % modulo == resto (modulo
+// es potencia de dos)
+struct PasadaKmers {
+    uint64_t modulo, resto;
+};
+
+// Resumen de una tabla, listo para combinarse con los demás
+struct ParcialKmers {
+    uint64_t total, distintos, unicos;
+    std::vector<uint64_t> cuentasDirectas;
+    std::map<uint64_t, uint64_t> cuentasAltas;
+    std::vector<std::pair<uint64_t, uint64_t>> masFrecuentes;
+};
+
+static bool esMejor(const std::pair<uint64_t, uint64_t>& a, const std::pair<uint64_t, uint64_t>& b) {
+    return a.second != b.second ? a.second > b.second : a.first < b.first;
+}
+
+static void escanear(const TramoKmers& tramo, int k, const PasadaKmers& pasada, int numDuenos,
+                     std::vector<std::vector<uint64_t>>& buzones) {
+    const uint64_t mascara = k == 32 ? ~0ULL : ((1ULL << (2 * k)) - 1);
+    const int desplazamiento = 2 * (k - 1);
+    uint64_t directo = 0, reverso = 0;
+    int validas = 0;
+    
+    for (size_t i = tramo.desde; i < tramo.hasta + k - 1; i++) {
+        int c = CodigosKmers<>::CODIGO[(unsigned char)tramo.bases[i]];
+        if (c < 0) {
+            validas = 0;
+            continue;
+        }
+        directo = ((directo << 2) | c) & mascara;
+        reverso = (reverso >> 2) | ((uint64_t)(3 - c) << desplazamiento);
+        if (++validas < k) continue;
+        
+        uint64_t clave = std::min(directo, reverso);
+        uint64_t h = mezclar(clave);
+        if ((h & (pasada.modulo - 1)) != pasada.resto) continue;
+        buzones[(h >> 40) % numDuenos].push_back(clave);
+    }
+}
+
+static void resumir(const TablaKmers& tabla, size_t numMasFrecuentes, ParcialKmers& parcial) {
+    parcial.distintos = 0;
+    parcial.unicos = 0;
+    parcial.cuentasDirectas.assign(CUENTAS_DIRECTAS, 0);
+    parcial.cuentasAltas.clear();
+    parcial.masFrecuentes.clear();
+    
+    // Montículo con el peor de los mejores arriba
+    auto& top = parcial.masFrecuentes;
+    for (size_t i = 0; i < tabla.tamano(); i++) {
+        if (tabla.clave(i) == VACIA) continue;
+        uint64_t cuenta = tabla.cuenta(i);
+        parcial.distintos++;
+        if (cuenta == 1) parcial.unicos++;
+        if (cuenta < CUENTAS_DIRECTAS) parcial.cuentasDirectas[cuenta]++;
+        else parcial.cuentasAltas[cuenta]++;
+        
+        if (numMasFrecuentes == 0) continue;
+        std::pair<uint64_t, uint64_t> candidato(tabla.clave(i), cuenta);
+        if (top.size() < numMasFrecuentes) {
+            top.push_back(candidato);
+            std::push_heap(top.begin(), top.end(), esMejor);
+        } else if (esMejor(candidato, top.front())) {
+            std::pop_heap(top.begin(), top.end(), esMejor);
+            top.back() = candidato;
+            std::push_heap(top.begin(), top.end(), esMejor);
+        }
+    }
+}
+
+bool ContadorKmers::contar(const std::vector<Secuencia>& secuencias, int k, int numHilos,
+                           size_t memoriaMaxima, size_t numMasFrecuentes, ResultadoKmers& resultado) {
+    MEDIR_FASE("kmers.conteo");
+    if (k < 1 || k > K_MAXIMO) return false;
+    if (numHilos < 1) numHilos = 1;
+    
+    resultado = ResultadoKmers();
+    resultado.k = k;
+    resultado.total = resultado.distintos = resultado.unicos = 0;
+    resultado.pasadas = 0;
+    
+    // Una ronda de buzones (un tramo por hilo) usa a lo sumo un cuarto de la memoria
+    size_t ventanasPorTramo = memoriaMaxima / 4 / ((size_t)numHilos * sizeof(uint64_t));
+    ventanasPorTramo = std::max(VENTANAS_POR_TRAMO_MINIMO, std::min(VENTANAS_POR_TRAMO, ventanasPorTramo));
+    
+    std::vector<TramoKmers> tramos;
+    uint64_t ventanas = 0;
+    for (const auto& sec : secuencias) {
+        size_t n = sec.obtenerNumBases();
+        if (n < (size_t)k) continue;
+        size_t v = n - k + 1;
+        ventanas += v;
+        BYTES_FASE(n);
+        for (size_t s = 0; s < v; s += ventanasPorTramo) {
+            TramoKmers t;
+            t.bases = sec.obtenerBases();
+            t.desde = s;
+            t.hasta = std::min(v, s + ventanasPorTramo);
+            tramos.push_back(t);
+        }
+    }
+    
+    // Reparto de memoria: la ronda de buzones y el resto para las tablas.
+    // Las pasadas iniciales se estiman con la cota de distintos (ventanas o
+    // 4^k); si una tabla se desborda, su pasada se parte en dos.
+    size_t memoriaBuzones = (size_t)numHilos * ventanasPorTramo * sizeof(uint64_t);
+    size_t minimoTablas = (size_t)numHilos * 3 * ((size_t)1 << BITS_INICIALES) * BYTES_POR_RANURA;
+    size_t memoriaTablas = memoriaMaxima > memoriaBuzones ? memoriaMaxima - memoriaBuzones : 0;
+    memoriaTablas = std::max(memoriaTablas, minimoTablas);
+    size_t limitePorTabla = memoriaTablas / numHilos;
+    
+    double cota = (double)ventanas;
+    if (k < 32) cota = std::min(cota, std::pow(4.0, k));
+    double bytesEstimados = cota * BYTES_POR_RANURA * 2 / CARGA_MAXIMA;
+    uint64_t pasadasIniciales = 1;
+    while (pasadasIniciales * (double)memoriaTablas < bytesEstimados) pasadasIniciales *= 2;
+    
+    std::deque<PasadaKmers> pendientes;
+    for (uint64_t p = 0; p < pasadasIniciales; p++) {
+        PasadaKmers pasada = {pasadasIniciales, p};
+        pendientes.push_back(pasada);
+    }
+    
+    PoolHilos pool(numHilos);
+    int numDuenos = pool.obtenerNumHilos();
+    std::vector<TablaKmers> tablas(numDuenos);
+    std::vector<std::vector<std::vector<uint64_t>>> buzones(
+        numDuenos, std::vector<std::vector<uint64_t>>(numDuenos));
+    std::vector<uint64_t> insertadas(numDuenos);
+    std::vector<ParcialKmers> parciales(numDuenos);
+    std::vector<uint64_t> cuentasDirectas(CUENTAS_DIRECTAS, 0);
+    std::vector<std::pair<uint64_t, uint64_t>> candidatos;
+    
+    while (!pendientes.empty()) {
+        PasadaKmers pasada = pendientes.front();
+        pendientes.pop_front();
+        std::atomic<bool> desborde(false);
+        for (int d = 0; d < numDuenos; d++) {
+            tablas[d].preparar(limitePorTabla);
+            insertadas[d] = 0;
+        }
+        
+        for (size_t ronda = 0; ronda < tramos.size() && !desborde; ronda += numDuenos) {
+            for (int t = 0; t < numDuenos && ronda + t < tramos.size(); t++) {
+                pool.encolar([&, ronda, t](int) {
+                    escanear(tramos[ronda + t], k, pasada, numDuenos, buzones[t]);
+                });
+            }
+            pool.esperarTodo();
+            
+            for (int d = 0; d < numDuenos; d++) {
+                pool.encolar([&, d](int) {
+                    for (int emisor = 0; emisor < numDuenos; emisor++) {
+                        std::vector<uint64_t>& buzon = buzones[emisor][d];
+                        for (size_t i = 0; i < buzon.size() && !desborde; i++) {
+                            if (!tablas[d].sumar(buzon[i])) desborde = true;
+                        }
+                        insertadas[d] += buzon.size();
+                        buzon.clear();
+                    }
+                });
+            }
+            pool.esperarTodo();
+        }
+        
+        if (desborde) {
+            PasadaKmers mitad1 = {pasada.modulo * 2, pasada.resto};
+            PasadaKmers mitad2 = {pasada.modulo * 2, pasada.resto + pasada.modulo};
+            pendientes.push_front(mitad2);
+            pendientes.push_front(mitad1);
+            continue;
+        }
+        resultado.pasadas++;
+        
+        for (int d = 0; d < numDuenos; d++) {
+            pool.encolar([&, d](int) {
+                resumir(tablas[d], numMasFrecuentes, parciales[d]);
+                tablas[d].liberar();
+            });
+        }
+        pool.esperarTodo();
+        
+        for (int d = 0; d < numDuenos; d++) {
+            const ParcialKmers& parcial = parciales[d];
+            resultado.total += insertadas[d];
+            resultado.distintos += parcial.distintos;
+            resultado.unicos += parcial.unicos;
+            for (size_t c = 0; c < CUENTAS_DIRECTAS; c++) cuentasDirectas[c] += parcial.cuentasDirectas[c];
+            for (const auto& par : parcial.cuentasAltas) resultado.histograma[par.first] += par.second;
+            candidatos.insert(candidatos.end(), parcial.masFrecuentes.begin(), parcial.masFrecuentes.end());
+        }
+        std::sort(candidatos.begin(), candidatos.end(), esMejor);
+        if (candidatos.size() > numMasFrecuentes) candidatos.resize(numMasFrecuentes);
+    }
+    
+    for (size_t c = 1; c < CUENTAS_DIRECTAS; c++) {
+        if (cuentasDirectas[c] > 0) resultado.histograma[c] = cuentasDirectas[c];
+    }
+    resultado.masFrecuentes = candidatos;
+    return true;
+}
+
+std::string ContadorKmers::decodificar(uint64_t clave, int k) {
+    static const char BASES[] = "ACGT";
+    std::string kmer(k, 'A');
+    for (int i = k - 1; i >= 0; i--) {
+        kmer[i] = BASES[clave & 3];
+        clave >>= 2;
+    }
+    return kmer;
+}
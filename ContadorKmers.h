@@ -0,0 +1,44 @@
+// ============================================
+// ARCHIVO: ContadorKmers.h
+// ============================================
+#ifndef CONTADORKMERS_H
+#define CONTADORKMERS_H
+
+#include "Secuencia.h"
+#include <cstdint>
+#include <cstddef>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+struct ResultadoKmers {
+    int k;
+    uint64_t total;       // ventanas contadas (sin N, IUPAC ni X)
+    uint64_t distintos;
+    uint64_t unicos;      // k-mers que aparecen una sola vez
+    int pasadas;          // recorridos de la entrada para respetar la memoria
+    // (clave, cuenta) de mayor a menor cuenta; a igual cuenta, menor clave
+    std::vector<std::pair<uint64_t, uint64_t>> masFrecuentes;
+    // cuenta -> número de k-mers distintos con esa cuenta
+    std::map<uint64_t, uint64_t> histograma;
+};
+
+// Conteo de k-mers canónicos (el menor entre el k-mer y su complemento
+// reverso), codificados a 2 bits por base en una clave de 64 bits.
+// El espacio de claves se reparte por hash entre los hilos: cada hilo
+// recorre un tramo de la entrada y envía las claves a buzones por dueño,
+// y cada dueño las inserta en su propia tabla de direccionamiento abierto.
+// Si las tablas no caben en memoriaMaxima se hacen varias pasadas, cada
+// una sobre una fracción del espacio de claves.
+class ContadorKmers {
+public:
+    static const int K_MAXIMO = 32;
+    static const size_t MEMORIA_POR_DEFECTO = 1024UL * 1024 * 1024;
+    
+    static bool contar(const std::vector<Secuencia>& secuencias, int k, int numHilos,
+                       size_t memoriaMaxima, size_t numMasFrecuentes, ResultadoKmers& resultado);
+    static std::string decodificar(uint64_t clave, int k);
+};
+
+#endif
@@ -0,0 +1,95 @@
+// ============================================
+// ARCHIVO: Crc32c.cxx
+// ============================================
+#include "Crc32c.h"
+#include "Instrumentacion.h"
+#include <cstring>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <nmmintrin.h>
+#define CRC32C_HARDWARE 1
+#endif
+
+static const uint32_t POLINOMIO = 0x82f63b78;  // reflejado
+
+// tabla[k][b]: CRC del byte b seguido de k bytes en cero
+struct TablasCrc {
+    uint32_t tabla[8][256];
+    TablasCrc() {
+        for (uint32_t b = 0; b < 256; b++) {
+            uint32_t crc = b;
+            for (int i = 0; i < 8; i++) crc = (crc >> 1) ^ (POLINOMIO & (0u - (crc & 1)));
+            tabla[0][b] = crc;
+        }
+        for (uint32_t b = 0; b < 256; b++) {
+            for (int k = 1; k < 8; k++) {
+                tabla[k][b] = (tabla[k - 1][b] >> 8) ^ tabla[0][tabla[k - 1][b] & 0xff];
+            }
+        }
+    }
+};
+
+static const TablasCrc& tablas() {
+    static const TablasCrc t;
+    return t;
+}
+
+uint32_t Crc32c::calcularConTablas(const void* datos, size_t n, uint32_t crc) {
+    const uint32_t (*t)[256] = tablas().tabla;
+    const unsigned char* p = (const unsigned char*)datos;
+    crc = ~crc;
+    for (; n >= 8; n -= 8, p += 8) {
+        uint32_t bajo, alto;
+        memcpy(&bajo, p, 4);
+        memcpy(&alto, p + 4, 4);
+        bajo ^= crc;
+        crc = t[7][bajo & 0xff] ^ t[6][(bajo >> 8) & 0xff] ^ t[5][(bajo >> 16) & 0xff] ^ t[4][bajo >> 24] ^
+              t[3][alto & 0xff] ^ t[2][(alto >> 8) & 0xff] ^ t[1][(alto >> 16) & 0xff] ^ t[0][alto >> 24];
+    }
+    while (n--) crc = (crc >> 8) ^ t[0][(crc ^ *p++) & 0xff];
+    return ~crc;
+}
+
+#ifdef CRC32C_HARDWARE
+// Compilada para SSE4.2 aunque el resto no lo esté; solo se llama si
+// porHardware() lo confirma
+__attribute__((target("sse4.2")))
+static uint32_t calcularConInstruccion(const void* datos, size_t n, uint32_t crc) {
+    const unsigned char* p = (const unsigned char*)datos;
+    crc = ~crc;
+#ifdef __x86_64__
+    uint64_t c = crc;
+    for (; n >= 8; n -= 8, p += 8) {
+        uint64_t palabra;
+        memcpy(&palabra, p, 8);
+        c = _mm_crc32_u64(c, palabra);
+    }
+    crc = (uint32_t)c;
+#endif
+    for (; n >= 4; n -= 4, p += 4) {
+        uint32_t palabra;
+        memcpy(&palabra, p, 4);
+        crc = _mm_crc32_u32(crc, palabra);
+    }
+    while (n--) crc = _mm_crc32_u8(crc, *p++);
+    return ~crc;
+}
+#endif
+
+bool Crc32c::porHardware() {
+#ifdef CRC32C_HARDWARE
+    static const bool tiene = __builtin_cpu_supports("sse4.2");
+    return tiene;
+#else
+    return false;
+#endif
+}
+
+uint32_t Crc32c::calcular(const void* datos, size_t n, uint32_t crc) {
+    MEDIR_FASE("crc32c");
+    BYTES_FASE(n);
+#ifdef CRC32C_HARDWARE
+    if (porHardware()) return calcularConInstruccion(datos, n, crc);
+#endif
+    return calcularConTablas(datos, n, crc);
+}
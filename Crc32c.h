@@ -0,0 +1,21 @@
+// ============================================
+// ARCHIVO: Crc32c.h
+// ============================================
+#ifndef CRC32C_H
+#define CRC32C_H
+
+#include <cstddef>
+#include <cstdint>
+
+// CRC32C (polinomio de Castagnoli). Usa la instrucción crc32 de SSE4.2
+// cuando el procesador la tiene y, si no, tablas de 8 bytes por paso.
+class Crc32c {
+public:
+    // CRC de los datos; 'crc' permite continuar uno anterior por trozos
+    static uint32_t calcular(const void* datos, size_t n, uint32_t crc = 0);
+    // Calcula con tablas aunque haya instrucción, para comparar ambos caminos
+    static uint32_t calcularConTablas(const void* datos, size_t n, uint32_t crc = 0);
+    static bool porHardware();
+};
+
+#endif
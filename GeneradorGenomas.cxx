@@ -0,0 +1,70 @@
+// ============================================
+// ARCHIVO: GeneradorGenomas.cxx
+// ============================================
+#include "GeneradorGenomas.h"
+#include <random>
+#include <string>
+#include <algorithm>
+
+ParametrosGenoma::ParametrosGenoma()
+    : totalBases(4000000), numRegistros(4), anchoLinea(60),
+      tasaN(0.0005), tasaIUPAC(0.001), semilla(2025) {}
+
+std::vector<Secuencia> GeneradorGenomas::generar(const ParametrosGenoma& params) {
+    std::mt19937_64 gen(params.semilla);
+    const char bases[] = "ACGT";
+    const char ambiguas[] = "RYKMSWBDHV";
+    
+    // Umbrales enteros sobre 2^32 para no depender de la distribución real
+    const uint64_t escala = 1ULL << 32;
+    uint64_t umbralN = (uint64_t)(params.tasaN * escala);
+    uint64_t umbralIUPAC = umbralN + (uint64_t)(params.tasaIUPAC * escala);
+    
+    int registros = params.numRegistros > 0 ? params.numRegistros : 1;
+    std::vector<Secuencia> secuencias;
+    
+    for (int r = 0; r < registros; r++) {
+        uint64_t longitud = params.totalBases / registros;
+        if (r < (int)(params.totalBases % registros)) longitud++;
+        
+        std::string datos;
+        datos.reserve(longitud);
+        while (datos.length() < longitud) {
+            uint64_t azar = gen();
+            uint64_t tirada = azar & (escala - 1);
+            if (tirada < umbralN) {
+                uint64_t racha = 10 + (azar >> 32) % 191;
+                datos.append(std::min(racha, longitud - datos.length()), 'N');
+            } else if (tirada < umbralIUPAC) {
+                datos += ambiguas[(azar >> 32) % 10];
+            } else {
+                datos += bases[(azar >> 32) & 3];
+            }
+        }
+        
+        secuencias.push_back(Secuencia("sintetica_" + std::to_string(r + 1), datos, params.anchoLinea));
+    }
+    
+    return secuencias;
+}
+
+Secuencia GeneradorGenomas::rejilla(int lado, unsigned semilla) {
+    std::mt19937 gen(semilla);
+    const char bases[] = "ACGT";
+    std::string datos(lado * lado, 'A');
+    for (char& c : datos) c = bases[gen() % 4];
+    return Secuencia("sintetica", datos, lado);
+}
+
+std::vector<std::vector<Secuencia>> GeneradorGenomas::amplicones(const Secuencia& fuente, int cuantos, size_t largo,
+                                                                 unsigned semilla) {
+    std::vector<std::vector<Secuencia>> lotes;
+    std::string datos = fuente.obtenerDatos();
+    std::mt19937 gen(semilla);
+    for (int k = 0; k < cuantos; k++) {
+        size_t desde = gen() % (datos.length() - largo);
+        lotes.push_back(std::vector<Secuencia>(1, Secuencia("amplicon_" + std::to_string(k),
+                                                            datos.substr(desde, largo), 60)));
+    }
+    return lotes;
+}
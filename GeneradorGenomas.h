@@ -0,0 +1,34 @@
+// ============================================
+// ARCHIVO: GeneradorGenomas.h
+// ============================================
+#ifndef GENERADORGENOMAS_H
+#define GENERADORGENOMAS_H
+
+#include "Secuencia.h"
+#include <cstdint>
+#include <vector>
+
+// Parámetros del genoma sintético. Con la misma semilla el resultado es
+// idéntico en cualquier plataforma (mt19937_64 + aritmética entera).
+struct ParametrosGenoma {
+    uint64_t totalBases;
+    int numRegistros;
+    int anchoLinea;
+    double tasaN;        // probabilidad por base de iniciar una racha de N
+    double tasaIUPAC;    // probabilidad por base de un código ambiguo
+    uint64_t semilla;
+    
+    ParametrosGenoma();
+};
+
+class GeneradorGenomas {
+public:
+    static std::vector<Secuencia> generar(const ParametrosGenoma& params);
+    // Rejilla cuadrada lado x lado con bases ACGT al azar
+    static Secuencia rejilla(int lado, unsigned semilla);
+    // Tramos cortos de 'fuente', uno por lote, como amplicones de un corpus
+    static std::vector<std::vector<Secuencia>> amplicones(const Secuencia& fuente, int cuantos, size_t largo,
+                                                          unsigned semilla);
+};
+
+#endif
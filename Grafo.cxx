@@ -2,125 +2,331 @@
 // ARCHIVO: Grafo.cxx
 // ============================================
 #include "Grafo.h"
+#include "Instrumentacion.h"
 #include <queue>
+#include <functional>
 #include <cmath>
 #include <algorithm>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+// Barrera reutilizable para los hilos de delta-stepping
+struct BarreraHilos {
+    std::mutex mtx;
+    std::condition_variable cv;
+    int total, esperando, generacion;
+    
+    BarreraHilos(int n) : total(n), esperando(0), generacion(0) {}
+    
+    void esperar() {
+        std::unique_lock<std::mutex> lock(mtx);
+        int gen = generacion;
+        if (++esperando == total) {
+            esperando = 0;
+            generacion++;
+            cv.notify_all();
+        } else {
+            cv.wait(lock, [&] { return gen != generacion; });
+        }
+    }
+};
+
+struct Relajacion {
+    int nodo;
+    double dist;
+    Relajacion(int n, double d) : nodo(n), dist(d) {}
+};
 
 double Grafo::calcularPeso(char base1, char base2) {
-    int ascii1 = (int)base1;
-    int ascii2 = (int)base2;
-    return 1.0 / (1.0 + abs(ascii1 - ascii2));
+    return PesosAlfabeto<AlfabetoBytes>::peso(base1, base2);
+}
+
+Grafo::Grafo()
+    : nodos(nullptr), inicioAristas(nullptr), aristas(nullptr), numNodos(0), numAristas(0),
+      identidadSecuencia(0), versionSecuencia(0), filas(0), columnas(0), numBases(0) {
+    apuntarPropios();
+}
+
+Grafo::Grafo(const Grafo& otro) {
+    *this = otro;
+}
+
+Grafo& Grafo::operator=(const Grafo& otro) {
+    if (this == &otro) return *this;
+    nodosPropios = otro.nodosPropios;
+    inicioPropio = otro.inicioPropio;
+    aristasPropias = otro.aristasPropias;
+    numNodos = otro.numNodos;
+    numAristas = otro.numAristas;
+    mapeo = otro.mapeo;
+    identidadSecuencia = otro.identidadSecuencia;
+    versionSecuencia = otro.versionSecuencia;
+    filas = otro.filas;
+    columnas = otro.columnas;
+    numBases = otro.numBases;
+    if (mapeo) {
+        nodos = otro.nodos;
+        inicioAristas = otro.inicioAristas;
+        aristas = otro.aristas;
+    } else {
+        apuntarPropios();
+    }
+    return *this;
+}
+
+void Grafo::apuntarPropios() {
+    if (inicioPropio.empty()) inicioPropio.push_back(0);
+    nodos = nodosPropios.data();
+    inicioAristas = inicioPropio.data();
+    aristas = aristasPropias.data();
+    numNodos = nodosPropios.size();
+    numAristas = aristasPropias.size();
+}
+
+void Grafo::materializar() {
+    if (!mapeo) return;
+    nodosPropios.assign(nodos, nodos + numNodos);
+    inicioPropio.assign(inicioAristas, inicioAristas + numNodos + 1);
+    aristasPropias.assign(aristas, aristas + numAristas);
+    mapeo.reset();
+    apuntarPropios();
 }
 
 void Grafo::construir(const Secuencia& sec) {
-    nodos.clear();
-    adyacencias.clear();
-    posicionAIndice.clear();
+    MEDIR_FASE("grafo.construccion");
+    BYTES_FASE(sec.obtenerNumBases());
+    mapeo.reset();
+    nodosPropios.clear();
+    inicioPropio.clear();
+    aristasPropias.clear();
     
-    int filas = sec.obtenerFilas();
-    int cols = sec.obtenerColumnas();
+    filas = sec.obtenerFilas();
+    columnas = sec.obtenerColumnas();
+    numBases = sec.obtenerNumBases();
+    identidadSecuencia = sec.obtenerIdentidad();
+    versionSecuencia = sec.obtenerVersion();
+    int cols = columnas;
     
-    // Crear nodos
+    // Crear nodos: las posiciones válidas son contiguas, así que el índice
+    // de cada nodo coincide con su posición lineal
+    nodosPropios.reserve(numBases);
     for (int i = 0; i < filas; i++) {
         for (int j = 0; j < cols; j++) {
             if (sec.posicionValida(i, j)) {
-                char base = sec.obtenerBase(i, j);
-                int indice = nodos.size();
-                nodos.push_back(Nodo(i, j, base));
-                posicionAIndice[{i, j}] = indice;
+                nodosPropios.push_back(Nodo(i, j, sec.obtenerBase(i, j)));
             }
         }
     }
     
-    adyacencias.resize(nodos.size());
-    
-    // Crear aristas (4 vecinos)
+    switch (sec.obtenerAlfabeto()) {
+        case ALFABETO_ADN: crearAristas<AlfabetoADN>(sec); break;
+        case ALFABETO_IUPAC: crearAristas<AlfabetoIUPAC>(sec); break;
+        case ALFABETO_PROTEINA: crearAristas<AlfabetoProteina>(sec); break;
+        case ALFABETO_BYTES: crearAristas<AlfabetoBytes>(sec); break;
+    }
+    apuntarPropios();
+}
+
+// Aristas a los 4 vecinos, con el peso tomado de la matriz del alfabeto
+template <typename A>
+void Grafo::crearAristas(const Secuencia& sec) {
     int dx[] = {-1, 1, 0, 0};
     int dy[] = {0, 0, -1, 1};
+    int cols = columnas;
+    
+    std::vector<int16_t> rangos(nodosPropios.size());
+    for (size_t idx = 0; idx < nodosPropios.size(); idx++) {
+        rangos[idx] = TablasAlfabeto<A>::RANGO[(unsigned char)nodosPropios[idx].base];
+    }
     
-    for (int idx = 0; idx < (int)nodos.size(); idx++) {
-        int i = nodos[idx].fila;
-        int j = nodos[idx].col;
-        char base1 = nodos[idx].base;
+    inicioPropio.reserve(nodosPropios.size() + 1);
+    aristasPropias.reserve(nodosPropios.size() * 4);
+    for (int idx = 0; idx < (int)nodosPropios.size(); idx++) {
+        inicioPropio.push_back(aristasPropias.size());
+        int i = nodosPropios[idx].fila;
+        int j = nodosPropios[idx].col;
         
         for (int k = 0; k < 4; k++) {
             int ni = i + dx[k];
             int nj = j + dy[k];
             
             if (sec.posicionValida(ni, nj)) {
-                auto it = posicionAIndice.find({ni, nj});
-                if (it != posicionAIndice.end()) {
-                    int vecino = it->second;
-                    char base2 = nodos[vecino].base;
-                    double peso = calcularPeso(base1, base2);
-                    adyacencias[idx].push_back(Arista(vecino, peso));
-                }
+                int vecino = ni * cols + nj;
+                double peso = PesosAlfabeto<A>::peso(rangos[idx], rangos[vecino]);
+                aristasPropias.push_back(Arista(vecino, peso));
             }
         }
     }
+    inicioPropio.push_back(aristasPropias.size());
+}
+
+void Grafo::parchearCelda(int indice, char base) {
+    nodosPropios[indice].base = base;
+    for (int a = inicioPropio[indice]; a < inicioPropio[indice + 1]; a++) {
+        Arista& arista = aristasPropias[a];
+        arista.peso = calcularPeso(base, nodosPropios[arista.destino].base);
+        for (int b = inicioPropio[arista.destino]; b < inicioPropio[arista.destino + 1]; b++) {
+            Arista& inversa = aristasPropias[b];
+            if (inversa.destino == indice) {
+                inversa.peso = calcularPeso(nodosPropios[arista.destino].base, base);
+            }
+        }
+    }
+}
+
+bool Grafo::sincronizar(const Secuencia& sec, int& celdasParcheadas) {
+    MEDIR_FASE("grafo.parcheo");
+    celdasParcheadas = 0;
+    if (sec.obtenerFilas() != filas || sec.obtenerColumnas() != columnas ||
+        sec.obtenerNumBases() != numBases) {
+        return false;
+    }
+    
+    std::vector<int> posiciones;
+    bool mismaSecuencia = sec.obtenerIdentidad() == identidadSecuencia;
+    
+    if (mismaSecuencia && sec.obtenerVersion() == versionSecuencia) {
+        return true;
+    }
+    
+    materializar();
+    
+    if (mismaSecuencia && sec.cambiosDesde(versionSecuencia, posiciones)) {
+        for (int pos : posiciones) {
+            int indice = obtenerIndice(pos / columnas, pos % columnas);
+            char base = sec.obtenerBase(pos / columnas, pos % columnas);
+            if (indice != -1 && nodos[indice].base != base) {
+                parchearCelda(indice, base);
+                celdasParcheadas++;
+            }
+        }
+    } else {
+        // Otra secuencia (p. ej. recargada) o diario insuficiente: comparar todo
+        for (int indice = 0; indice < numNodos; indice++) {
+            char base = sec.obtenerBase(nodos[indice].fila, nodos[indice].col);
+            if (nodos[indice].base != base) {
+                parchearCelda(indice, base);
+                celdasParcheadas++;
+            }
+        }
+    }
+    
+    identidadSecuencia = sec.obtenerIdentidad();
+    versionSecuencia = sec.obtenerVersion();
+    return true;
+}
+
+void EspacioBusqueda::preparar(int n) {
+    dist.assign(n, std::numeric_limits<double>::infinity());
+    padre.assign(n, -1);
+    visitado.assign(n, 0);
+    esDestino.assign(n, 0);
+    monton.clear();
 }
 
 std::vector<Nodo> Grafo::dijkstra(int origen, int destino, double& costoTotal) {
-    int n = nodos.size();
-    std::vector<double> dist(n, std::numeric_limits<double>::infinity());
-    std::vector<int> padre(n, -1);
-    std::vector<bool> visitado(n, false);
+    EspacioBusqueda esp;
+    buscarDesde(origen, std::vector<int>(1, destino), esp);
+    return reconstruirCamino(esp, destino, costoTotal);
+}
+
+void Grafo::buscarDesde(int origen, const std::vector<int>& destinos, EspacioBusqueda& esp) const {
+    MEDIR_FASE("grafo.busqueda");
+    int n = numNodos;
+    esp.preparar(n);
+    
+    std::vector<double>& dist = esp.dist;
+    std::vector<int>& padre = esp.padre;
+    std::vector<char>& visitado = esp.visitado;
+    std::vector<char>& esDestino = esp.esDestino;
+    
+    // Destinos aún no liquidados; sin destinos se recorre el grafo completo
+    int restantes = 0;
+    for (int d : destinos) {
+        if (!esDestino[d]) {
+            esDestino[d] = 1;
+            restantes++;
+        }
+    }
     
     dist[origen] = 0;
     
-    auto cmp = [&](int a, int b) { return dist[a] > dist[b]; };
-    std::priority_queue<int, std::vector<int>, decltype(cmp)> pq(cmp);
-    pq.push(origen);
+    // Montículo sobre el buffer del espacio, con las mismas entradas
+    // (distancia, nodo) que distanciasDesde
+    typedef std::pair<double, int> Entrada;
+    std::greater<Entrada> cmp;
+    std::vector<Entrada>& pq = esp.monton;
+    pq.push_back(Entrada(0.0, origen));
     
     while (!pq.empty()) {
-        int u = pq.top();
-        pq.pop();
+        std::pop_heap(pq.begin(), pq.end(), cmp);
+        int u = pq.back().second;
+        pq.pop_back();
         
         if (visitado[u]) continue;
         visitado[u] = true;
         
-        if (u == destino) break;
+        if (restantes > 0 && esDestino[u] && --restantes == 0) break;
         
-        for (const Arista& arista : adyacencias[u]) {
-            int v = arista.destino;
-            double peso = arista.peso;
+        for (int a = inicioAristas[u]; a < inicioAristas[u + 1]; a++) {
+            int v = aristas[a].destino;
+            double peso = aristas[a].peso;
             
             if (dist[u] + peso < dist[v]) {
                 dist[v] = dist[u] + peso;
                 padre[v] = u;
-                pq.push(v);
+                pq.push_back(Entrada(dist[v], v));
+                std::push_heap(pq.begin(), pq.end(), cmp);
             }
         }
     }
-    
+}
+
+std::vector<Nodo> Grafo::reconstruirCamino(const EspacioBusqueda& esp, int destino, double& costoTotal) const {
+    MEDIR_FASE("grafo.ruta");
     std::vector<Nodo> camino;
-    if (dist[destino] == std::numeric_limits<double>::infinity()) {
+    if (esp.dist[destino] == std::numeric_limits<double>::infinity()) {
         costoTotal = -1;
         return camino;
     }
     
-    costoTotal = dist[destino];
+    costoTotal = esp.dist[destino];
     int actual = destino;
     while (actual != -1) {
         camino.push_back(nodos[actual]);
-        actual = padre[actual];
+        actual = esp.padre[actual];
     }
     
     std::reverse(camino.begin(), camino.end());
     return camino;
 }
 
-int Grafo::obtenerIndice(int fila, int col) const {
-    auto it = posicionAIndice.find({fila, col});
-    if (it != posicionAIndice.end()) {
-        return it->second;
+int Grafo::baseRemota(int origen, const std::vector<double>& dist) const {
+    double maxCosto = -1;
+    int mejor = -1;
+    char base = nodos[origen].base;
+    
+    for (int i = 0; i < numNodos; i++) {
+        if (i == origen || nodos[i].base != base) continue;
+        if (dist[i] == std::numeric_limits<double>::infinity()) continue;
+        if (dist[i] > maxCosto) {
+            maxCosto = dist[i];
+            mejor = i;
+        }
     }
-    return -1;
+    return mejor;
+}
+
+int Grafo::obtenerIndice(int fila, int col) const {
+    if (fila < 0 || col < 0 || col >= columnas) return -1;
+    long long pos = (long long)fila * columnas + col;
+    return pos < numNodos ? (int)pos : -1;
 }
 
 std::vector<int> Grafo::encontrarBasesIguales(char base) const {
     std::vector<int> indices;
-    for (int i = 0; i < (int)nodos.size(); i++) {
+    for (int i = 0; i < numNodos; i++) {
         if (nodos[i].base == base) {
             indices.push_back(i);
         }
@@ -130,4 +336,211 @@ std::vector<int> Grafo::encontrarBasesIguales(char base) const {
 
 Nodo Grafo::obtenerNodo(int indice) const {
     return nodos[indice];
+}
+
+int Grafo::obtenerNumNodos() const {
+    return numNodos;
+}
+
+size_t Grafo::memoriaUsada() const {
+    // Las páginas mapeadas las comparte y descarta el núcleo
+    size_t bytes = sizeof(Grafo);
+    bytes += nodosPropios.capacity() * sizeof(Nodo);
+    bytes += inicioPropio.capacity() * sizeof(int);
+    bytes += aristasPropias.capacity() * sizeof(Arista);
+    return bytes;
+}
+
+int Grafo::obtenerNumAristas() const { return numAristas; }
+int Grafo::obtenerFilas() const { return filas; }
+int Grafo::obtenerColumnas() const { return columnas; }
+const Nodo* Grafo::obtenerNodos() const { return nodos; }
+const int* Grafo::obtenerInicioAristas() const { return inicioAristas; }
+const Arista* Grafo::obtenerAristas() const { return aristas; }
+
+void Grafo::adoptar(const Secuencia& sec, const Nodo* nodosExternos, const int* inicioExterno,
+                    const Arista* aristasExternas, int numAristasExternas,
+                    std::shared_ptr<const void> mapeoExterno) {
+    nodosPropios.clear();
+    inicioPropio.clear();
+    aristasPropias.clear();
+    nodosPropios.shrink_to_fit();
+    inicioPropio.shrink_to_fit();
+    aristasPropias.shrink_to_fit();
+    
+    nodos = nodosExternos;
+    inicioAristas = inicioExterno;
+    aristas = aristasExternas;
+    numNodos = sec.obtenerNumBases();
+    numAristas = numAristasExternas;
+    mapeo = mapeoExterno;
+    
+    filas = sec.obtenerFilas();
+    columnas = sec.obtenerColumnas();
+    numBases = sec.obtenerNumBases();
+    identidadSecuencia = sec.obtenerIdentidad();
+    versionSecuencia = sec.obtenerVersion();
+}
+
+std::vector<double> Grafo::distanciasDesde(int origen) const {
+    MEDIR_FASE("grafo.sssp");
+    int n = numNodos;
+    std::vector<double> dist(n, std::numeric_limits<double>::infinity());
+    std::vector<bool> visitado(n, false);
+    if (origen < 0 || origen >= n) return dist;
+    
+    dist[origen] = 0;
+    
+    typedef std::pair<double, int> Entrada;
+    std::priority_queue<Entrada, std::vector<Entrada>, std::greater<Entrada>> pq;
+    pq.push(Entrada(0.0, origen));
+    
+    while (!pq.empty()) {
+        int u = pq.top().second;
+        pq.pop();
+        
+        if (visitado[u]) continue;
+        visitado[u] = true;
+        
+        for (int a = inicioAristas[u]; a < inicioAristas[u + 1]; a++) {
+            const Arista& arista = aristas[a];
+            double nd = dist[u] + arista.peso;
+            if (nd < dist[arista.destino]) {
+                dist[arista.destino] = nd;
+                pq.push(Entrada(nd, arista.destino));
+            }
+        }
+    }
+    
+    return dist;
+}
+
+// Delta-stepping síncrono por fases. Cada fase tiene dos pasos separados
+// por barreras: (1) cada hilo genera relajaciones para su tramo de la
+// frontera, repartidas por dueño (nodo % numHilos); (2) cada hilo aplica
+// solo las relajaciones de los nodos que le pertenecen. Así dist nunca se
+// escribe mientras otro hilo la lee, y el resultado es el mismo punto fijo
+// min(dist[u] + peso) que calcula Dijkstra.
+std::vector<double> Grafo::distanciasDeltaStepping(int origen, int numHilos, double delta) const {
+    MEDIR_FASE("grafo.delta_stepping");
+    int n = numNodos;
+    const double INF = std::numeric_limits<double>::infinity();
+    std::vector<double> dist(n, INF);
+    if (origen < 0 || origen >= n) return dist;
+    if (numHilos < 1) numHilos = 1;
+    if (!(delta > 0)) delta = 1.0;
+    
+    dist[origen] = 0;
+    
+    std::map<long long, std::vector<int>> cubetas;
+    cubetas[0].push_back(origen);
+    auto cubetaDe = [&](double d) { return (long long)std::floor(d / delta); };
+    
+    // buzones[emisor][dueño]
+    std::vector<std::vector<std::vector<Relajacion>>> buzones(
+        numHilos, std::vector<std::vector<Relajacion>>(numHilos));
+    std::vector<std::vector<int>> mejorados(numHilos);
+    
+    std::vector<int> frontera;
+    std::vector<int> liquidados;       // R: nodos de la cubeta actual
+    std::vector<int> marca(n, -1);     // evita duplicados en la frontera
+    int faseActual = 0;
+    long long cubetaActual = -1;
+    bool ligera = true;
+    bool terminar = false;
+    
+    // Solo el hilo 0 la ejecuta, entre barreras
+    auto preparar = [&]() {
+        for (int t = 0; t < numHilos; t++) {
+            for (int v : mejorados[t]) {
+                cubetas[cubetaDe(dist[v])].push_back(v);
+            }
+            mejorados[t].clear();
+        }
+        frontera.clear();
+        
+        while (true) {
+            auto it = cubetas.find(cubetaActual);
+            if (it != cubetas.end()) {
+                std::vector<int> pendientes;
+                pendientes.swap(it->second);
+                cubetas.erase(it);
+                faseActual++;
+                for (int v : pendientes) {
+                    if (cubetaDe(dist[v]) != cubetaActual || marca[v] == faseActual) continue;
+                    marca[v] = faseActual;
+                    frontera.push_back(v);
+                    liquidados.push_back(v);
+                }
+                if (!frontera.empty()) {
+                    ligera = true;
+                    return;
+                }
+                continue;
+            }
+            
+            if (!liquidados.empty()) {
+                std::sort(liquidados.begin(), liquidados.end());
+                liquidados.erase(std::unique(liquidados.begin(), liquidados.end()), liquidados.end());
+                frontera.swap(liquidados);
+                liquidados.clear();
+                ligera = false;
+                return;
+            }
+            
+            if (cubetas.empty()) {
+                terminar = true;
+                return;
+            }
+            cubetaActual = cubetas.begin()->first;
+        }
+    };
+    
+    BarreraHilos barrera(numHilos);
+    
+    auto trabajador = [&](int t) {
+        while (true) {
+            if (t == 0) preparar();
+            barrera.esperar();
+            if (terminar) return;
+            
+            // Generar relajaciones del tramo t de la frontera
+            int total = frontera.size();
+            int inicio = (long long)total * t / numHilos;
+            int fin = (long long)total * (t + 1) / numHilos;
+            for (int k = inicio; k < fin; k++) {
+                int u = frontera[k];
+                for (int a = inicioAristas[u]; a < inicioAristas[u + 1]; a++) {
+                    const Arista& arista = aristas[a];
+                    if ((arista.peso <= delta) != ligera) continue;
+                    double nd = dist[u] + arista.peso;
+                    if (nd < dist[arista.destino]) {
+                        buzones[t][arista.destino % numHilos].push_back(Relajacion(arista.destino, nd));
+                    }
+                }
+            }
+            barrera.esperar();
+            
+            // Aplicar las relajaciones de los nodos propios
+            for (int emisor = 0; emisor < numHilos; emisor++) {
+                for (const Relajacion& r : buzones[emisor][t]) {
+                    if (r.dist < dist[r.nodo]) {
+                        dist[r.nodo] = r.dist;
+                        mejorados[t].push_back(r.nodo);
+                    }
+                }
+                buzones[emisor][t].clear();
+            }
+            barrera.esperar();
+        }
+    };
+    
+    std::vector<std::thread> hilos;
+    for (int t = 1; t < numHilos; t++) {
+        hilos.push_back(std::thread(trabajador, t));
+    }
+    trabajador(0);
+    for (auto& h : hilos) h.join();
+    
+    return dist;
 }
\ No newline at end of file
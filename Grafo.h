@@ -9,6 +9,8 @@
 #include <map>
 #include <utility>
 #include <limits>
+#include <memory>
+#include <cstddef>
 
 struct Nodo {
     int fila, col;
@@ -22,20 +24,87 @@ struct Arista {
     Arista(int d, double p) : destino(d), peso(p) {}
 };
 
+// Buffers de trabajo de una búsqueda. Cada hilo usa el suyo, de modo que
+// varias búsquedas pueden correr a la vez sobre el mismo Grafo (const).
+struct EspacioBusqueda {
+    std::vector<double> dist;
+    std::vector<int> padre;
+    std::vector<char> visitado;
+    std::vector<char> esDestino;
+    // Pares (distancia al encolar, nodo): la clave no cambia mientras el
+    // par está en el montículo
+    std::vector<std::pair<double, int>> monton;
+    
+    void preparar(int n);
+};
+
+// Los nodos siguen el orden lineal de la secuencia (índice = fila * columnas
+// + col) y las aristas se guardan en formato CSR: las del nodo u ocupan
+// aristas[inicioAristas[u] .. inicioAristas[u + 1]). Los arreglos pueden ser
+// propios o vivir en memoria mapeada (sesión); en ese caso se copian a los
+// vectores propios la primera vez que hay que parchearlos.
 class Grafo {
 private:
-    std::vector<Nodo> nodos;
-    std::vector<std::vector<Arista>> adyacencias;
-    std::map<std::pair<int,int>, int> posicionAIndice;
+    std::vector<Nodo> nodosPropios;
+    std::vector<int> inicioPropio;
+    std::vector<Arista> aristasPropias;
+    
+    const Nodo* nodos;
+    const int* inicioAristas;
+    const Arista* aristas;
+    int numNodos, numAristas;
+    std::shared_ptr<const void> mapeo;
+    
+    // Secuencia (identidad y versión) y dimensiones con las que está sincronizado
+    uint64_t identidadSecuencia;
+    uint64_t versionSecuencia;
+    int filas, columnas, numBases;
     
     double calcularPeso(char base1, char base2);
+    template <typename A> void crearAristas(const Secuencia& sec);
+    void parchearCelda(int indice, char base);
+    void apuntarPropios();
+    void materializar();
 
 public:
+    Grafo();
+    Grafo(const Grafo& otro);
+    Grafo& operator=(const Grafo& otro);
+    
     void construir(const Secuencia& sec);
+    // Lleva el grafo a la versión actual de sec parcheando solo los pesos de
+    // las celdas cambiadas. Devuelve false (sin tocar el grafo) si sec tiene
+    // otras dimensiones y hace falta reconstruir.
+    bool sincronizar(const Secuencia& sec, int& celdasParcheadas);
     std::vector<Nodo> dijkstra(int origen, int destino, double& costoTotal);
+    // Dijkstra desde origen hasta liquidar todos los destinos (todos si está vacío)
+    void buscarDesde(int origen, const std::vector<int>& destinos, EspacioBusqueda& esp) const;
+    std::vector<Nodo> reconstruirCamino(const EspacioBusqueda& esp, int destino, double& costoTotal) const;
+    // Nodo alcanzable más lejano con la misma base que origen (-1 si no hay)
+    int baseRemota(int origen, const std::vector<double>& dist) const;
     int obtenerIndice(int fila, int col) const;
     std::vector<int> encontrarBasesIguales(char base) const;
     Nodo obtenerNodo(int indice) const;
+    int obtenerNumNodos() const;
+    // Bytes propios de nodos y aristas; las páginas mapeadas no cuentan
+    size_t memoriaUsada() const;
+    
+    // Arreglos crudos para volcarlos a una sesión
+    int obtenerNumAristas() const;
+    int obtenerFilas() const;
+    int obtenerColumnas() const;
+    const Nodo* obtenerNodos() const;
+    const int* obtenerInicioAristas() const;
+    const Arista* obtenerAristas() const;
+    // Usa arreglos ya construidos (p. ej. mapeados) sin copiarlos. El grafo
+    // queda sincronizado con la versión actual de sec.
+    void adoptar(const Secuencia& sec, const Nodo* nodos, const int* inicioAristas,
+                 const Arista* aristas, int numAristas, std::shared_ptr<const void> mapeo);
+    
+    // Distancias desde origen a todos los nodos (Dijkstra sin parada temprana)
+    std::vector<double> distanciasDesde(int origen) const;
+    // Delta-stepping paralelo: mismas distancias que distanciasDesde
+    std::vector<double> distanciasDeltaStepping(int origen, int numHilos, double delta) const;
 };
 
 #endif
\ No newline at end of file
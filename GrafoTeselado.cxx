@@ -0,0 +1,414 @@
+// ============================================
+// ARCHIVO: GrafoTeselado.cxx
+// ============================================
+#include "GrafoTeselado.h"
+#include "Alfabeto.h"
+#include "Compresion.h"
+#include "Instrumentacion.h"
+#include <zlib.h>
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <limits>
+#include <queue>
+#include <sstream>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+// Registro de un índice .fai: nombre, bases, desplazamiento de la primera
+// base, bases por línea y bytes por línea
+struct RegistroIndice {
+    std::string nombre;
+    uint64_t numBases, desplazamiento;
+    int ancho, bytesLinea;
+    bool uniforme;      // todas las líneas de 'ancho' bases salvo la última
+};
+
+// Los .fai nombran cada registro por la primera palabra de su descripción
+static std::string primeraPalabra(const std::string& descripcion) {
+    return descripcion.substr(0, descripcion.find_first_of(" \t"));
+}
+
+// Recorre el FASTA (plano o gzip) por trozos sin guardar las bases. Con
+// 'copia' escribe en ella las bases de cada registro sin saltos de línea y
+// los desplazamientos quedan referidos a la copia.
+static bool indexarFASTA(const std::string& archivo, std::vector<RegistroIndice>& registros, std::ofstream* copia) {
+    MEDIR_FASE("teselas.indexado");
+    gzFile gz = gzopen(archivo.c_str(), "rb");
+    if (!gz) return false;
+    gzbuffer(gz, 1 << 20);
+
+    std::vector<char> trozo(1 << 16), bases(1 << 16);
+    uint64_t posicion = 0, posicionCopia = 0, inicioLinea = 0, basesLinea = 0, basesInicioLinea = 0;
+    bool lineaNueva = true, cabecera = false, cerrado = false;
+
+    auto terminarLinea = [&](uint64_t bytes) {
+        if (cabecera) {
+            registros.back().nombre = primeraPalabra(registros.back().nombre);
+            return;
+        }
+        if (registros.empty()) return;
+        RegistroIndice& r = registros.back();
+        if (basesLinea == 0) {
+            cerrado = cerrado || r.numBases > 0;
+        } else if (r.ancho == 0) {
+            r.ancho = basesLinea;
+            r.bytesLinea = bytes;
+            r.desplazamiento = copia ? basesInicioLinea : inicioLinea;
+        } else if (cerrado || basesLinea > (uint64_t)r.ancho) {
+            r.uniforme = false;
+        } else if (basesLinea != (uint64_t)r.ancho || bytes != (uint64_t)r.bytesLinea) {
+            cerrado = true;
+        }
+        r.numBases += basesLinea;
+    };
+
+    while (gzgets(gz, trozo.data(), trozo.size())) {
+        size_t n = strlen(trozo.data());
+        if (n == 0) break;
+        if (lineaNueva) {
+            inicioLinea = posicion;
+            basesInicioLinea = posicionCopia;
+            basesLinea = 0;
+            cabecera = trozo[0] == '>';
+            if (cabecera) {
+                RegistroIndice r;
+                r.numBases = r.desplazamiento = 0;
+                r.ancho = r.bytesLinea = 0;
+                r.uniforme = true;
+                registros.push_back(r);
+                cerrado = false;
+            }
+        }
+        posicion += n;
+        bool finLinea = trozo[n - 1] == '\n';
+
+        if (cabecera) {
+            size_t largo = n;
+            while (largo > 0 && (trozo[largo - 1] == '\n' || trozo[largo - 1] == '\r')) largo--;
+            registros.back().nombre.append(trozo.data() + (lineaNueva ? 1 : 0),
+                                           largo - std::min(largo, (size_t)(lineaNueva ? 1 : 0)));
+        } else {
+            size_t largo = 0;
+            for (size_t k = 0; k < n; k++) {
+                if (trozo[k] != '\n' && trozo[k] != '\r') bases[largo++] = trozo[k];
+            }
+            basesLinea += largo;
+            if (copia && !registros.empty()) {
+                copia->write(bases.data(), largo);
+                posicionCopia += largo;
+            }
+        }
+
+        lineaNueva = finLinea;
+        if (finLinea) terminarLinea(posicion - inicioLinea);
+    }
+    if (!lineaNueva) terminarLinea(posicion - inicioLinea);
+
+    bool correcto = gzeof(gz) != 0;
+    gzclose(gz);
+    if (copia) {
+        for (auto& r : registros) {
+            r.bytesLinea = r.ancho;
+            r.uniforme = true;
+        }
+    }
+    return correcto;
+}
+
+static bool leerIndice(const std::string& archivo, std::vector<RegistroIndice>& registros) {
+    std::ifstream in(archivo.c_str());
+    if (!in.is_open()) return false;
+    std::string linea;
+    while (std::getline(in, linea)) {
+        std::istringstream iss(linea);
+        RegistroIndice r;
+        if (!std::getline(iss, r.nombre, '\t') ||
+            !(iss >> r.numBases >> r.desplazamiento >> r.ancho >> r.bytesLinea) ||
+            r.ancho < 0 || r.bytesLinea < r.ancho) {
+            return false;
+        }
+        r.uniforme = true;
+        registros.push_back(r);
+    }
+    return true;
+}
+
+static bool escribirIndice(const std::string& archivo, const std::vector<RegistroIndice>& registros) {
+    std::ofstream out(archivo.c_str());
+    if (!out.is_open()) return false;
+    for (const auto& r : registros) {
+        out << r.nombre << '\t' << r.numBases << '\t' << r.desplazamiento << '\t'
+            << r.ancho << '\t' << r.bytesLinea << '\n';
+    }
+    out.close();
+    return (bool)out;
+}
+
+// true si 'archivo' existe y no es más viejo que 'fuente'
+static bool alDia(const std::string& archivo, const struct stat& fuente) {
+    struct stat info;
+    return stat(archivo.c_str(), &info) == 0 && info.st_mtime >= fuente.st_mtime;
+}
+
+bool GrafoTeselado::ubicar(const std::string& archivo, const std::string& nombre,
+                           OrigenTeselas& origen, std::string& error) {
+    struct stat info;
+    if (stat(archivo.c_str(), &info) != 0) {
+        error = archivo + " no se encuentra o no puede leerse.";
+        return false;
+    }
+
+    std::string copia = archivo + ".empaquetado";
+    std::string fuente;
+    std::vector<RegistroIndice> registros;
+    // Un .fai junto a un gzip (el de samtools para bgzip) describe bytes
+    // sin comprimir que pread no puede leer: esos se leen de la copia
+    bool comprimido = Compresion::esGzip(archivo);
+    if (!comprimido && alDia(archivo + ".fai", info) && leerIndice(archivo + ".fai", registros)) {
+        fuente = archivo;
+    } else if (registros.clear(), alDia(copia, info) && alDia(copia + ".fai", info) &&
+               leerIndice(copia + ".fai", registros)) {
+        fuente = copia;
+    } else {
+        registros.clear();
+        bool directo = !comprimido;
+        if (directo) {
+            if (!indexarFASTA(archivo, registros, nullptr)) {
+                error = "No se puede leer " + archivo + ".";
+                return false;
+            }
+            for (const auto& r : registros) directo = directo && r.uniforme;
+        }
+        if (directo) {
+            // Sin permiso de escritura el índice solo dura esta consulta
+            escribirIndice(archivo + ".fai", registros);
+            fuente = archivo;
+        } else {
+            registros.clear();
+            std::ofstream out(copia.c_str(), std::ios::binary | std::ios::trunc);
+            bool correcto = out.is_open() && indexarFASTA(archivo, registros, &out);
+            out.close();
+            if (!correcto || !out || !escribirIndice(copia + ".fai", registros)) {
+                error = "No se puede crear la copia empaquetada " + copia + ".";
+                return false;
+            }
+            fuente = copia;
+        }
+    }
+
+    std::string buscado = primeraPalabra(nombre);
+    for (const auto& r : registros) {
+        if (r.nombre != buscado) continue;
+        if (r.ancho == 0) {
+            error = "La secuencia " + nombre + " está vacía.";
+            return false;
+        }
+        origen.archivo = fuente;
+        origen.nombre = r.nombre;
+        origen.desplazamiento = r.desplazamiento;
+        origen.numBases = r.numBases;
+        origen.ancho = r.ancho;
+        origen.bytesLinea = r.bytesLinea;
+        return true;
+    }
+    error = "La secuencia " + nombre + " no existe en " + archivo + ".";
+    return false;
+}
+
+CacheTeselas::CacheTeselas(const OrigenTeselas& o, int filas, size_t bytesMaximos)
+    : origen(o), filasPorTesela(filas), ultima(-1), basesUltima(nullptr),
+      aciertos(0), fallos(0), desalojos(0), bytesLeidos(0), errorLectura(false) {
+    fd = open(origen.archivo.c_str(), O_RDONLY);
+    size_t bytesTesela = (size_t)filasPorTesela * origen.ancho;
+    maxTeselas = std::max((size_t)2, bytesMaximos / std::max((size_t)1, bytesTesela));
+}
+
+CacheTeselas::~CacheTeselas() {
+    if (fd >= 0) close(fd);
+}
+
+// pread hasta completar o fallar
+static bool leerCompleto(int fd, char* destino, size_t bytes, uint64_t desplazamiento) {
+    while (bytes > 0) {
+        ssize_t leidos = pread(fd, destino, bytes, desplazamiento);
+        if (leidos <= 0) return false;
+        destino += leidos;
+        bytes -= leidos;
+        desplazamiento += leidos;
+    }
+    return true;
+}
+
+const char* CacheTeselas::cargar(int64_t t) {
+    auto it = teselas.find(t);
+    if (it != teselas.end()) {
+        aciertos++;
+        ordenLRU.splice(ordenLRU.begin(), ordenLRU, it->second.posicionLRU);
+        return it->second.bases.data();
+    }
+
+    MEDIR_FASE("teselas.lectura");
+    fallos++;
+    while (teselas.size() >= maxTeselas) {
+        teselas.erase(ordenLRU.back());
+        ordenLRU.pop_back();
+        desalojos++;
+    }
+
+    uint64_t basesPorTesela = (uint64_t)filasPorTesela * origen.ancho;
+    uint64_t primera = (uint64_t)t * basesPorTesela;
+    uint64_t n = std::min(basesPorTesela, origen.numBases - primera);
+    uint64_t filas = (n + origen.ancho - 1) / origen.ancho;
+    uint64_t desde = origen.desplazamiento + (uint64_t)t * filasPorTesela * origen.bytesLinea;
+
+    Tesela& tesela = teselas[t];
+    tesela.bases.resize(n);
+    bool correcto;
+    uint64_t bytes;
+    if (origen.bytesLinea == origen.ancho) {
+        bytes = n;
+        correcto = leerCompleto(fd, tesela.bases.data(), n, desde);
+    } else {
+        // Filas completas con su salto de línea y la última sin él
+        bytes = (filas - 1) * origen.bytesLinea + (n - (filas - 1) * origen.ancho);
+        std::vector<char> crudo(bytes);
+        correcto = leerCompleto(fd, crudo.data(), bytes, desde);
+        for (uint64_t f = 0; correcto && f < filas; f++) {
+            uint64_t largo = std::min((uint64_t)origen.ancho, n - f * origen.ancho);
+            memcpy(tesela.bases.data() + f * origen.ancho, crudo.data() + f * origen.bytesLinea, largo);
+        }
+    }
+    BYTES_FASE(bytes);
+    if (!correcto) {
+        teselas.erase(t);
+        errorLectura = true;
+        return nullptr;
+    }
+    bytesLeidos += bytes;
+    ordenLRU.push_front(t);
+    tesela.posicionLRU = ordenLRU.begin();
+    return tesela.bases.data();
+}
+
+char CacheTeselas::base(uint64_t pos) {
+    uint64_t basesPorTesela = (uint64_t)filasPorTesela * origen.ancho;
+    int64_t t = pos / basesPorTesela;
+    if (t != ultima || !basesUltima) {
+        basesUltima = cargar(t);
+        ultima = t;
+    }
+    return basesUltima ? basesUltima[pos - t * basesPorTesela] : '\0';
+}
+
+GrafoTeselado::GrafoTeselado(const OrigenTeselas& o, int filas, size_t bytesCache)
+    : origen(o), cache(o, filas, bytesCache), filasPorTesela(filas),
+      filas((o.numBases + o.ancho - 1) / o.ancho) {}
+
+bool GrafoTeselado::posicionValida(int64_t fila, int64_t col) const {
+    return fila >= 0 && col >= 0 && col < origen.ancho && (uint64_t)(fila * origen.ancho + col) < origen.numBases;
+}
+
+static const uint8_t SIN_PADRE = 4;
+static const uint8_t LIQUIDADO = 0x80;
+
+bool GrafoTeselado::rutaMasCorta(int64_t fila1, int64_t col1, int64_t fila2, int64_t col2,
+                                 std::vector<Nodo>& camino, double& costoTotal, EstadisticasTeselas& est,
+                                 std::string& error) {
+    MEDIR_FASE("teselas.busqueda");
+    camino.clear();
+    if (!cache.abierta()) {
+        error = "No se puede abrir " + origen.archivo + ".";
+        return false;
+    }
+    long aciertosAntes = cache.obtenerAciertos(), fallosAntes = cache.obtenerFallos();
+    long desalojosAntes = cache.obtenerDesalojos();
+    uint64_t bytesAntes = cache.obtenerBytesLeidos();
+
+    const int64_t ancho = origen.ancho;
+    const int64_t n = origen.numBases;
+    const int64_t basesPorTesela = (int64_t)filasPorTesela * ancho;
+    const double infinito = std::numeric_limits<double>::infinity();
+
+    // Estado por tesela, vacío hasta que la búsqueda la toca. La marca guarda
+    // la dirección hacia el padre (índice en 'paso') y si está liquidado.
+    int64_t numTeselas = (filas + filasPorTesela - 1) / filasPorTesela;
+    std::vector<std::vector<double>> dist(numTeselas);
+    std::vector<std::vector<uint8_t>> marca(numTeselas);
+    est.teselasExploradas = 0;
+    est.bytesEstado = 0;
+    est.nodosLiquidados = 0;
+    auto reservar = [&](int64_t t) {
+        if (!dist[t].empty()) return;
+        size_t largo = std::min(basesPorTesela, n - t * basesPorTesela);
+        dist[t].assign(largo, infinito);
+        marca[t].assign(largo, SIN_PADRE);
+        est.teselasExploradas++;
+        est.bytesEstado += largo * (sizeof(double) + 1);
+    };
+
+    const int64_t paso[4] = {-ancho, ancho, -1, 1};
+    int64_t origenPos = fila1 * ancho + col1, destinoPos = fila2 * ancho + col2;
+    typedef std::pair<double, int64_t> Entrada;
+    std::priority_queue<Entrada, std::vector<Entrada>, std::greater<Entrada>> cola;
+
+    reservar(origenPos / basesPorTesela);
+    dist[origenPos / basesPorTesela][origenPos % basesPorTesela] = 0;
+    cola.push(Entrada(0, origenPos));
+
+    while (!cola.empty()) {
+        Entrada e = cola.top();
+        cola.pop();
+        int64_t u = e.second;
+        uint8_t& marcaU = marca[u / basesPorTesela][u % basesPorTesela];
+        if (marcaU & LIQUIDADO) continue;
+        marcaU |= LIQUIDADO;
+        est.nodosLiquidados++;
+        if (u == destinoPos) break;
+
+        char baseU = cache.base(u);
+        int64_t col = u % ancho;
+        bool existe[4] = {u >= ancho, u + ancho < n, col > 0, col + 1 < ancho && u + 1 < n};
+        for (int d = 0; d < 4; d++) {
+            if (!existe[d]) continue;
+            int64_t v = u + paso[d];
+            int64_t t = v / basesPorTesela, k = v % basesPorTesela;
+            reservar(t);
+            if (marca[t][k] & LIQUIDADO) continue;
+            double nueva = e.first + PesosAlfabeto<AlfabetoBytes>::peso(baseU, cache.base(v));
+            if (nueva < dist[t][k]) {
+                dist[t][k] = nueva;
+                marca[t][k] = d;
+                cola.push(Entrada(nueva, v));
+            }
+        }
+        if (cache.huboError()) break;
+    }
+
+    double final = dist[destinoPos / basesPorTesela].empty()
+                       ? infinito : dist[destinoPos / basesPorTesela][destinoPos % basesPorTesela];
+    costoTotal = final == infinito ? -1 : final;
+    if (final != infinito) {
+        for (int64_t v = destinoPos;;) {
+            camino.push_back(Nodo(v / ancho, v % ancho, cache.base(v)));
+            uint8_t d = marca[v / basesPorTesela][v % basesPorTesela] & ~LIQUIDADO;
+            if (d == SIN_PADRE) break;
+            v -= paso[d];
+        }
+        std::reverse(camino.begin(), camino.end());
+    }
+    if (cache.huboError()) {
+        error = "No se pudo leer " + origen.archivo + "; puede haber cambiado desde que se indexó.";
+        camino.clear();
+        return false;
+    }
+
+    est.aciertos = cache.obtenerAciertos() - aciertosAntes;
+    est.fallos = cache.obtenerFallos() - fallosAntes;
+    est.desalojos = cache.obtenerDesalojos() - desalojosAntes;
+    est.bytesLeidos = cache.obtenerBytesLeidos() - bytesAntes;
+    BYTES_FASE(est.bytesLeidos);
+    return true;
+}
@@ -0,0 +1,114 @@
+// ============================================
+// ARCHIVO: GrafoTeselado.h
+// ============================================
+#ifndef GRAFOTESELADO_H
+#define GRAFOTESELADO_H
+
+#include "Grafo.h"
+#include <cstdint>
+#include <list>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Dónde leer las filas de un registro sin cargarlo: la fila f empieza en
+// desplazamiento + f * bytesLinea y tiene 'ancho' bases (la última puede
+// tener menos). Sirve tanto para un FASTA con líneas de igual largo como
+// para la copia empaquetada (solo bases, bytesLinea == ancho).
+struct OrigenTeselas {
+    std::string archivo;
+    std::string nombre;
+    uint64_t desplazamiento;
+    uint64_t numBases;
+    int ancho;
+    int bytesLinea;
+};
+
+// Caché acotada de teselas (bloques de filas consecutivas) leídas del
+// disco, con desalojo LRU. Aciertos y fallos se cuentan al pasar a una
+// tesela distinta de la anterior, no en cada base.
+class CacheTeselas {
+private:
+    struct Tesela {
+        std::vector<char> bases;
+        std::list<int64_t>::iterator posicionLRU;
+    };
+
+    OrigenTeselas origen;
+    int fd;
+    int filasPorTesela;
+    size_t maxTeselas;
+    std::unordered_map<int64_t, Tesela> teselas;
+    std::list<int64_t> ordenLRU;    // frente = usada más recientemente
+    int64_t ultima;
+    const char* basesUltima;
+    long aciertos, fallos, desalojos;
+    uint64_t bytesLeidos;
+    bool errorLectura;
+
+    const char* cargar(int64_t t);
+
+public:
+    CacheTeselas(const OrigenTeselas& origen, int filasPorTesela, size_t bytesMaximos);
+    ~CacheTeselas();
+
+    bool abierta() const { return fd >= 0; }
+    // Base en la posición lineal pos. Si la lectura falla devuelve '\0' y
+    // huboError() queda en true para el resto de la vida de la caché.
+    char base(uint64_t pos);
+    bool huboError() const { return errorLectura; }
+
+    long obtenerAciertos() const { return aciertos; }
+    long obtenerFallos() const { return fallos; }
+    long obtenerDesalojos() const { return desalojos; }
+    uint64_t obtenerBytesLeidos() const { return bytesLeidos; }
+    size_t obtenerNumTeselas() const { return teselas.size(); }
+    size_t obtenerMaxTeselas() const { return maxTeselas; }
+    int obtenerFilasPorTesela() const { return filasPorTesela; }
+};
+
+// Resumen de una búsqueda por teselas
+struct EstadisticasTeselas {
+    long aciertos, fallos, desalojos;
+    uint64_t bytesLeidos;
+    size_t teselasExploradas;       // teselas con estado de búsqueda
+    size_t bytesEstado;
+    long nodosLiquidados;
+};
+
+// Grafo de rejilla de un registro que no cabe en memoria. No guarda nodos
+// ni aristas: los pesos salen de las bases vecinas, que se piden a la
+// caché de teselas, y el estado de Dijkstra (distancia y dirección del
+// padre) se reserva por tesela solo cuando la frontera llega a ella.
+class GrafoTeselado {
+private:
+    OrigenTeselas origen;
+    CacheTeselas cache;
+    int filasPorTesela;
+    int64_t filas;
+
+public:
+    static const int FILAS_POR_TESELA = 256;
+    static const size_t CACHE_POR_DEFECTO = 64UL * 1024 * 1024;
+
+    // Ubica el registro en el archivo usando su índice .fai, que se crea si
+    // falta o es más viejo que el archivo. Los FASTA comprimidos o con
+    // líneas de distinto largo se leen desde una copia empaquetada
+    // (archivo.empaquetado, con su propio .fai) que se crea la primera vez.
+    static bool ubicar(const std::string& archivo, const std::string& nombre,
+                       OrigenTeselas& origen, std::string& error);
+
+    GrafoTeselado(const OrigenTeselas& origen, int filasPorTesela, size_t bytesCache);
+
+    bool abierto() const { return cache.abierta(); }
+    const OrigenTeselas& obtenerOrigen() const { return origen; }
+    const CacheTeselas& obtenerCache() const { return cache; }
+    bool posicionValida(int64_t fila, int64_t col) const;
+    // Dijkstra con parada al liquidar el destino; camino vacío y costo -1
+    // si no se llega. Devuelve false con 'error' si el archivo no se pudo
+    // abrir o leer, en lugar de seguir con bases inventadas.
+    bool rutaMasCorta(int64_t fila1, int64_t col1, int64_t fila2, int64_t col2, std::vector<Nodo>& camino,
+                      double& costoTotal, EstadisticasTeselas& estadisticas, std::string& error);
+};
+
+#endif
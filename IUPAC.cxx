@@ -0,0 +1,59 @@
+// ============================================
+// ARCHIVO: IUPAC.cxx
+// ============================================
+#include "IUPAC.h"
+#include <cctype>
+
+struct TablasIUPAC {
+    uint8_t codigo[256];
+    char complemento[256];
+    
+    void definir(char base, uint8_t conjunto, char comp) {
+        unsigned char mayus = base, minus = tolower(base);
+        codigo[mayus] = codigo[minus] = conjunto;
+        complemento[mayus] = comp;
+        complemento[minus] = tolower(comp);
+    }
+    
+    TablasIUPAC() {
+        for (int c = 0; c < 256; c++) {
+            codigo[c] = 0;
+            complemento[c] = (char)c;
+        }
+        definir('A', 1, 'T');
+        definir('C', 2, 'G');
+        definir('G', 4, 'C');
+        definir('T', 8, 'A');
+        definir('U', 8, 'A');
+        definir('R', 1 | 4, 'Y');
+        definir('Y', 2 | 8, 'R');
+        definir('S', 2 | 4, 'S');
+        definir('W', 1 | 8, 'W');
+        definir('K', 4 | 8, 'M');
+        definir('M', 1 | 2, 'K');
+        definir('B', 2 | 4 | 8, 'V');
+        definir('D', 1 | 4 | 8, 'H');
+        definir('H', 1 | 2 | 8, 'D');
+        definir('V', 1 | 2 | 4, 'B');
+        definir('N', 1 | 2 | 4 | 8, 'N');
+    }
+};
+static const TablasIUPAC TABLAS;
+
+uint8_t IUPAC::codigo(char base) {
+    return TABLAS.codigo[(unsigned char)base];
+}
+
+char IUPAC::complemento(char base) {
+    return TABLAS.complemento[(unsigned char)base];
+}
+
+std::string IUPAC::complementoReverso(const std::string& secuencia) {
+    std::string resultado(secuencia.rbegin(), secuencia.rend());
+    for (char& c : resultado) c = complemento(c);
+    return resultado;
+}
+
+bool IUPAC::compatibles(char a, char b) {
+    return (codigo(a) & codigo(b)) != 0;
+}
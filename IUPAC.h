@@ -0,0 +1,22 @@
+// ============================================
+// ARCHIVO: IUPAC.h
+// ============================================
+#ifndef IUPAC_H
+#define IUPAC_H
+
+#include <cstdint>
+#include <string>
+
+// Códigos IUPAC como conjuntos de 4 bits (A=1, C=2, G=4, T=8): R = A|G,
+// N = A|C|G|T, etc. Dos bases son compatibles si sus conjuntos se cortan.
+// X, '-' y cualquier otro carácter tienen el conjunto vacío y no son
+// compatibles con nada. Mayúsculas y minúsculas valen lo mismo; U es T.
+class IUPAC {
+public:
+    static uint8_t codigo(char base);
+    static char complemento(char base);
+    static std::string complementoReverso(const std::string& secuencia);
+    static bool compatibles(char a, char b);
+};
+
+#endif
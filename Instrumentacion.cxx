@@ -0,0 +1,108 @@
+// ============================================
+// ARCHIVO: Instrumentacion.cxx
+// ============================================
+#include "Instrumentacion.h"
+
+#ifdef GENOMAS_INSTRUMENTACION
+
+#include <cstdlib>
+#include <iomanip>
+#include <map>
+#include <mutex>
+#include <new>
+
+static std::atomic<uint64_t> totalAsignaciones(0);
+static std::atomic<uint64_t> totalBytesAsignados(0);
+static std::atomic<uint64_t> totalLiberaciones(0);
+static thread_local uint64_t asignacionesHilo = 0;
+
+// Reemplazo global de new/delete: solo cuenta y delega en malloc/free
+void* operator new(std::size_t n) {
+    asignacionesHilo++;
+    totalAsignaciones.fetch_add(1, std::memory_order_relaxed);
+    totalBytesAsignados.fetch_add(n, std::memory_order_relaxed);
+    void* p = std::malloc(n ? n : 1);
+    if (!p) throw std::bad_alloc();
+    return p;
+}
+
+void* operator new[](std::size_t n) {
+    return operator new(n);
+}
+
+void operator delete(void* p) noexcept {
+    if (!p) return;
+    totalLiberaciones.fetch_add(1, std::memory_order_relaxed);
+    std::free(p);
+}
+
+void operator delete[](void* p) noexcept {
+    operator delete(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept {
+    operator delete(p);
+}
+
+void operator delete[](void* p, std::size_t) noexcept {
+    operator delete(p);
+}
+
+// Las fases nunca se destruyen: las referencias estáticas de MEDIR_FASE
+// deben seguir siendo válidas hasta el final del programa
+static std::mutex& mutexRegistro() {
+    static std::mutex mtx;
+    return mtx;
+}
+
+static std::map<std::string, FaseInstrumentada*>& registro() {
+    static std::map<std::string, FaseInstrumentada*>* fases = new std::map<std::string, FaseInstrumentada*>();
+    return *fases;
+}
+
+FaseInstrumentada& Instrumentacion::registrar(const std::string& nombre) {
+    std::lock_guard<std::mutex> lock(mutexRegistro());
+    FaseInstrumentada*& fase = registro()[nombre];
+    if (!fase) fase = new FaseInstrumentada(nombre);
+    return *fase;
+}
+
+void Instrumentacion::reiniciar() {
+    std::lock_guard<std::mutex> lock(mutexRegistro());
+    for (auto& par : registro()) {
+        par.second->llamadas = 0;
+        par.second->nanosegundos = 0;
+        par.second->bytes = 0;
+        par.second->asignaciones = 0;
+    }
+    totalAsignaciones = 0;
+    totalBytesAsignados = 0;
+    totalLiberaciones = 0;
+}
+
+void Instrumentacion::imprimir(std::ostream& out) {
+    std::lock_guard<std::mutex> lock(mutexRegistro());
+    out << std::left << std::setw(30) << "fase" << std::right
+        << std::setw(10) << "llamadas" << std::setw(14) << "tiempo (ms)"
+        << std::setw(16) << "bytes" << std::setw(14) << "asignaciones" << std::endl;
+    
+    for (const auto& par : registro()) {
+        const FaseInstrumentada& f = *par.second;
+        if (f.llamadas == 0) continue;
+        out << std::left << std::setw(30) << f.nombre << std::right
+            << std::setw(10) << f.llamadas
+            << std::setw(14) << std::fixed << std::setprecision(3) << f.nanosegundos / 1e6
+            << std::setw(16) << f.bytes
+            << std::setw(14) << f.asignaciones << std::endl;
+    }
+    
+    out << "Asignaciones totales: " << asignaciones()
+        << " (" << bytesAsignados() << " bytes), liberaciones: " << liberaciones() << std::endl;
+}
+
+uint64_t Instrumentacion::asignaciones() { return totalAsignaciones.load(std::memory_order_relaxed); }
+uint64_t Instrumentacion::bytesAsignados() { return totalBytesAsignados.load(std::memory_order_relaxed); }
+uint64_t Instrumentacion::liberaciones() { return totalLiberaciones.load(std::memory_order_relaxed); }
+uint64_t Instrumentacion::asignacionesDelHilo() { return asignacionesHilo; }
+
+#endif
@@ -0,0 +1,93 @@
+// ============================================
+// ARCHIVO: Instrumentacion.h
+// ============================================
+#ifndef INSTRUMENTACION_H
+#define INSTRUMENTACION_H
+
+// Instrumentación opcional por fases. Solo existe si se compila con
+// GENOMAS_INSTRUMENTACION (make INSTRUMENTAR=1); en otro caso las macros
+// se expanden a nada y no queda ningún rastro en el binario.
+//
+//   MEDIR_FASE("huffman.arbol");    // mide hasta el final del bloque
+//   BYTES_FASE(datos.length());     // bytes procesados por esa medición
+
+#ifdef GENOMAS_INSTRUMENTACION
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+#include <string>
+
+struct FaseInstrumentada {
+    std::string nombre;
+    std::atomic<uint64_t> llamadas;
+    std::atomic<uint64_t> nanosegundos;
+    std::atomic<uint64_t> bytes;
+    std::atomic<uint64_t> asignaciones;
+    
+    explicit FaseInstrumentada(const std::string& n)
+        : nombre(n), llamadas(0), nanosegundos(0), bytes(0), asignaciones(0) {}
+};
+
+class Instrumentacion {
+public:
+    // Devuelve la fase con ese nombre, creándola la primera vez
+    static FaseInstrumentada& registrar(const std::string& nombre);
+    static void reiniciar();
+    static void imprimir(std::ostream& out);
+    
+    // Contadores globales del operator new/delete reemplazado
+    static uint64_t asignaciones();
+    static uint64_t bytesAsignados();
+    static uint64_t liberaciones();
+    // Asignaciones hechas por el hilo que llama; no se reinicia
+    static uint64_t asignacionesDelHilo();
+};
+
+class TemporizadorFase {
+private:
+    FaseInstrumentada& fase;
+    std::chrono::steady_clock::time_point inicio;
+    uint64_t asignacionesInicio;
+    uint64_t bytes;
+
+public:
+    explicit TemporizadorFase(FaseInstrumentada& f)
+        : fase(f), inicio(std::chrono::steady_clock::now()),
+          asignacionesInicio(Instrumentacion::asignacionesDelHilo()), bytes(0) {}
+    
+    ~TemporizadorFase() {
+        auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - inicio).count();
+        fase.llamadas++;
+        fase.nanosegundos += ns;
+        fase.bytes += bytes;
+        // Solo las del hilo que mide: otros hilos asignan a la vez
+        fase.asignaciones += Instrumentacion::asignacionesDelHilo() - asignacionesInicio;
+    }
+    
+    void sumarBytes(uint64_t n) { bytes += n; }
+};
+
+#define INSTR_CONCAT2(a, b) a##b
+#define INSTR_CONCAT(a, b) INSTR_CONCAT2(a, b)
+
+#define MEDIR_FASE(nombre) \
+    static FaseInstrumentada& INSTR_CONCAT(faseInstr_, __LINE__) = Instrumentacion::registrar(nombre); \
+    TemporizadorFase medicionFase(INSTR_CONCAT(faseInstr_, __LINE__))
+
+#define MEDIR_FASE_DINAMICA(nombre) \
+    TemporizadorFase medicionFase(Instrumentacion::registrar(nombre))
+
+#define BYTES_FASE(n) medicionFase.sumarBytes(n)
+
+#else
+
+#define MEDIR_FASE(nombre)
+#define MEDIR_FASE_DINAMICA(nombre)
+#define BYTES_FASE(n)
+
+#endif
+
+#endif
@@ -0,0 +1,166 @@
+// ============================================
+// ARCHIVO: MapaRemoto.cxx
+// ============================================
+#include "MapaRemoto.h"
+#include "PoolHilos.h"
+#include <fstream>
+#include <iomanip>
+#include <vector>
+#include <cstdio>
+#include <cstring>
+
+struct CabeceraMapa {
+    char magia[4];
+    uint32_t version;
+    uint32_t filasMuestra, colsMuestra, paso;
+    uint32_t filas, columnas;
+    uint32_t reservado;
+    uint64_t huella;
+};
+
+struct CeldaMapa {
+    int32_t fila, col;
+    double costo;
+};
+
+static const uint32_t VERSION_MAPA = 1;
+
+// FNV-1a sobre descripción, ancho y datos: identifica la secuencia al reanudar
+uint64_t MapaRemoto::huella(const Secuencia& sec) {
+    uint64_t h = 1469598103934665603ULL;
+    auto mezclar = [&](const std::string& s) {
+        for (unsigned char c : s) {
+            h ^= c;
+            h *= 1099511628211ULL;
+        }
+    };
+    mezclar(sec.obtenerDescripcion());
+    mezclar(std::to_string(sec.obtenerAnchoLinea()));
+    mezclar(sec.obtenerDatos());
+    return h;
+}
+
+static bool escribirCabecera(const CabeceraMapa& cab, std::fstream& out) {
+    out.seekp(0);
+    out.write((const char*)&cab, sizeof(cab));
+    return (bool)out;
+}
+
+static bool leerCabecera(const std::string& archivo, CabeceraMapa& cab) {
+    std::ifstream in(archivo.c_str(), std::ios::binary);
+    if (!in.is_open()) return false;
+    in.read((char*)&cab, sizeof(cab));
+    return in && memcmp(cab.magia, "GRMR", 4) == 0 && cab.version == VERSION_MAPA;
+}
+
+static int leerProgreso(const std::string& archivo) {
+    std::ifstream in((archivo + ".progreso").c_str());
+    int filas = 0;
+    if (!(in >> filas)) return 0;
+    return filas;
+}
+
+static void escribirProgreso(const std::string& archivo, int filas) {
+    std::ofstream out((archivo + ".progreso").c_str(), std::ios::trunc);
+    out << filas << "\n";
+}
+
+bool MapaRemoto::exportar(const Grafo& grafo, const Secuencia& sec, const std::string& archivo,
+                          int paso, int numHilos, int& filasReanudadas) {
+    CabeceraMapa cab;
+    memset(&cab, 0, sizeof(cab));
+    memcpy(cab.magia, "GRMR", 4);
+    cab.version = VERSION_MAPA;
+    cab.paso = paso;
+    cab.filas = sec.obtenerFilas();
+    cab.columnas = sec.obtenerColumnas();
+    cab.filasMuestra = (cab.filas + paso - 1) / paso;
+    cab.colsMuestra = (cab.columnas + paso - 1) / paso;
+    cab.huella = huella(sec);
+    
+    // Reanudar solo si el archivo existente corresponde al mismo cálculo
+    filasReanudadas = 0;
+    CabeceraMapa previa;
+    if (leerCabecera(archivo, previa) &&
+        memcmp(&previa, &cab, sizeof(cab)) == 0) {
+        filasReanudadas = leerProgreso(archivo);
+    }
+    
+    std::fstream out;
+    if (filasReanudadas > 0) {
+        out.open(archivo.c_str(), std::ios::in | std::ios::out | std::ios::binary);
+    } else {
+        out.open(archivo.c_str(), std::ios::out | std::ios::trunc | std::ios::binary);
+        if (out.is_open()) {
+            escribirCabecera(cab, out);
+            escribirProgreso(archivo, 0);
+        }
+    }
+    if (!out.is_open()) return false;
+    
+    PoolHilos pool(numHilos);
+    std::vector<EspacioBusqueda> espacios(pool.obtenerNumHilos());
+    std::vector<CeldaMapa> fila(cab.colsMuestra);
+    
+    for (uint32_t fm = filasReanudadas; fm < cab.filasMuestra; fm++) {
+        for (uint32_t cm = 0; cm < cab.colsMuestra; cm++) {
+            int i = fm * paso;
+            int j = cm * paso;
+            CeldaMapa* celda = &fila[cm];
+            
+            pool.encolar([&, i, j, celda](int hilo) {
+                celda->fila = -1;
+                celda->col = -1;
+                celda->costo = -1;
+                
+                int origen = grafo.obtenerIndice(i, j);
+                if (origen == -1) return;
+                
+                EspacioBusqueda& esp = espacios[hilo];
+                grafo.buscarDesde(origen, std::vector<int>(), esp);
+                int remota = grafo.baseRemota(origen, esp.dist);
+                if (remota == -1) return;
+                
+                Nodo nodo = grafo.obtenerNodo(remota);
+                celda->fila = nodo.fila;
+                celda->col = nodo.col;
+                celda->costo = esp.dist[remota];
+            });
+        }
+        pool.esperarTodo();
+        
+        out.seekp(sizeof(CabeceraMapa) + (std::streamoff)fm * cab.colsMuestra * sizeof(CeldaMapa));
+        out.write((const char*)fila.data(), fila.size() * sizeof(CeldaMapa));
+        out.flush();
+        if (!out) return false;
+        escribirProgreso(archivo, fm + 1);
+    }
+    
+    out.close();
+    std::remove((archivo + ".progreso").c_str());
+    return true;
+}
+
+bool MapaRemoto::exportarCSV(const std::string& archivoBinario, const std::string& archivoCSV) {
+    CabeceraMapa cab;
+    if (!leerCabecera(archivoBinario, cab)) return false;
+    
+    std::ifstream in(archivoBinario.c_str(), std::ios::binary);
+    std::ofstream out(archivoCSV.c_str());
+    if (!in.is_open() || !out.is_open()) return false;
+    in.seekg(sizeof(CabeceraMapa));
+    
+    out << "fila,col,fila_remota,col_remota,costo\n";
+    out << std::setprecision(10);
+    CeldaMapa celda;
+    for (uint32_t fm = 0; fm < cab.filasMuestra; fm++) {
+        for (uint32_t cm = 0; cm < cab.colsMuestra; cm++) {
+            if (!in.read((char*)&celda, sizeof(celda))) return false;
+            out << fm * cab.paso << "," << cm * cab.paso << ","
+                << celda.fila << "," << celda.col << "," << celda.costo << "\n";
+        }
+    }
+    
+    out.close();
+    return true;
+}
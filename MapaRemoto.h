@@ -0,0 +1,28 @@
+// ============================================
+// ARCHIVO: MapaRemoto.h
+// ============================================
+#ifndef MAPAREMOTO_H
+#define MAPAREMOTO_H
+
+#include "Secuencia.h"
+#include "Grafo.h"
+#include <cstdint>
+#include <string>
+
+// Formato del archivo (little-endian):
+//   cabecera: "GRMR", version, filasMuestra, colsMuestra, paso,
+//             filas, columnas, reservado (uint32) y huella de la secuencia (uint64)
+//   celdas:   filasMuestra * colsMuestra registros de 16 bytes con la
+//             fila y columna de la base remota (int32, -1 si no hay) y
+//             el costo (double, -1 si no hay)
+// Mientras el cálculo está en curso existe <archivo>.progreso con el número
+// de filas de muestreo ya escritas, que permite reanudarlo.
+class MapaRemoto {
+public:
+    static bool exportar(const Grafo& grafo, const Secuencia& sec, const std::string& archivo,
+                         int paso, int numHilos, int& filasReanudadas);
+    static bool exportarCSV(const std::string& archivoBinario, const std::string& archivoCSV);
+    static uint64_t huella(const Secuencia& sec);
+};
+
+#endif
@@ -0,0 +1,148 @@
+// ============================================
+// ARCHIVO: ModeloHuffman.cxx
+// ============================================
+#include "ModeloHuffman.h"
+#include "Utilidades.h"
+#include "Crc32c.h"
+#include "PoolHilos.h"
+#include "Instrumentacion.h"
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+
+static const uint32_t VERSION_MODELO = 1;
+
+// true si todos los símbolos del alfabeto tienen cuenta
+template <typename A>
+static bool cubreTodo(const uint64_t* cuentas) {
+    for (int c = 0; c < 256; c++) {
+        if (TablasAlfabeto<A>::RANGO[c] >= 0 && cuentas[c] == 0) return false;
+    }
+    return true;
+}
+
+ModeloHuffman::ModeloHuffman(const uint64_t* c) {
+    memcpy(cuentas, c, sizeof(cuentas));
+    id = Crc32c::calcular(cuentas, sizeof(cuentas));
+    for (int b = 0; b < 256; b++) {
+        if (cuentas[b] > 0) frecuencias[(char)b] = cuentas[b];
+    }
+    arbol.construir(frecuencias);
+    cubreAlfabeto[ALFABETO_ADN] = cubreTodo<AlfabetoADN>(cuentas);
+    cubreAlfabeto[ALFABETO_IUPAC] = cubreTodo<AlfabetoIUPAC>(cuentas);
+    cubreAlfabeto[ALFABETO_PROTEINA] = cubreTodo<AlfabetoProteina>(cuentas);
+    cubreAlfabeto[ALFABETO_BYTES] = cubreTodo<AlfabetoBytes>(cuentas);
+}
+
+// Casi siempre basta el alfabeto de la secuencia; si no, se cuentan sus bytes
+bool ModeloHuffman::cubre(const std::vector<Secuencia>& secuencias) const {
+    for (const auto& sec : secuencias) {
+        if (cubreAlfabeto[sec.obtenerAlfabeto()]) continue;
+        uint64_t presentes[256];
+        Alfabeto::contar(sec.obtenerAlfabeto(), sec.obtenerBases(), sec.obtenerNumBases(), presentes);
+        for (int b = 0; b < 256; b++) {
+            if (presentes[b] > 0 && cuentas[b] == 0) return false;
+        }
+    }
+    return true;
+}
+
+std::shared_ptr<const ModeloHuffman> ModeloHuffman::entrenar(const std::vector<Secuencia>& secuencias) {
+    MEDIR_FASE("modelo.entrenamiento");
+    uint64_t cuentas[256] = {};
+    for (const auto& par : Utilidades::calcularFrecuenciasGlobales(secuencias)) {
+        cuentas[(unsigned char)par.first] = par.second;
+    }
+    return std::make_shared<const ModeloHuffman>(cuentas);
+}
+
+std::shared_ptr<const ModeloHuffman> ModeloHuffman::entrenar(const std::vector<std::string>& archivos, int numHilos,
+                                                             std::vector<std::string>& fallidos) {
+    MEDIR_FASE("modelo.entrenamiento");
+    // Cuentas por hilo, sumadas al final
+    std::vector<std::vector<uint64_t>> parciales(numHilos, std::vector<uint64_t>(256, 0));
+    std::vector<char> leido(archivos.size(), 0);
+    {
+        PoolHilos pool(numHilos);
+        for (size_t k = 0; k < archivos.size(); k++) {
+            pool.encolar([&, k](int hilo) {
+                std::vector<Secuencia> secuencias;
+                if (!Utilidades::cargarFASTA(archivos[k], secuencias)) return;
+                leido[k] = 1;
+                for (const auto& par : Utilidades::calcularFrecuenciasGlobales(secuencias)) {
+                    parciales[hilo][(unsigned char)par.first] += par.second;
+                }
+            });
+        }
+        pool.esperarTodo();
+    }
+    
+    uint64_t cuentas[256] = {};
+    for (const auto& p : parciales) {
+        for (int c = 0; c < 256; c++) cuentas[c] += p[c];
+    }
+    for (size_t k = 0; k < archivos.size(); k++) {
+        if (!leido[k]) fallidos.push_back(archivos[k]);
+    }
+    return std::make_shared<const ModeloHuffman>(cuentas);
+}
+
+std::shared_ptr<const ModeloHuffman> ModeloHuffman::leer(const std::string& archivo) {
+    std::ifstream in(archivo.c_str(), std::ios::binary);
+    if (!in.is_open()) return nullptr;
+    char magia[4];
+    uint32_t version, id;
+    uint64_t cuentas[256];
+    if (!in.read(magia, 4) || memcmp(magia, "FABM", 4) != 0 ||
+        !in.read((char*)&version, 4) || version != VERSION_MODELO ||
+        !in.read((char*)&id, 4) || !in.read((char*)cuentas, sizeof(cuentas))) {
+        return nullptr;
+    }
+    auto modelo = std::make_shared<const ModeloHuffman>(cuentas);
+    if (modelo->obtenerId() != id || modelo->vacio()) return nullptr;
+    return modelo;
+}
+
+bool ModeloHuffman::guardar(const std::string& archivo) const {
+    std::ofstream out(archivo.c_str(), std::ios::binary);
+    if (!out.is_open()) return false;
+    out.write("FABM", 4);
+    out.write((const char*)&VERSION_MODELO, 4);
+    out.write((const char*)&id, 4);
+    out.write((const char*)cuentas, sizeof(cuentas));
+    out.close();
+    return (bool)out;
+}
+
+double ModeloHuffman::bitsPorSimbolo() const {
+    std::map<char, std::string> codigos = arbol.obtenerCodigos();
+    double bits = 0, total = 0;
+    for (const auto& par : frecuencias) {
+        bits += (double)par.second * codigos[par.first].length();
+        total += par.second;
+    }
+    return total > 0 ? bits / total : 0;
+}
+
+std::string ModeloHuffman::nombreId(uint32_t id) {
+    char texto[9];
+    snprintf(texto, sizeof(texto), "%08x", id);
+    return texto;
+}
+
+void RegistroModelos::registrar(const std::shared_ptr<const ModeloHuffman>& modelo) {
+    std::lock_guard<std::mutex> lock(mtx);
+    modelos[modelo->obtenerId()] = modelo;
+}
+
+std::shared_ptr<const ModeloHuffman> RegistroModelos::buscar(uint32_t id) const {
+    std::lock_guard<std::mutex> lock(mtx);
+    auto it = modelos.find(id);
+    return it == modelos.end() ? nullptr : it->second;
+}
+
+std::shared_ptr<const ModeloHuffman> RegistroModelos::cargar(const std::string& archivo) {
+    std::shared_ptr<const ModeloHuffman> modelo = ModeloHuffman::leer(archivo);
+    if (modelo) registrar(modelo);
+    return modelo;
+}
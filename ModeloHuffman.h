@@ -0,0 +1,67 @@
+// ============================================
+// ARCHIVO: ModeloHuffman.h
+// ============================================
+#ifndef MODELOHUFFMAN_H
+#define MODELOHUFFMAN_H
+
+#include "ArbolHuffman.h"
+#include "Secuencia.h"
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Tabla de Huffman entrenada con un corpus, para que los .fabin pequeños
+// la nombren por su identificador en lugar de llevar la suya. Solo tiene
+// códigos para los bytes vistos en el corpus (dar código a los demás
+// alargaría el de alguna base), así que antes de usarlo hay que comprobar
+// que cubre las secuencias. El identificador es el CRC32C de las
+// frecuencias: el mismo corpus da el mismo modelo.
+// Archivo .fabm: "FABM", versión, identificador y las 256 frecuencias.
+class ModeloHuffman {
+private:
+    uint64_t cuentas[256];
+    std::map<char, uint64_t> frecuencias;
+    uint32_t id;
+    ArbolHuffman arbol;
+    bool cubreAlfabeto[ALFABETO_BYTES + 1];
+
+public:
+    // Frecuencias de los 256 bytes; las que son cero no tienen código
+    explicit ModeloHuffman(const uint64_t* cuentas);
+    
+    static std::shared_ptr<const ModeloHuffman> entrenar(const std::vector<Secuencia>& secuencias);
+    // Lee los FASTA en paralelo; los que no se pueden leer quedan en 'fallidos'
+    static std::shared_ptr<const ModeloHuffman> entrenar(const std::vector<std::string>& archivos, int numHilos,
+                                                         std::vector<std::string>& fallidos);
+    // nullptr si no existe o no es un modelo válido
+    static std::shared_ptr<const ModeloHuffman> leer(const std::string& archivo);
+    bool guardar(const std::string& archivo) const;
+    
+    // true si todos los bytes de las secuencias tienen código
+    bool cubre(const std::vector<Secuencia>& secuencias) const;
+    bool vacio() const { return frecuencias.empty(); }
+    uint32_t obtenerId() const { return id; }
+    const ArbolHuffman& obtenerArbol() const { return arbol; }
+    // Bits por símbolo al codificar el corpus de entrenamiento
+    double bitsPorSimbolo() const;
+    // Identificador en hexadecimal, como se muestra y se busca
+    static std::string nombreId(uint32_t id);
+};
+
+// Modelos disponibles en la sesión por identificador
+class RegistroModelos {
+private:
+    mutable std::mutex mtx;
+    std::map<uint32_t, std::shared_ptr<const ModeloHuffman>> modelos;
+
+public:
+    void registrar(const std::shared_ptr<const ModeloHuffman>& modelo);
+    std::shared_ptr<const ModeloHuffman> buscar(uint32_t id) const;
+    // Lee el archivo y registra el modelo; nullptr si no es válido
+    std::shared_ptr<const ModeloHuffman> cargar(const std::string& archivo);
+};
+
+#endif
@@ -0,0 +1,61 @@
+// ============================================
+// ARCHIVO: PoolHilos.cxx
+// ============================================
+#include "PoolHilos.h"
+
+PoolHilos::PoolHilos(int numHilos) : pendientes(0), detener(false) {
+    if (numHilos < 1) numHilos = 1;
+    for (int i = 0; i < numHilos; i++) {
+        hilos.push_back(std::thread(&PoolHilos::trabajar, this, i));
+    }
+}
+
+PoolHilos::~PoolHilos() {
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        detener = true;
+    }
+    hayTrabajo.notify_all();
+    for (auto& h : hilos) h.join();
+}
+
+void PoolHilos::trabajar(int id) {
+    while (true) {
+        std::function<void(int)> tarea;
+        {
+            std::unique_lock<std::mutex> lock(mtx);
+            hayTrabajo.wait(lock, [&] { return detener || !tareas.empty(); });
+            if (tareas.empty()) return;
+            tarea = tareas.front();
+            tareas.pop();
+        }
+        
+        tarea(id);
+        
+        std::lock_guard<std::mutex> lock(mtx);
+        if (--pendientes == 0) terminado.notify_all();
+    }
+}
+
+void PoolHilos::encolar(const std::function<void(int)>& tarea) {
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        tareas.push(tarea);
+        pendientes++;
+    }
+    hayTrabajo.notify_one();
+}
+
+void PoolHilos::esperarTodo() {
+    std::unique_lock<std::mutex> lock(mtx);
+    terminado.wait(lock, [&] { return pendientes == 0; });
+}
+
+int PoolHilos::obtenerNumHilos() const {
+    return hilos.size();
+}
+
+int PoolHilos::hilosPorDefecto() {
+    unsigned n = std::thread::hardware_concurrency();
+    return n > 0 ? (int)n : 1;
+}
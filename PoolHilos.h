@@ -0,0 +1,39 @@
+// ============================================
+// ARCHIVO: PoolHilos.h
+// ============================================
+#ifndef POOLHILOS_H
+#define POOLHILOS_H
+
+#include <vector>
+#include <queue>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+
+// Pool de hilos fijo. Cada tarea recibe el número del hilo que la ejecuta
+// (0..numHilos-1) para que pueda usar sus propios buffers de trabajo.
+class PoolHilos {
+private:
+    std::vector<std::thread> hilos;
+    std::queue<std::function<void(int)>> tareas;
+    std::mutex mtx;
+    std::condition_variable hayTrabajo;
+    std::condition_variable terminado;
+    int pendientes;
+    bool detener;
+    
+    void trabajar(int id);
+
+public:
+    explicit PoolHilos(int numHilos);
+    ~PoolHilos();
+    
+    void encolar(const std::function<void(int)>& tarea);
+    void esperarTodo();
+    int obtenerNumHilos() const;
+    
+    static int hilosPorDefecto();
+};
+
+#endif
@@ -2,36 +2,306 @@
 // ARCHIVO: Secuencia.cxx
 // ============================================
 #include "Secuencia.h"
+#include "Instrumentacion.h"
+#include <atomic>
+#include <algorithm>
+#include <set>
 
-Secuencia::Secuencia() : anchoLinea(0) {}
+static std::atomic<uint64_t> siguienteIdentidad(1);
+
+Secuencia::Secuencia()
+    : anchoLinea(0), estadoActual(0),
+      identidad(siguienteIdentidad++), version(0), versionDiario(0) {
+    Contenido vacio = {nullptr, "", 0, nullptr};
+    iniciar(vacio, ALFABETO_ADN);
+}
 
 Secuencia::Secuencia(const std::string& desc, const std::string& datos, int ancho)
-    : descripcion(desc), datos(datos), anchoLinea(ancho) {}
+    : descripcion(desc), anchoLinea(ancho), estadoActual(0),
+      identidad(siguienteIdentidad++), version(0), versionDiario(0) {
+    Contenido propio = {std::make_shared<std::string>(datos), nullptr, datos.length(), nullptr};
+    iniciar(propio, Alfabeto::detectar(datos.data(), datos.length()));
+}
+
+Secuencia::Secuencia(const std::string& desc, const char* bases, size_t numBases, int ancho,
+                     std::shared_ptr<const void> mapeo, TipoAlfabeto alfabeto)
+    : descripcion(desc), anchoLinea(ancho), estadoActual(0),
+      identidad(siguienteIdentidad++), version(0), versionDiario(0) {
+    Contenido ajeno = {nullptr, bases, numBases, mapeo};
+    iniciar(ajeno, alfabeto);
+}
+
+void Secuencia::iniciar(const Contenido& bases, TipoAlfabeto alfabeto) {
+    if (!historial.empty()) aparcados[estado().raiz] = std::make_pair((int)estadoActual, contenido);
+    std::shared_ptr<Estado> estado = std::make_shared<Estado>();
+    estado->anterior = -1;
+    estado->raiz = historial.size();
+    estado->alfabeto = alfabeto;
+    historial.push_back(estado);
+    estadoActual = historial.size() - 1;
+    contenido = bases;
+}
+
+std::string& Secuencia::escribibles() {
+    if (!contenido.propio || contenido.propio.use_count() > 1) {
+        contenido.propio = std::make_shared<std::string>(bases(), longitud());
+        contenido.ajenas = nullptr;
+        contenido.dueno.reset();
+    }
+    return *contenido.propio;
+}
 
-std::string Secuencia::obtenerDescripcion() const { return descripcion; }
-std::string Secuencia::obtenerDatos() const { return datos; }
+const std::string& Secuencia::obtenerDescripcion() const { return descripcion; }
+std::string Secuencia::obtenerDatos() const { return std::string(bases(), longitud()); }
 int Secuencia::obtenerAnchoLinea() const { return anchoLinea; }
-int Secuencia::obtenerNumBases() const { return datos.length(); }
+int Secuencia::obtenerNumBases() const { return longitud(); }
+const char* Secuencia::obtenerBases() const { return bases(); }
+TipoAlfabeto Secuencia::obtenerAlfabeto() const { return estado().alfabeto; }
 
 bool Secuencia::esCompleta() const {
-    return datos.find('-') == std::string::npos;
+    return std::find(bases(), bases() + longitud(), '-') == bases() + longitud();
+}
+
+// Agrega al diario los tramos cuyo valor anterior difiere del actual; si
+// una posición aparece varias veces vale la primera
+void Secuencia::anotarCambios(std::vector<std::pair<size_t, char>>& anteriores) {
+    const char* actuales = bases();
+    std::stable_sort(anteriores.begin(), anteriores.end(),
+                     [](const std::pair<size_t, char>& a, const std::pair<size_t, char>& b) {
+                         return a.first < b.first;
+                     });
+    size_t inicio = diario.size();
+    for (size_t i = 0; i < anteriores.size(); i++) {
+        size_t pos = anteriores[i].first;
+        if (i > 0 && pos == anteriores[i - 1].first) continue;
+        if (actuales[pos] == anteriores[i].second) continue;
+        if (diario.size() > inicio && diario.back().posicion + diario.back().largo == pos) {
+            diario.back().largo++;
+        } else {
+            Cambio cambio = {version, (uint32_t)pos, 1};
+            diario.push_back(cambio);
+        }
+    }
+    // Pasado el límite, comparar todas las bases es más barato que el diario
+    if (diario.size() > MAX_CAMBIOS_DIARIO) {
+        diario.clear();
+        diario.shrink_to_fit();
+        versionDiario = version;
+    }
+}
+
+void Secuencia::agregarEstado(const std::vector<Pieza>& nuevas, std::shared_ptr<const std::string> buffer) {
+    version++;
+    const Estado& actual = estado();
+    std::shared_ptr<Estado> siguiente = std::make_shared<Estado>();
+    siguiente->anterior = estadoActual;
+    siguiente->raiz = actual.raiz;
+    siguiente->piezas = nuevas;
+    siguiente->buffer = buffer;
+    siguiente->alfabeto = Alfabeto::ampliar(actual.alfabeto, buffer->data(), buffer->length());
+    
+    std::vector<std::pair<size_t, char>> anteriores;
+    std::string& escritas = escribibles();
+    for (const Pieza& p : nuevas) {
+        siguiente->previas.append(escritas, p.posicion, p.largo);
+        for (size_t i = p.posicion; i < p.posicion + p.largo; i++) {
+            anteriores.push_back(std::make_pair(i, escritas[i]));
+        }
+        std::copy(p.bases, p.bases + p.largo, &escritas[p.posicion]);
+    }
+    
+    historial.push_back(siguiente);
+    estadoActual = historial.size() - 1;
+    anotarCambios(anteriores);
 }
 
 void Secuencia::fijarDatos(const std::string& nuevosDatos) {
-    datos = nuevosDatos;
+    const char* actuales = bases();
+    size_t largo = longitud();
+    
+    if (nuevosDatos.length() != largo) {
+        // Cambio estructural: otra raíz, y el diario anterior deja de servir
+        version++;
+        diario.clear();
+        versionDiario = version;
+        Contenido propio = {std::make_shared<std::string>(nuevosDatos), nullptr, nuevosDatos.length(), nullptr};
+        iniciar(propio, Alfabeto::detectar(nuevosDatos.data(), nuevosDatos.length()));
+        return;
+    }
+    
+    // Solo los tramos que cambian pasan al buffer del nuevo estado
+    std::vector<Pieza> nuevas;
+    std::shared_ptr<std::string> buffer = std::make_shared<std::string>();
+    for (size_t i = 0; i < largo; ) {
+        if (actuales[i] == nuevosDatos[i]) {
+            i++;
+            continue;
+        }
+        size_t inicio = i;
+        while (i < largo && actuales[i] != nuevosDatos[i]) i++;
+        Pieza p = {inicio, i - inicio, nullptr};
+        nuevas.push_back(p);
+        buffer->append(nuevosDatos, inicio, i - inicio);
+    }
+    if (nuevas.empty()) return;
+    
+    size_t desplazamiento = 0;
+    for (Pieza& p : nuevas) {
+        p.bases = buffer->data() + desplazamiento;
+        desplazamiento += p.largo;
+    }
+    agregarEstado(nuevas, buffer);
+}
+
+void Secuencia::rellenar(const std::vector<std::pair<size_t, size_t>>& rangos, char base) {
+    std::vector<std::pair<size_t, size_t>> ordenados(rangos);
+    std::sort(ordenados.begin(), ordenados.end());
+    
+    // Une rangos solapados y descarta los que no cambian nada
+    const char* actuales = bases();
+    size_t largo = longitud();
+    std::vector<Pieza> nuevas;
+    size_t total = 0;
+    bool cambia = false;
+    for (const auto& r : ordenados) {
+        size_t desde = std::min(r.first, largo);
+        size_t hasta = std::min(r.first + r.second, largo);
+        if (!nuevas.empty() && desde <= nuevas.back().posicion + nuevas.back().largo) {
+            desde = nuevas.back().posicion + nuevas.back().largo;
+        }
+        if (hasta <= desde) continue;
+        for (size_t i = desde; i < hasta && !cambia; i++) cambia = actuales[i] != base;
+        if (!nuevas.empty() && desde == nuevas.back().posicion + nuevas.back().largo) {
+            nuevas.back().largo += hasta - desde;
+        } else {
+            Pieza p = {desde, hasta - desde, nullptr};
+            nuevas.push_back(p);
+        }
+        total += hasta - desde;
+    }
+    if (!cambia) return;
+    
+    // Todas las piezas leen del mismo buffer de relleno
+    std::shared_ptr<std::string> buffer = std::make_shared<std::string>(total, base);
+    for (Pieza& p : nuevas) p.bases = buffer->data();
+    agregarEstado(nuevas, buffer);
+}
+
+int Secuencia::obtenerNumEstados() const { return historial.size(); }
+int Secuencia::obtenerEstadoActual() const { return estadoActual; }
+
+bool Secuencia::irAEstado(int numero) {
+    if (numero < 0 || numero >= (int)historial.size()) return false;
+    if ((size_t)numero == estadoActual) return true;
+    version++;
+    
+    // Otra raíz: se retoman sus bases donde quedaron y se aparcan las actuales
+    int raiz = historial[numero]->raiz;
+    bool otraRaiz = raiz != estado().raiz;
+    if (otraRaiz) {
+        std::pair<int, Contenido> retomado = aparcados[raiz];
+        aparcados.erase(raiz);
+        aparcados[estado().raiz] = std::make_pair((int)estadoActual, contenido);
+        estadoActual = retomado.first;
+        contenido = retomado.second;
+        diario.clear();
+        versionDiario = version;
+    }
+    
+    // Se deshacen los estados desde el actual hasta el ancestro común y se
+    // rehacen los que llevan al nuevo: solo se escriben los tramos editados
+    std::set<int> ancestros;
+    for (int e = estadoActual; e >= 0; e = historial[e]->anterior) ancestros.insert(e);
+    int comun = numero;
+    std::vector<const Estado*> rehacer;
+    while (!ancestros.count(comun)) {
+        rehacer.push_back(historial[comun].get());
+        comun = historial[comun]->anterior;
+    }
+    std::reverse(rehacer.begin(), rehacer.end());
+    std::vector<const Estado*> deshacer;
+    for (int e = estadoActual; e != comun; e = historial[e]->anterior) deshacer.push_back(historial[e].get());
+    
+    std::vector<std::pair<size_t, char>> anteriores;
+    if (!deshacer.empty() || !rehacer.empty()) {
+        std::string& escritas = escribibles();
+        for (const Estado* e : deshacer) {
+            size_t desplazamiento = 0;
+            for (const Pieza& p : e->piezas) {
+                for (size_t i = p.posicion; i < p.posicion + p.largo; i++) {
+                    anteriores.push_back(std::make_pair(i, escritas[i]));
+                }
+                std::copy(e->previas.begin() + desplazamiento, e->previas.begin() + desplazamiento + p.largo,
+                          &escritas[p.posicion]);
+                desplazamiento += p.largo;
+            }
+        }
+        for (const Estado* e : rehacer) {
+            for (const Pieza& p : e->piezas) {
+                for (size_t i = p.posicion; i < p.posicion + p.largo; i++) {
+                    anteriores.push_back(std::make_pair(i, escritas[i]));
+                }
+                std::copy(p.bases, p.bases + p.largo, &escritas[p.posicion]);
+            }
+        }
+    }
+    estadoActual = numero;
+    if (!otraRaiz) anotarCambios(anteriores);
+    return true;
+}
+
+void Secuencia::describirEstado(int numero, int& anterior, size_t& basesEditadas, size_t& numPiezas) const {
+    anterior = -1;
+    basesEditadas = numPiezas = 0;
+    if (numero < 0 || numero >= (int)historial.size()) return;
+    const Estado& e = *historial[numero];
+    anterior = e.anterior;
+    numPiezas = e.piezas.size();
+    for (const Pieza& p : e.piezas) basesEditadas += p.largo;
+}
+
+size_t Secuencia::memoriaHistorial() const {
+    size_t total = 0;
+    for (const auto& e : historial) {
+        total += sizeof(Estado) + e->piezas.capacity() * sizeof(Pieza);
+        if (e->buffer) total += e->buffer->capacity();
+        total += e->previas.capacity();
+    }
+    return total;
+}
+
+uint64_t Secuencia::obtenerIdentidad() const { return identidad; }
+uint64_t Secuencia::obtenerVersion() const { return version; }
+
+bool Secuencia::cambiosDesde(uint64_t desde, std::vector<int>& posiciones) const {
+    posiciones.clear();
+    if (desde < versionDiario) return false;
+    
+    auto it = std::upper_bound(diario.begin(), diario.end(), desde,
+                               [](uint64_t v, const Cambio& c) { return v < c.version; });
+    for (; it != diario.end(); ++it) {
+        for (uint32_t i = 0; i < it->largo; i++) posiciones.push_back(it->posicion + i);
+    }
+    std::sort(posiciones.begin(), posiciones.end());
+    posiciones.erase(std::unique(posiciones.begin(), posiciones.end()), posiciones.end());
+    return true;
 }
 
 std::map<char, int> Secuencia::calcularHistograma() const {
+    MEDIR_FASE("histograma");
+    BYTES_FASE(longitud());
+    uint64_t cuentas[256];
+    Alfabeto::contar(estado().alfabeto, bases(), longitud(), cuentas);
     std::map<char, int> histograma;
-    for (char c : datos) {
-        histograma[c]++;
+    for (int c = 0; c < 256; c++) {
+        if (cuentas[c] > 0) histograma[(char)c] = cuentas[c];
     }
     return histograma;
 }
 
 int Secuencia::obtenerFilas() const {
     if (anchoLinea == 0) return 0;
-    return (datos.length() + anchoLinea - 1) / anchoLinea;
+    return (longitud() + anchoLinea - 1) / anchoLinea;
 }
 
 int Secuencia::obtenerColumnas() const {
@@ -40,8 +310,8 @@ int Secuencia::obtenerColumnas() const {
 
 char Secuencia::obtenerBase(int fila, int col) const {
     int pos = fila * anchoLinea + col;
-    if (pos >= 0 && pos < (int)datos.length()) {
-        return datos[pos];
+    if (pos >= 0 && pos < (int)longitud()) {
+        return bases()[pos];
     }
     return '\0';
 }
@@ -49,5 +319,5 @@ char Secuencia::obtenerBase(int fila, int col) const {
 bool Secuencia::posicionValida(int fila, int col) const {
     if (fila < 0 || col < 0 || col >= anchoLinea) return false;
     int pos = fila * anchoLinea + col;
-    return pos >= 0 && pos < (int)datos.length();
+    return pos >= 0 && pos < (int)longitud();
 }
\ No newline at end of file
@@ -7,24 +7,118 @@
 #include <string>
 #include <vector>
 #include <map>
+#include <cstdint>
+#include <utility>
+#include <memory>
+#include "Alfabeto.h"
 
 class Secuencia {
 private:
+    // Bases de un estado: un buffer propio que se edita en su sitio, o
+    // memoria ajena de solo lectura (p. ej. una sesión mapeada, que 'dueno'
+    // mantiene viva) hasta la primera modificación. Las copias comparten el
+    // buffer y se duplica solo al modificar uno que no es único.
+    struct Contenido {
+        std::shared_ptr<std::string> propio;
+        const char* ajenas;
+        size_t longitud;
+        std::shared_ptr<const void> dueno;
+    };
+    // Tramo de bases escrito por una modificación, guardado en su buffer
+    struct Pieza {
+        size_t posicion;
+        size_t largo;
+        const char* bases;
+    };
+    // Estado inmutable: el de 'anterior' con sus piezas, ordenadas y sin
+    // solapes, encima. 'previas' guarda las bases que las piezas taparon,
+    // en el mismo orden, para volver al anterior. Cada modificación agrega
+    // un estado con solo lo que cambió, así que N estados cuestan sus
+    // ediciones y no una copia de la secuencia.
+    struct Estado {
+        int anterior;       // índice en el historial, -1 en una raíz
+        int raiz;           // estado sin anterior del que parte (por un cambio de largo)
+        TipoAlfabeto alfabeto;
+        std::vector<Pieza> piezas;
+        std::shared_ptr<const std::string> buffer;
+        std::string previas;
+    };
+    
     std::string descripcion;
-    std::string datos;
     int anchoLinea;
+    std::vector<std::shared_ptr<const Estado>> historial;
+    size_t estadoActual;
+    Contenido contenido;
+    // Bases de las otras raíces, por raíz: el estado en que quedaron al
+    // cambiar de raíz y su contenido
+    std::map<int, std::pair<int, Contenido>> aparcados;
+    
+    // Tramo de bases consecutivas cambiadas por una misma versión
+    struct Cambio {
+        uint64_t version;
+        uint32_t posicion;
+        uint32_t largo;
+    };
+    
+    // Control de cambios: cada objeto cargado tiene una identidad propia y
+    // una versión que aumenta con cada modificación. El diario guarda los
+    // tramos cambiados desde versionDiario, hasta MAX_CAMBIOS_DIARIO.
+    uint64_t identidad;
+    uint64_t version;
+    uint64_t versionDiario;
+    std::vector<Cambio> diario;
+    
+    const Estado& estado() const { return *historial[estadoActual]; }
+    const char* bases() const { return contenido.propio ? contenido.propio->data() : contenido.ajenas; }
+    size_t longitud() const { return contenido.longitud; }
+    
+    // Nueva raíz con 'bases'; las de la raíz actual quedan aparcadas
+    void iniciar(const Contenido& bases, TipoAlfabeto alfabeto);
+    // Buffer propio y único, copiado de las bases actuales si hace falta
+    std::string& escribibles();
+    void agregarEstado(const std::vector<Pieza>& nuevas, std::shared_ptr<const std::string> buffer);
+    void anotarCambios(std::vector<std::pair<size_t, char>>& anteriores);
 
 public:
+    // Con más tramos en el diario se descarta y los grafos comparan todo
+    static const size_t MAX_CAMBIOS_DIARIO = 1024;
+    
     Secuencia();
     Secuencia(const std::string& desc, const std::string& datos, int ancho);
+    // Vista de solo lectura sobre bases que viven en otro bloque de memoria,
+    // con su alfabeto ya conocido
+    Secuencia(const std::string& desc, const char* bases, size_t numBases, int ancho,
+              std::shared_ptr<const void> mapeo, TipoAlfabeto alfabeto);
     
-    std::string obtenerDescripcion() const;
+    const std::string& obtenerDescripcion() const;
     std::string obtenerDatos() const;
     int obtenerAnchoLinea() const;
     int obtenerNumBases() const;
     bool esCompleta() const;
+    // Acceso directo a las bases, sin copiar
+    const char* obtenerBases() const;
+    // Menor alfabeto que cubre las bases; se detecta al cargar y se amplía
+    // si una modificación escribe símbolos nuevos
+    TipoAlfabeto obtenerAlfabeto() const;
     
     void fijarDatos(const std::string& nuevosDatos);
+    // Pone 'base' en cada rango (posición, largo) sin copiar la secuencia
+    void rellenar(const std::vector<std::pair<size_t, size_t>>& rangos, char base);
+    
+    // Historial de estados (0 es el cargado); cada modificación agrega uno
+    int obtenerNumEstados() const;
+    int obtenerEstadoActual() const;
+    // Cambia al estado dado reescribiendo solo las bases editadas
+    bool irAEstado(int numero);
+    // Estado del que parte, y bases y tramos que escribió
+    void describirEstado(int numero, int& anterior, size_t& basesEditadas, size_t& numPiezas) const;
+    // Bytes de ediciones guardadas en todo el historial
+    size_t memoriaHistorial() const;
+
+    uint64_t obtenerIdentidad() const;
+    uint64_t obtenerVersion() const;
+    // Posiciones cambiadas desde 'desde'; false si el diario ya no las cubre
+    bool cambiosDesde(uint64_t desde, std::vector<int>& posiciones) const;
     std::map<char, int> calcularHistograma() const;
     
     // Para representación matricial
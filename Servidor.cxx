@@ -0,0 +1,137 @@
+// ============================================
+// ARCHIVO: Servidor.cxx
+// ============================================
+#include "Servidor.h"
+#include <sstream>
+#include <iostream>
+#include <list>
+#include <thread>
+#include <atomic>
+#include <csignal>
+#include <cstring>
+#include <cerrno>
+#include <unistd.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+static volatile sig_atomic_t detenerServidor = 0;
+
+static void manejarSenal(int) {
+    detenerServidor = 1;
+}
+
+struct Conexion {
+    int fd;
+    std::thread hilo;
+    std::atomic<bool> terminada;
+    
+    explicit Conexion(int fd) : fd(fd), terminada(false) {}
+};
+
+static bool enviarTodo(int fd, const std::string& datos) {
+    size_t enviado = 0;
+    while (enviado < datos.length()) {
+        ssize_t n = send(fd, datos.data() + enviado, datos.length() - enviado, MSG_NOSIGNAL);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return false;
+        enviado += n;
+    }
+    return true;
+}
+
+static void atenderCliente(int fd, const Servidor::Ejecutor& ejecutor) {
+    std::string pendiente;
+    char bloque[4096];
+    
+    while (true) {
+        ssize_t n = recv(fd, bloque, sizeof(bloque), 0);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) break;
+        pendiente.append(bloque, n);
+        
+        size_t fin;
+        while ((fin = pendiente.find('\n')) != std::string::npos) {
+            std::string linea = pendiente.substr(0, fin);
+            pendiente.erase(0, fin + 1);
+            if (!linea.empty() && linea[linea.length() - 1] == '\r') linea.erase(linea.length() - 1);
+            
+            std::istringstream iss(linea);
+            std::string comando;
+            iss >> comando;
+            if (comando == "salir") return;
+            
+            std::ostringstream respuesta;
+            if (!comando.empty()) ejecutor(linea, respuesta);
+            respuesta << Servidor::FIN_RESPUESTA << "\n";
+            if (!enviarTodo(fd, respuesta.str())) return;
+        }
+    }
+}
+
+bool Servidor::ejecutar(const std::string& ruta, const Ejecutor& ejecutor) {
+    sockaddr_un direccion;
+    memset(&direccion, 0, sizeof(direccion));
+    direccion.sun_family = AF_UNIX;
+    if (ruta.length() >= sizeof(direccion.sun_path)) return false;
+    strncpy(direccion.sun_path, ruta.c_str(), sizeof(direccion.sun_path) - 1);
+    
+    int servidor = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (servidor < 0) return false;
+    
+    unlink(ruta.c_str());
+    if (bind(servidor, (sockaddr*)&direccion, sizeof(direccion)) < 0 || listen(servidor, 64) < 0) {
+        close(servidor);
+        return false;
+    }
+    
+    detenerServidor = 0;
+    signal(SIGINT, manejarSenal);
+    signal(SIGTERM, manejarSenal);
+    
+    std::cerr << "Servidor escuchando en " << ruta << std::endl;
+    
+    // Solo este hilo toca la lista; cada hilo de cliente marca 'terminada'
+    // en su conexión y aquí se le hace join y se cierra su socket. El fd no
+    // se cierra antes del join para que shutdown nunca alcance un fd reusado.
+    std::list<Conexion> conexiones;
+    
+    while (!detenerServidor) {
+        for (std::list<Conexion>::iterator it = conexiones.begin(); it != conexiones.end();) {
+            if (!it->terminada) {
+                ++it;
+                continue;
+            }
+            it->hilo.join();
+            close(it->fd);
+            it = conexiones.erase(it);
+        }
+        
+        pollfd pfd;
+        pfd.fd = servidor;
+        pfd.events = POLLIN;
+        if (poll(&pfd, 1, 200) <= 0) continue;
+        
+        int cliente = accept(servidor, nullptr, nullptr);
+        if (cliente < 0) continue;
+        
+        conexiones.emplace_back(cliente);
+        Conexion& conexion = conexiones.back();
+        conexion.hilo = std::thread([&conexion, &ejecutor] {
+            atenderCliente(conexion.fd, ejecutor);
+            conexion.terminada = true;
+        });
+    }
+    
+    // Despertar a los clientes bloqueados en recv y esperar a sus hilos
+    for (Conexion& conexion : conexiones) shutdown(conexion.fd, SHUT_RDWR);
+    for (Conexion& conexion : conexiones) {
+        conexion.hilo.join();
+        close(conexion.fd);
+    }
+    
+    close(servidor);
+    unlink(ruta.c_str());
+    std::cerr << "Servidor detenido." << std::endl;
+    return true;
+}
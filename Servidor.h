@@ -0,0 +1,26 @@
+// ============================================
+// ARCHIVO: Servidor.h
+// ============================================
+#ifndef SERVIDOR_H
+#define SERVIDOR_H
+
+#include <string>
+#include <ostream>
+#include <functional>
+
+// Servidor local sobre un socket de dominio Unix. Cada cliente envía
+// comandos terminados en '\n'; por cada uno recibe la salida del comando
+// seguida de una línea con el carácter FIN_RESPUESTA. 'salir' cierra solo
+// esa conexión. Cada conexión se atiende en su propio hilo; el ejecutor
+// es responsable de la sincronización entre comandos.
+class Servidor {
+public:
+    static const char FIN_RESPUESTA = '\x04';
+    
+    typedef std::function<void(const std::string& linea, std::ostream& out)> Ejecutor;
+    
+    // Bloquea hasta recibir SIGINT o SIGTERM; false si no pudo abrir el socket
+    static bool ejecutar(const std::string& ruta, const Ejecutor& ejecutor);
+};
+
+#endif
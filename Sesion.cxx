@@ -0,0 +1,225 @@
+// ============================================
+// ARCHIVO: Sesion.cxx
+// ============================================
+#include "Sesion.h"
+#include "Instrumentacion.h"
+#include <fstream>
+#include <cstdio>
+#include <cstring>
+#include <cstdint>
+#include <cmath>
+#include <memory>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+struct CabeceraSesion {
+    char magia[4];
+    uint32_t version;
+    uint32_t marcaOrden;
+    uint32_t tamNodo, tamArista;
+    uint32_t numSecuencias;
+    uint64_t tamArchivo;
+    uint64_t desplTabla;
+};
+
+struct EntradaSesion {
+    uint64_t desplDescripcion, desplBases;
+    uint64_t desplNodos, desplInicio, desplAristas;
+    uint32_t largoDescripcion, numBases;
+    int32_t anchoLinea, numAristas;
+    uint32_t tieneGrafo;
+    uint32_t alfabeto;      // TipoAlfabeto
+};
+
+static const uint32_t VERSION_SESION = 2;
+static const uint32_t MARCA_ORDEN = 0x01020304;
+static const uint64_t ALINEACION = 64;
+
+// Escribe un bloque alineado y devuelve su desplazamiento
+static uint64_t escribirBloque(std::ofstream& out, uint64_t& posicion, const void* datos, uint64_t bytes) {
+    static const char relleno[ALINEACION] = {0};
+    uint64_t sobrante = posicion % ALINEACION;
+    if (sobrante != 0) {
+        out.write(relleno, ALINEACION - sobrante);
+        posicion += ALINEACION - sobrante;
+    }
+    uint64_t despl = posicion;
+    out.write((const char*)datos, bytes);
+    posicion += bytes;
+    return despl;
+}
+
+bool Sesion::guardar(const std::string& archivo, const std::vector<Secuencia>& secuencias,
+                     const Catalogo& catalogo, CacheGrafos& grafos, int& grafosGuardados) {
+    MEDIR_FASE("sesion.guardar");
+    grafosGuardados = 0;
+    
+    // Se escribe aparte y se renombra: así no se trunca un archivo que
+    // esta u otra sesión tenga mapeado
+    std::string temporal = archivo + ".tmp";
+    std::ofstream out(temporal.c_str(), std::ios::binary | std::ios::trunc);
+    if (!out.is_open()) return false;
+    
+    CabeceraSesion cab;
+    memset(&cab, 0, sizeof(cab));
+    memcpy(cab.magia, "GSES", 4);
+    cab.version = VERSION_SESION;
+    cab.marcaOrden = MARCA_ORDEN;
+    cab.tamNodo = sizeof(Nodo);
+    cab.tamArista = sizeof(Arista);
+    cab.numSecuencias = secuencias.size();
+    out.write((const char*)&cab, sizeof(cab));
+    uint64_t posicion = sizeof(cab);
+    
+    std::vector<EntradaSesion> tabla(secuencias.size());
+    for (size_t k = 0; k < secuencias.size(); k++) {
+        const Secuencia& sec = secuencias[k];
+        EntradaSesion& e = tabla[k];
+        memset(&e, 0, sizeof(e));
+        
+        std::string desc = sec.obtenerDescripcion();
+        e.largoDescripcion = desc.length();
+        e.desplDescripcion = escribirBloque(out, posicion, desc.data(), desc.length());
+        e.numBases = sec.obtenerNumBases();
+        e.anchoLinea = sec.obtenerAnchoLinea();
+        e.alfabeto = sec.obtenerAlfabeto();
+        e.desplBases = escribirBloque(out, posicion, sec.obtenerBases(), e.numBases);
+        BYTES_FASE(e.numBases);
+        
+        // Solo grafos al día con su secuencia (actualizarGrafos los mantiene así)
+        const Grafo* grafo = grafos.obtener(catalogo.nombre(secuencias, k));
+        if (grafo && grafo->obtenerNumNodos() == sec.obtenerNumBases() &&
+            grafo->obtenerColumnas() == sec.obtenerColumnas()) {
+            int n = grafo->obtenerNumNodos();
+            e.tieneGrafo = 1;
+            e.numAristas = grafo->obtenerNumAristas();
+            e.desplNodos = escribirBloque(out, posicion, grafo->obtenerNodos(), (uint64_t)n * sizeof(Nodo));
+            e.desplInicio = escribirBloque(out, posicion, grafo->obtenerInicioAristas(),
+                                           (uint64_t)(n + 1) * sizeof(int32_t));
+            e.desplAristas = escribirBloque(out, posicion, grafo->obtenerAristas(),
+                                            (uint64_t)e.numAristas * sizeof(Arista));
+            grafosGuardados++;
+        }
+    }
+    
+    cab.desplTabla = escribirBloque(out, posicion, tabla.data(), tabla.size() * sizeof(EntradaSesion));
+    cab.tamArchivo = posicion;
+    out.seekp(0);
+    out.write((const char*)&cab, sizeof(cab));
+    out.close();
+    if (!out) {
+        std::remove(temporal.c_str());
+        return false;
+    }
+    return std::rename(temporal.c_str(), archivo.c_str()) == 0;
+}
+
+// [despl, despl + bytes) dentro del archivo y alineado a 'alineacion'
+static bool rangoValido(uint64_t despl, uint64_t bytes, uint64_t total, uint64_t alineacion) {
+    return despl <= total && bytes <= total - despl && despl % alineacion == 0;
+}
+
+// El grafo guardado debe ser el que construiría Grafo::construir: el nodo i
+// está en la posición lineal i de la rejilla y el CSR es monótono, con
+// destinos dentro del grafo y pesos no negativos
+static bool grafoValido(const Nodo* nodos, const int32_t* inicio, const Arista* aristas,
+                        int32_t n, int32_t ancho, const char* bases) {
+    if (n > 0 && ancho <= 0) return false;
+    for (int32_t i = 0; i < n; i++) {
+        if (nodos[i].fila != i / ancho || nodos[i].col != i % ancho || nodos[i].base != bases[i] ||
+            inicio[i + 1] < inicio[i]) {
+            return false;
+        }
+    }
+    for (int32_t a = 0; a < inicio[n]; a++) {
+        if (aristas[a].destino < 0 || aristas[a].destino >= n ||
+            !std::isfinite(aristas[a].peso) || aristas[a].peso < 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool Sesion::abrir(const std::string& archivo, std::vector<Secuencia>& secuencias, Catalogo& catalogo,
+                   CacheGrafos& grafos, int& grafosAbiertos, bool verificar) {
+    MEDIR_FASE("sesion.apertura");
+    grafosAbiertos = 0;
+    
+    int fd = open(archivo.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+    struct stat info;
+    if (fstat(fd, &info) != 0 || (uint64_t)info.st_size < sizeof(CabeceraSesion)) {
+        close(fd);
+        return false;
+    }
+    uint64_t total = info.st_size;
+    void* direccion = mmap(nullptr, total, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (direccion == MAP_FAILED) return false;
+    std::shared_ptr<const void> mapeo(direccion, [total](const void* p) {
+        munmap(const_cast<void*>(p), total);
+    });
+    const char* base = (const char*)direccion;
+    
+    const CabeceraSesion& cab = *(const CabeceraSesion*)base;
+    if (memcmp(cab.magia, "GSES", 4) != 0 || cab.version != VERSION_SESION ||
+        cab.marcaOrden != MARCA_ORDEN || cab.tamNodo != sizeof(Nodo) ||
+        cab.tamArista != sizeof(Arista) || cab.tamArchivo != total ||
+        !rangoValido(cab.desplTabla, (uint64_t)cab.numSecuencias * sizeof(EntradaSesion),
+                     total, alignof(EntradaSesion))) {
+        return false;
+    }
+    const EntradaSesion* tabla = (const EntradaSesion*)(base + cab.desplTabla);
+    
+    // Validar todo antes de tocar el estado en memoria; sin 'verificar' el
+    // costo es por entrada de la tabla, no por base
+    for (uint32_t k = 0; k < cab.numSecuencias; k++) {
+        const EntradaSesion& e = tabla[k];
+        if (!rangoValido(e.desplDescripcion, e.largoDescripcion, total, 1) ||
+            !rangoValido(e.desplBases, e.numBases, total, 1) ||
+            e.numBases > 0x7fffffffu || e.anchoLinea < 0 || e.alfabeto > ALFABETO_BYTES) {
+            return false;
+        }
+        if (!e.tieneGrafo) continue;
+        uint64_t n = e.numBases;
+        if (e.numAristas < 0 ||
+            !rangoValido(e.desplNodos, n * sizeof(Nodo), total, alignof(Nodo)) ||
+            !rangoValido(e.desplInicio, (n + 1) * sizeof(int32_t), total, alignof(int32_t)) ||
+            !rangoValido(e.desplAristas, (uint64_t)e.numAristas * sizeof(Arista), total, alignof(Arista))) {
+            return false;
+        }
+        const int32_t* inicio = (const int32_t*)(base + e.desplInicio);
+        if (inicio[0] != 0 || inicio[n] != e.numAristas ||
+            (verificar && !grafoValido((const Nodo*)(base + e.desplNodos), inicio,
+                                       (const Arista*)(base + e.desplAristas),
+                                       (int32_t)n, e.anchoLinea, base + e.desplBases))) {
+            return false;
+        }
+    }
+    
+    std::vector<Secuencia> nuevas;
+    nuevas.reserve(cab.numSecuencias);
+    for (uint32_t k = 0; k < cab.numSecuencias; k++) {
+        const EntradaSesion& e = tabla[k];
+        nuevas.push_back(Secuencia(std::string(base + e.desplDescripcion, e.largoDescripcion),
+                                   base + e.desplBases, e.numBases, e.anchoLinea, mapeo,
+                                   (TipoAlfabeto)e.alfabeto));
+    }
+    
+    secuencias.swap(nuevas);
+    catalogo.reemplazar(secuencias, archivo);
+    grafos.limpiar();
+    for (uint32_t k = 0; k < cab.numSecuencias; k++) {
+        const EntradaSesion& e = tabla[k];
+        if (!e.tieneGrafo) continue;
+        std::string nombre = catalogo.nombre(secuencias, k);
+        Grafo& grafo = grafos.reservar(nombre);
+        grafo.adoptar(secuencias[k], (const Nodo*)(base + e.desplNodos), (const int*)(base + e.desplInicio),
+                      (const Arista*)(base + e.desplAristas), e.numAristas, mapeo);
+        grafos.registrar(nombre);
+        grafosAbiertos++;
+    }
+    return true;
+}
@@ -0,0 +1,37 @@
+// ============================================
+// ARCHIVO: Sesion.h
+// ============================================
+#ifndef SESION_H
+#define SESION_H
+
+#include "Secuencia.h"
+#include "CacheGrafos.h"
+#include "Catalogo.h"
+#include <string>
+#include <vector>
+
+// Instantánea binaria de la sesión, pensada para mapearse en memoria:
+//   cabecera: "GSES", versión, marca de orden de bytes (0x01020304),
+//             tamaños de Nodo y Arista, número de secuencias, tamaño del
+//             archivo y desplazamiento de la tabla de secuencias
+//   datos:    por secuencia, la descripción, las bases (con las máscaras
+//             ya aplicadas) y, si estaba en la caché, su grafo en CSR
+//             (nodos, inicio de aristas, aristas); cada bloque alineado a 64
+//   tabla:    una entrada por secuencia con desplazamientos y tamaños
+// Al abrirla, secuencias y grafos apuntan directamente a las páginas del
+// archivo (compartidas entre procesos); se copian solo si se modifican.
+// Abrir comprueba la cabecera y que cada bloque de la tabla caiga dentro
+// del archivo y alineado, sin leer los bloques; 'verificar' además recorre
+// todos los nodos y aristas de cada grafo antes de aceptarlo.
+// En la caché cada grafo está bajo el nombre de su secuencia en el
+// catálogo; abrir reemplaza el catálogo por las secuencias de la sesión,
+// todas con 'archivo' como origen, y registra los grafos con esos nombres.
+class Sesion {
+public:
+    static bool guardar(const std::string& archivo, const std::vector<Secuencia>& secuencias,
+                        const Catalogo& catalogo, CacheGrafos& grafos, int& grafosGuardados);
+    static bool abrir(const std::string& archivo, std::vector<Secuencia>& secuencias, Catalogo& catalogo,
+                      CacheGrafos& grafos, int& grafosAbiertos, bool verificar = false);
+};
+
+#endif
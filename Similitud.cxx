@@ -0,0 +1,159 @@
+// ============================================
+// ARCHIVO: Similitud.cxx
+// ============================================
+#include "Similitud.h"
+#include "PoolHilos.h"
+#include "Instrumentacion.h"
+#include "CodigosKmers.h"
+#include <algorithm>
+#include <cmath>
+
+static const int FILAS_POR_TAREA = 16;
+
+// Deja los 'tamano' menores hashes distintos y devuelve el umbral para los
+// siguientes: solo entra un hash menor que el mayor guardado
+static uint64_t recortar(std::vector<uint64_t>& hashes, int tamano) {
+    std::sort(hashes.begin(), hashes.end());
+    hashes.erase(std::unique(hashes.begin(), hashes.end()), hashes.end());
+    if ((int)hashes.size() < tamano) return ~0ULL;
+    hashes.resize(tamano);
+    return hashes.back();
+}
+
+Boceto Similitud::bocetarSecuencia(const Secuencia& sec, int k, int tamano) {
+    Boceto b;
+    b.identidad = sec.obtenerIdentidad();
+    b.version = sec.obtenerVersion();
+    b.k = k;
+    b.tamano = tamano;
+    b.numKmers = 0;
+    
+    const uint64_t mascara = k == 32 ? ~0ULL : ((1ULL << (2 * k)) - 1);
+    const int desplazamiento = 2 * (k - 1);
+    const char* bases = sec.obtenerBases();
+    size_t n = sec.obtenerNumBases();
+    uint64_t directo = 0, reverso = 0, umbral = ~0ULL;
+    int validas = 0;
+    
+    std::vector<uint64_t>& hashes = b.hashes;
+    hashes.reserve(4 * tamano);
+    for (size_t i = 0; i < n; i++) {
+        int c = CodigosKmers<>::CODIGO[(unsigned char)bases[i]];
+        if (c < 0) {
+            validas = 0;
+            continue;
+        }
+        directo = ((directo << 2) | c) & mascara;
+        reverso = (reverso >> 2) | ((uint64_t)(3 - c) << desplazamiento);
+        if (++validas < k) continue;
+        
+        b.numKmers++;
+        uint64_t h = mezclar(std::min(directo, reverso));
+        if (h >= umbral) continue;
+        hashes.push_back(h);
+        if ((int)hashes.size() >= 4 * tamano) umbral = recortar(hashes, tamano);
+    }
+    recortar(hashes, tamano);
+    hashes.shrink_to_fit();
+    return b;
+}
+
+std::vector<std::shared_ptr<const Boceto>> Similitud::bocetar(const std::vector<Secuencia>& secuencias, int k,
+                                                              int tamano, int numHilos, int& calculados) {
+    MEDIR_FASE("similitud.bocetos");
+    std::lock_guard<std::mutex> lock(mtx);
+    std::vector<std::shared_ptr<const Boceto>> bocetos(secuencias.size());
+    std::vector<size_t> pendientes;
+    
+    for (size_t s = 0; s < secuencias.size(); s++) {
+        auto it = cache.find(secuencias[s].obtenerIdentidad());
+        if (it != cache.end() && it->second->version == secuencias[s].obtenerVersion() &&
+            it->second->k == k && it->second->tamano == tamano) {
+            bocetos[s] = it->second;
+        } else {
+            pendientes.push_back(s);
+            BYTES_FASE(secuencias[s].obtenerNumBases());
+        }
+    }
+    
+    PoolHilos pool(numHilos);
+    for (size_t p : pendientes) {
+        pool.encolar([&, p](int) {
+            bocetos[p] = std::make_shared<const Boceto>(bocetarSecuencia(secuencias[p], k, tamano));
+        });
+    }
+    pool.esperarTodo();
+    calculados = pendientes.size();
+    
+    // La caché solo conserva las secuencias cargadas
+    cache.clear();
+    for (const auto& b : bocetos) cache[b->identidad] = b;
+    return bocetos;
+}
+
+// Recorre la unión ordenada de los dos bocetos hasta juntar 'tamano'
+// hashes, sin saltos dependientes de los datos en el bucle
+void Similitud::comparar(const Boceto& a, const Boceto& b, int& compartidos, int& comparados) {
+    const uint64_t* x = a.hashes.data();
+    const uint64_t* y = b.hashes.data();
+    size_t nx = a.hashes.size(), ny = b.hashes.size();
+    int limite = std::min(a.tamano, b.tamano);
+    size_t i = 0, j = 0;
+    int comunes = 0, tomados = 0;
+    
+    while (i < nx && j < ny && tomados < limite) {
+        uint64_t u = x[i], v = y[j];
+        comunes += u == v;
+        i += u <= v;
+        j += v <= u;
+        tomados++;
+    }
+    // Lo que queda de un solo boceto también es parte de la unión
+    size_t resto = (nx - i) + (ny - j);
+    tomados += std::min((size_t)(limite - tomados), resto);
+    compartidos = comunes;
+    comparados = tomados;
+}
+
+double Similitud::ani(double jaccard, int k) {
+    if (jaccard <= 0) return 0;
+    double distancia = -std::log(2 * jaccard / (1 + jaccard)) / k;
+    return std::max(0.0, 1 - distancia);
+}
+
+std::vector<ParSimilar> Similitud::todosContraTodos(const std::vector<std::shared_ptr<const Boceto>>& bocetos,
+                                                    double minimo, int numHilos) {
+    MEDIR_FASE("similitud.pares");
+    int n = bocetos.size();
+    std::vector<std::vector<ParSimilar>> parciales((n + FILAS_POR_TAREA - 1) / FILAS_POR_TAREA);
+    
+    PoolHilos pool(numHilos);
+    for (size_t t = 0; t < parciales.size(); t++) {
+        pool.encolar([&, t](int) {
+            int desde = t * FILAS_POR_TAREA;
+            int hasta = std::min(n, desde + FILAS_POR_TAREA);
+            for (int a = desde; a < hasta; a++) {
+                for (int b = a + 1; b < n; b++) {
+                    ParSimilar par;
+                    comparar(*bocetos[a], *bocetos[b], par.compartidos, par.comparados);
+                    if (par.compartidos == 0 || par.comparados == 0) continue;
+                    par.jaccard = (double)par.compartidos / par.comparados;
+                    if (par.jaccard < minimo) continue;
+                    par.a = a;
+                    par.b = b;
+                    par.ani = ani(par.jaccard, bocetos[a]->k);
+                    parciales[t].push_back(par);
+                }
+            }
+        });
+    }
+    pool.esperarTodo();
+    
+    std::vector<ParSimilar> pares;
+    for (const auto& p : parciales) pares.insert(pares.end(), p.begin(), p.end());
+    std::sort(pares.begin(), pares.end(), [](const ParSimilar& x, const ParSimilar& y) {
+        if (x.jaccard != y.jaccard) return x.jaccard > y.jaccard;
+        return x.a != y.a ? x.a < y.a : x.b < y.b;
+    });
+    return pares;
+}
@@ -0,0 +1,55 @@
+// ============================================
+// ARCHIVO: Similitud.h
+// ============================================
+#ifndef SIMILITUD_H
+#define SIMILITUD_H
+
+#include "Secuencia.h"
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+// Boceto MinHash (bottom-k) de los k-mers canónicos de una secuencia:
+// los 'tamano' menores hashes distintos, ordenados
+struct Boceto {
+    uint64_t identidad, version;    // secuencia de la que se calculó
+    int k, tamano;
+    uint64_t numKmers;              // ventanas válidas (sin N, IUPAC ni X)
+    std::vector<uint64_t> hashes;
+};
+
+struct ParSimilar {
+    int a, b;                       // índices en el vector de secuencias
+    double jaccard;
+    double ani;                     // 0 si no comparten ningún hash
+    int compartidos, comparados;
+};
+
+// Similitud de todas contra todas por bocetos MinHash. La Jaccard se
+// estima, como en Mash, con los 'tamano' menores hashes de la unión de dos
+// bocetos y la ANI con 1 + ln(2J / (1 + J)) / k. Los bocetos se guardan
+// hasta que su secuencia cambia de versión.
+class Similitud {
+private:
+    std::mutex mtx;
+    std::map<uint64_t, std::shared_ptr<const Boceto>> cache;    // por identidad
+
+public:
+    static const int K_POR_DEFECTO = 21;
+    static const int TAMANO_POR_DEFECTO = 1000;
+    
+    // Boceto de cada secuencia, en paralelo; 'calculados' cuenta los que
+    // no estaban en la caché
+    std::vector<std::shared_ptr<const Boceto>> bocetar(const std::vector<Secuencia>& secuencias, int k,
+                                                       int tamano, int numHilos, int& calculados);
+    static Boceto bocetarSecuencia(const Secuencia& sec, int k, int tamano);
+    static void comparar(const Boceto& a, const Boceto& b, int& compartidos, int& comparados);
+    static double ani(double jaccard, int k);
+    // Pares con Jaccard >= minimo y algún hash compartido, de mayor a menor
+    static std::vector<ParSimilar> todosContraTodos(const std::vector<std::shared_ptr<const Boceto>>& bocetos,
+                                                    double minimo, int numHilos);
+};
+
+#endif
@@ -4,13 +4,46 @@
 // ============================================
 #include "Utilidades.h"
 #include "ArbolHuffman.h"
+#include "Instrumentacion.h"
+#include "Compresion.h"
+#include "PoolHilos.h"
+#include "Crc32c.h"
+#include "ModeloHuffman.h"
 #include <sstream>
 #include <algorithm>
+#include <cstring>
+#include <mutex>
+#include <condition_variable>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
 
+// Lectura de un buffer en memoria como istream, sin copiarlo
+struct BufferMemoria : std::streambuf {
+    BufferMemoria(char* datos, size_t largo) { setg(datos, datos, datos + largo); }
+};
+
+// .gz y BGZF se reconocen por la firma, no por la extensión
 bool Utilidades::cargarFASTA(const std::string& archivo, std::vector<Secuencia>& secuencias) {
+    if (Compresion::esGzip(archivo)) {
+        std::string contenido;
+        if (!Compresion::descomprimir(archivo, contenido, PoolHilos::hilosPorDefecto())) return false;
+        BufferMemoria buffer(&contenido[0], contenido.size());
+        std::istream in(&buffer);
+        leerFASTA(in, secuencias);
+        return true;
+    }
+    
     std::ifstream file(archivo.c_str());
     if (!file.is_open()) return false;
-    
+    leerFASTA(file, secuencias);
+    file.close();
+    return true;
+}
+
+void Utilidades::leerFASTA(std::istream& file, std::vector<Secuencia>& secuencias) {
+    MEDIR_FASE("fasta.lectura");
     secuencias.clear();
     std::string linea, descripcion, datos;
     int anchoLinea = 0;
@@ -33,40 +66,143 @@ bool Utilidades::cargarFASTA(const std::string& archivo, std::vector<Secuencia>&
                 primeraLinea = false;
             }
             datos += linea;
+            BYTES_FASE(linea.length());
         }
     }
     
     if (!descripcion.empty()) {
         secuencias.push_back(Secuencia(descripcion, datos, anchoLinea));
     }
-    
-    file.close();
-    return true;
 }
 
-bool Utilidades::guardarFASTA(const std::string& archivo, const std::vector<Secuencia>& secuencias) {
-    std::ofstream file(archivo.c_str());
-    if (!file.is_open()) return false;
-    
+// Trozo de un registro FASTA que se formatea de una vez: bases
+// [desde, hasta) de una secuencia, empezando en un inicio de línea, y la
+// cabecera si es el primero del registro.
+struct TramoFASTA {
+    const Secuencia* sec;
+    int ancho;
+    bool cabecera;
+    size_t desde, hasta;
+    size_t bytes;
+};
+
+static const size_t BYTES_POR_TRAMO = 4 << 20;
+
+static std::vector<TramoFASTA> partirEnTramos(const std::vector<Secuencia>& secuencias) {
+    std::vector<TramoFASTA> tramos;
     for (const auto& sec : secuencias) {
-        file << ">" << sec.obtenerDescripcion() << "\n";
-        std::string datos = sec.obtenerDatos();
         int ancho = sec.obtenerAnchoLinea();
+        if (ancho <= 0) ancho = Utilidades::ANCHO_LINEA_POR_DEFECTO;
+        size_t n = sec.obtenerNumBases();
+        size_t paso = std::max((size_t)1, BYTES_POR_TRAMO / (ancho + 1)) * ancho;
+        size_t largoCabecera = sec.obtenerDescripcion().length() + 2;
         
-        for (int i = 0; i < (int)datos.length(); i += ancho) {
-            int len = std::min(ancho, (int)datos.length() - i);
-            file << datos.substr(i, len) << "\n";
+        size_t desde = 0;
+        do {
+            TramoFASTA t;
+            t.sec = &sec;
+            t.ancho = ancho;
+            t.cabecera = desde == 0;
+            t.desde = desde;
+            t.hasta = std::min(n, desde + paso);
+            size_t bases = t.hasta - t.desde;
+            t.bytes = (t.cabecera ? largoCabecera : 0) + bases + (bases + ancho - 1) / ancho;
+            tramos.push_back(t);
+            desde = t.hasta;
+        } while (desde < n);
+    }
+    return tramos;
+}
+
+// Escribe exactamente t.bytes en destino, copiando directo de las bases
+static void formatearTramo(const TramoFASTA& t, char* destino) {
+    char* p = destino;
+    if (t.cabecera) {
+        std::string descripcion = t.sec->obtenerDescripcion();
+        *p++ = '>';
+        memcpy(p, descripcion.data(), descripcion.length());
+        p += descripcion.length();
+        *p++ = '\n';
+    }
+    const char* bases = t.sec->obtenerBases();
+    for (size_t i = t.desde; i < t.hasta; i += t.ancho) {
+        size_t largo = std::min((size_t)t.ancho, t.hasta - i);
+        memcpy(p, bases + i, largo);
+        p += largo;
+        *p++ = '\n';
+    }
+}
+
+// Los hilos del pool formatean los tramos siguientes en un anillo de
+// buffers mientras este hilo escribe los ya listos en orden.
+static bool escribirTramos(std::ostream& out, const std::vector<TramoFASTA>& tramos, PoolHilos& pool) {
+    const size_t ventana = 2 * pool.obtenerNumHilos();
+    std::vector<std::string> buffers(ventana);
+    std::vector<char> listos(tramos.size(), 0);
+    std::mutex mtx;
+    std::condition_variable cv;
+    
+    auto encolar = [&](size_t k) {
+        pool.encolar([&, k](int) {
+            std::string& buffer = buffers[k % ventana];
+            buffer.resize(tramos[k].bytes);
+            formatearTramo(tramos[k], &buffer[0]);
+            std::lock_guard<std::mutex> lock(mtx);
+            listos[k] = 1;
+            cv.notify_all();
+        });
+    };
+    
+    size_t encolados = 0;
+    for (size_t k = 0; k < tramos.size(); k++) {
+        while (encolados < tramos.size() && encolados < k + ventana) {
+            encolar(encolados++);
         }
+        {
+            std::unique_lock<std::mutex> lock(mtx);
+            cv.wait(lock, [&] { return listos[k] != 0; });
+        }
+        const std::string& buffer = buffers[k % ventana];
+        out.write(buffer.data(), buffer.size());
+    }
+    pool.esperarTodo();
+    return (bool)out;
+}
+
+// Con extensión .gz o .bgz se escribe BGZF, legible también por gzip
+bool Utilidades::guardarFASTA(const std::string& archivo, const std::vector<Secuencia>& secuencias) {
+    MEDIR_FASE("fasta.escritura");
+    std::vector<TramoFASTA> tramos = partirEnTramos(secuencias);
+    PoolHilos pool(PoolHilos::hilosPorDefecto());
+    size_t total = 0;
+    for (const auto& t : tramos) total += t.bytes;
+    BYTES_FASE(total);
+    
+    if (Compresion::pideCompresion(archivo)) {
+        std::string texto(total, '\0');
+        size_t desplazamiento = 0;
+        for (const auto& t : tramos) {
+            char* destino = &texto[0] + desplazamiento;
+            pool.encolar([&t, destino](int) { formatearTramo(t, destino); });
+            desplazamiento += t.bytes;
+        }
+        pool.esperarTodo();
+        return Compresion::comprimirBGZF(archivo, texto, pool.obtenerNumHilos());
     }
     
+    std::ofstream file(archivo.c_str());
+    if (!file.is_open()) return false;
+    bool correcto = escribirTramos(file, tramos, pool);
     file.close();
-    return true;
+    return correcto && (bool)file;
 }
 
 int Utilidades::contarSubsecuencias(const std::vector<Secuencia>& secuencias, const std::string& sub) {
+    MEDIR_FASE("subsecuencias.conteo");
     int contador = 0;
     for (const auto& sec : secuencias) {
         std::string datos = sec.obtenerDatos();
+        BYTES_FASE(datos.length());
         size_t pos = 0;
         while ((pos = datos.find(sub, pos)) != std::string::npos) {
             contador++;
@@ -77,9 +213,11 @@ int Utilidades::contarSubsecuencias(const std::vector<Secuencia>& secuencias, co
 }
 
 int Utilidades::enmascararSubsecuencias(std::vector<Secuencia>& secuencias, const std::string& sub) {
+    MEDIR_FASE("subsecuencias.enmascarado");
     int contador = 0;
     for (auto& sec : secuencias) {
         std::string datos = sec.obtenerDatos();
+        BYTES_FASE(datos.length());
         size_t pos = 0;
         while ((pos = datos.find(sub, pos)) != std::string::npos) {
             for (size_t i = 0; i < sub.length(); i++) {
@@ -94,167 +232,321 @@ int Utilidades::enmascararSubsecuencias(std::vector<Secuencia>& secuencias, cons
 }
 
 std::map<char, uint64_t> Utilidades::calcularFrecuenciasGlobales(const std::vector<Secuencia>& secuencias) {
-    std::map<char, uint64_t> frecuencias;
+    MEDIR_FASE("huffman.frecuencias");
+    uint64_t totales[256] = {};
     for (const auto& sec : secuencias) {
-        std::string datos = sec.obtenerDatos();
-        for (char c : datos) {
-            frecuencias[c]++;
-        }
+        uint64_t cuentas[256];
+        Alfabeto::contar(sec.obtenerAlfabeto(), sec.obtenerBases(), sec.obtenerNumBases(), cuentas);
+        BYTES_FASE(sec.obtenerNumBases());
+        for (int c = 0; c < 256; c++) totales[c] += cuentas[c];
+    }
+    std::map<char, uint64_t> frecuencias;
+    for (int c = 0; c < 256; c++) {
+        if (totales[c] > 0) frecuencias[(char)c] = totales[c];
     }
     return frecuencias;
 }
 
-void Utilidades::escribirBits(std::ofstream& out, const std::string& bits, std::string& buffer) {
-    buffer += bits;
-    while (buffer.length() >= 8) {
-        unsigned char byte = 0;
-        for (int i = 0; i < 8; i++) {
-            if (buffer[i] == '1') {
-                byte |= (1 << (7 - i));
-            }
+// .fabin, versión 2:
+//   prefijo:  "FABN", versión, CRC32C del resto de la cabecera y largo
+//             total de la cabecera (uint32 cada uno)
+//   cabecera: tabla de frecuencias (uint16 y 9 bytes por símbolo), o
+//             0xffff y el identificador de un modelo entrenado, número
+//             de secuencias y, por cada una, descripción, número de bases,
+//             ancho de línea, bytes de su bloque y CRC32C del bloque
+//   bloques:  los bits de cada secuencia, alineados a byte
+// Con la cabecera validada se sabe dónde está cada bloque, así que un
+// bloque dañado no impide leer los demás.
+static const uint32_t VERSION_FABIN = 2;
+static const uint32_t PREFIJO_FABIN = 16;
+static const uint32_t CABECERA_FABIN_MAXIMA = 1u << 30;
+static const uint16_t TABLA_EN_MODELO = 0xffff;
+
+struct BloqueFabin {
+    std::string descripcion;
+    uint64_t longitud;
+    uint16_t ancho;
+    uint64_t despl, bytes;
+    uint32_t crc;
+};
+
+struct CabeceraFabin {
+    bool usaModelo;
+    uint32_t modelo;
+    std::map<char, uint64_t> frecuencias;
+    std::vector<BloqueFabin> bloques;
+};
+
+template <typename T>
+static void agregar(std::string& destino, const T& valor) {
+    destino.append((const char*)&valor, sizeof(T));
+}
+
+// Lectura con límites de una cabecera ya cargada en memoria
+struct LectorCabecera {
+    const std::string& datos;
+    size_t pos;
+    bool correcto;
+    
+    LectorCabecera(const std::string& d, size_t inicio) : datos(d), pos(inicio), correcto(true) {}
+    
+    template <typename T>
+    T leer() {
+        T valor = T();
+        if (!correcto || datos.size() - pos < sizeof(T)) {
+            correcto = false;
+            return valor;
         }
-        out.write((char*)&byte, 1);
-        buffer = buffer.substr(8);
+        memcpy(&valor, datos.data() + pos, sizeof(T));
+        pos += sizeof(T);
+        return valor;
     }
+    std::string leerTexto(size_t largo) {
+        if (!correcto || datos.size() - pos < largo) {
+            correcto = false;
+            return std::string();
+        }
+        pos += largo;
+        return datos.substr(pos - largo, largo);
+    }
+};
+
+static std::string empaquetarBits(const std::string& bits) {
+    MEDIR_FASE("huffman.escritura_bits");
+    BYTES_FASE(bits.length() / 8);
+    std::string bytes((bits.length() + 7) / 8, '\0');
+    for (size_t i = 0; i < bits.length(); i++) {
+        if (bits[i] == '1') bytes[i / 8] |= (char)(1 << (7 - i % 8));
+    }
+    return bytes;
 }
 
-void Utilidades::finalizarBuffer(std::ofstream& out, std::string& buffer) {
-    if (!buffer.empty()) {
-        while (buffer.length() < 8) {
-            buffer += '0';
-        }
-        unsigned char byte = 0;
-        for (int i = 0; i < 8; i++) {
-            if (buffer[i] == '1') {
-                byte |= (1 << (7 - i));
-            }
+static std::string desempaquetarBits(const std::string& bytes) {
+    MEDIR_FASE("huffman.lectura_bits");
+    BYTES_FASE(bytes.length());
+    std::string bits(bytes.length() * 8, '0');
+    for (size_t i = 0; i < bytes.length(); i++) {
+        unsigned char byte = bytes[i];
+        for (int b = 0; b < 8; b++) {
+            if ((byte >> (7 - b)) & 1) bits[i * 8 + b] = '1';
         }
-        out.write((char*)&byte, 1);
     }
+    return bits;
 }
 
-bool Utilidades::codificarHuffman(const std::string& archivo, const std::vector<Secuencia>& secuencias) {
-    std::ofstream out(archivo.c_str(), std::ios::binary);
-    if (!out.is_open()) return false;
-    
-    auto frecuencias = calcularFrecuenciasGlobales(secuencias);
+// Lee y valida el prefijo y la cabecera; deja 'in' al inicio de los bloques
+static bool leerCabeceraFabin(std::istream& in, CabeceraFabin& cab) {
+    char prefijo[PREFIJO_FABIN];
+    if (!in.read(prefijo, PREFIJO_FABIN) || memcmp(prefijo, "FABN", 4) != 0) return false;
+    uint32_t version, crc, largo;
+    memcpy(&version, prefijo + 4, 4);
+    memcpy(&crc, prefijo + 8, 4);
+    memcpy(&largo, prefijo + 12, 4);
+    if (version != VERSION_FABIN || largo < PREFIJO_FABIN || largo > CABECERA_FABIN_MAXIMA) return false;
     
-    uint16_t n = frecuencias.size();
-    out.write((char*)&n, 2);
+    std::string cabecera(prefijo, PREFIJO_FABIN);
+    cabecera.resize(largo);
+    if (!in.read(&cabecera[PREFIJO_FABIN], largo - PREFIJO_FABIN)) return false;
+    if (Crc32c::calcular(cabecera.data() + PREFIJO_FABIN, largo - PREFIJO_FABIN) != crc) return false;
     
-    for (const auto& par : frecuencias) {
-        uint8_t codigo = par.first;
-        uint64_t freq = par.second;
-        out.write((char*)&codigo, 1);
-        out.write((char*)&freq, 8);
+    LectorCabecera lector(cabecera, PREFIJO_FABIN);
+    uint16_t n = lector.leer<uint16_t>();
+    cab.usaModelo = n == TABLA_EN_MODELO;
+    cab.modelo = cab.usaModelo ? lector.leer<uint32_t>() : 0;
+    for (int i = 0; i < n && !cab.usaModelo; i++) {
+        uint8_t codigo = lector.leer<uint8_t>();
+        cab.frecuencias[(char)codigo] = lector.leer<uint64_t>();
     }
+    uint32_t ns = lector.leer<uint32_t>();
+    uint64_t despl = largo;
+    for (uint32_t i = 0; i < ns && lector.correcto; i++) {
+        BloqueFabin b;
+        b.descripcion = lector.leerTexto(lector.leer<uint16_t>());
+        b.longitud = lector.leer<uint64_t>();
+        b.ancho = lector.leer<uint16_t>();
+        b.bytes = lector.leer<uint64_t>();
+        b.crc = lector.leer<uint32_t>();
+        b.despl = despl;
+        despl += b.bytes;
+        cab.bloques.push_back(b);
+    }
+    return lector.correcto && lector.pos == largo;
+}
+
+bool Utilidades::codificarHuffman(const std::string& archivo, const std::vector<Secuencia>& secuencias,
+                                  const ModeloHuffman* modelo) {
+    if (modelo && !modelo->cubre(secuencias)) return false;
+    std::map<char, uint64_t> frecuencias;
+    ArbolHuffman propio;
+    if (!modelo) {
+        frecuencias = calcularFrecuenciasGlobales(secuencias);
+        propio.construir(frecuencias);
+    }
+    const ArbolHuffman& arbol = modelo ? modelo->obtenerArbol() : propio;
     
-    ArbolHuffman arbol;
-    arbol.construir(frecuencias);
-    
-    uint32_t ns = secuencias.size();
-    out.write((char*)&ns, 4);
-    
-    std::string buffer;
-    
+    // Los bloques van antes en memoria porque la cabecera lleva sus tamaños y CRC
+    std::vector<std::string> bloques;
+    bloques.reserve(secuencias.size());
     for (const auto& sec : secuencias) {
-        std::string desc = sec.obtenerDescripcion();
-        uint16_t len = desc.length();
-        out.write((char*)&len, 2);
-        out.write(desc.c_str(), len);
-        
-        uint64_t longitud = sec.obtenerNumBases();
-        out.write((char*)&longitud, 8);
-        
-        uint16_t ancho = sec.obtenerAnchoLinea();
-        out.write((char*)&ancho, 2);
-        
-        std::string codificado = arbol.codificar(sec.obtenerDatos());
-        escribirBits(out, codificado, buffer);
+        bloques.push_back(empaquetarBits(arbol.codificar(sec.obtenerDatos())));
+    }
+    
+    std::string cabecera(PREFIJO_FABIN, '\0');
+    if (modelo) {
+        agregar(cabecera, TABLA_EN_MODELO);
+        agregar(cabecera, modelo->obtenerId());
+    } else {
+        agregar(cabecera, (uint16_t)frecuencias.size());
+        for (const auto& par : frecuencias) {
+            agregar(cabecera, (uint8_t)par.first);
+            agregar(cabecera, (uint64_t)par.second);
+        }
+    }
+    agregar(cabecera, (uint32_t)secuencias.size());
+    for (size_t i = 0; i < secuencias.size(); i++) {
+        const Secuencia& sec = secuencias[i];
+        const std::string& desc = sec.obtenerDescripcion();
+        uint16_t len = std::min(desc.length(), (size_t)UINT16_MAX);
+        agregar(cabecera, len);
+        cabecera.append(desc, 0, len);
+        agregar(cabecera, (uint64_t)sec.obtenerNumBases());
+        agregar(cabecera, (uint16_t)sec.obtenerAnchoLinea());
+        agregar(cabecera, (uint64_t)bloques[i].size());
+        agregar(cabecera, Crc32c::calcular(bloques[i].data(), bloques[i].size()));
     }
+    if (cabecera.size() > CABECERA_FABIN_MAXIMA) return false;
     
-    finalizarBuffer(out, buffer);
+    uint32_t largo = cabecera.size();
+    uint32_t crc = Crc32c::calcular(cabecera.data() + PREFIJO_FABIN, largo - PREFIJO_FABIN);
+    memcpy(&cabecera[0], "FABN", 4);
+    memcpy(&cabecera[4], &VERSION_FABIN, 4);
+    memcpy(&cabecera[8], &crc, 4);
+    memcpy(&cabecera[12], &largo, 4);
+    
+    std::ofstream out(archivo.c_str(), std::ios::binary);
+    if (!out.is_open()) return false;
+    out.write(cabecera.data(), cabecera.size());
+    for (const auto& bloque : bloques) out.write(bloque.data(), bloque.size());
     out.close();
-    return true;
+    return (bool)out;
 }
 
-std::string Utilidades::leerBits(std::ifstream& in, int numBits) {
-    std::string resultado;
-    static unsigned char byteActual = 0;
-    static int bitsRestantes = 0;
+// Cada bloque se comprueba al leerlo, justo antes de decodificarlo
+bool Utilidades::decodificarHuffman(const std::string& archivo, std::vector<Secuencia>& secuencias,
+                                    VerificacionFabin* informe, bool rescatar, const RegistroModelos* modelos) {
+    VerificacionFabin propio;
+    VerificacionFabin& r = informe ? *informe : propio;
+    r = VerificacionFabin();
     
-    while (numBits > 0) {
-        if (bitsRestantes == 0) {
-            if (!in.read((char*)&byteActual, 1)) {
-                break;
-            }
-            bitsRestantes = 8;
+    std::ifstream in(archivo.c_str(), std::ios::binary);
+    if (!in.is_open()) return false;
+    in.seekg(0, std::ios::end);
+    uint64_t tamano = in.tellg();
+    in.seekg(0);
+    
+    CabeceraFabin cab;
+    if (!leerCabeceraFabin(in, cab)) return false;
+    r.cabeceraValida = true;
+    r.usaModelo = cab.usaModelo;
+    r.modelo = cab.modelo;
+    for (const auto& b : cab.bloques) r.descripciones.push_back(b.descripcion);
+    
+    std::shared_ptr<const ModeloHuffman> modelo;
+    ArbolHuffman arbolPropio;
+    if (cab.usaModelo) {
+        modelo = modelos ? modelos->buscar(cab.modelo) : nullptr;
+        if (!modelo) {
+            r.faltaModelo = true;
+            return false;
         }
+    } else {
+        arbolPropio.construir(cab.frecuencias);
+    }
+    const ArbolHuffman& arbol = modelo ? modelo->obtenerArbol() : arbolPropio;
+    
+    std::vector<Secuencia> nuevas;
+    nuevas.reserve(cab.bloques.size());
+    std::string bloque;
+    for (uint32_t i = 0; i < cab.bloques.size(); i++) {
+        const BloqueFabin& b = cab.bloques[i];
+        r.bytes += b.bytes;
         
-        int bit = (byteActual >> (bitsRestantes - 1)) & 1;
-        resultado += (bit ? '1' : '0');
-        bitsRestantes--;
-        numBits--;
+        bool intacto = b.despl <= tamano && b.bytes <= tamano - b.despl;
+        if (intacto) {
+            bloque.resize(b.bytes);
+            in.seekg(b.despl);
+            intacto = (bool)in.read(&bloque[0], b.bytes) &&
+                      Crc32c::calcular(bloque.data(), bloque.size()) == b.crc;
+        }
+        std::string datos;
+        if (intacto) {
+            datos = arbol.decodificar(desempaquetarBits(bloque));
+            intacto = datos.length() >= b.longitud;
+        }
+        if (!intacto) {
+            r.danadas.push_back(i);
+            if (!rescatar) return false;
+            in.clear();
+            continue;
+        }
+        datos.resize(b.longitud);
+        nuevas.push_back(Secuencia(b.descripcion, datos, b.ancho));
     }
     
-    return resultado;
+    secuencias.swap(nuevas);
+    return true;
 }
 
-bool Utilidades::decodificarHuffman(const std::string& archivo, std::vector<Secuencia>& secuencias) {
+// Solo CRC, sin decodificar: los bloques se reparten entre los hilos sobre
+// el archivo mapeado
+bool Utilidades::verificarFabin(const std::string& archivo, VerificacionFabin& r, int numHilos) {
+    MEDIR_FASE("fabin.verificacion");
+    r = VerificacionFabin();
+    
     std::ifstream in(archivo.c_str(), std::ios::binary);
     if (!in.is_open()) return false;
+    CabeceraFabin cab;
+    bool cabeceraValida = leerCabeceraFabin(in, cab);
+    in.close();
+    if (!cabeceraValida) return true;
+    r.cabeceraValida = true;
+    r.usaModelo = cab.usaModelo;
+    r.modelo = cab.modelo;
     
-    uint16_t n;
-    in.read((char*)&n, 2);
-    
-    std::map<char, uint64_t> frecuencias;
-    for (int i = 0; i < n; i++) {
-        uint8_t codigo;
-        uint64_t freq;
-        in.read((char*)&codigo, 1);
-        in.read((char*)&freq, 8);
-        frecuencias[(char)codigo] = freq;
+    int fd = open(archivo.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+    struct stat info;
+    if (fstat(fd, &info) != 0) {
+        close(fd);
+        return false;
     }
+    uint64_t tamano = info.st_size;
+    void* direccion = tamano > 0 ? mmap(nullptr, tamano, PROT_READ, MAP_SHARED, fd, 0) : nullptr;
+    close(fd);
+    if (direccion == MAP_FAILED) return false;
+    const char* base = (const char*)direccion;
     
-    ArbolHuffman arbol;
-    arbol.construir(frecuencias);
-    
-    uint32_t ns;
-    in.read((char*)&ns, 4);
-    
-    secuencias.clear();
-    
-    for (uint32_t i = 0; i < ns; i++) {
-        uint16_t len;
-        in.read((char*)&len, 2);
-        
-        char* desc = new char[len + 1];
-        in.read(desc, len);
-        desc[len] = '\0';
-        std::string descripcion(desc);
-        delete[] desc;
-        
-        uint64_t longitud;
-        in.read((char*)&longitud, 8);
-        
-        uint16_t ancho;
-        in.read((char*)&ancho, 2);
-        
-        std::string binario;
-        while (binario.length() < longitud * 10) {
-            unsigned char byte;
-            if (!in.read((char*)&byte, 1)) break;
-            for (int b = 7; b >= 0; b--) {
-                binario += ((byte >> b) & 1) ? '1' : '0';
-            }
+    size_t ns = cab.bloques.size();
+    std::vector<char> intacto(ns, 0);
+    {
+        PoolHilos pool(numHilos);
+        for (size_t i = 0; i < ns; i++) {
+            const BloqueFabin& b = cab.bloques[i];
+            r.descripciones.push_back(b.descripcion);
+            if (b.despl > tamano || b.bytes > tamano - b.despl) continue;
+            r.bytes += b.bytes;
+            pool.encolar([&, i](int) {
+                const BloqueFabin& b = cab.bloques[i];
+                intacto[i] = Crc32c::calcular(base + b.despl, b.bytes) == b.crc;
+            });
         }
-        
-        std::string datos = arbol.decodificar(binario);
-        datos = datos.substr(0, longitud);
-        
-        secuencias.push_back(Secuencia(descripcion, datos, ancho));
+        pool.esperarTodo();
     }
+    BYTES_FASE(r.bytes);
+    if (direccion) munmap(direccion, tamano);
     
-    in.close();
+    for (size_t i = 0; i < ns; i++) {
+        if (!intacto[i]) r.danadas.push_back(i);
+    }
     return true;
 }
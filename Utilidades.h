@@ -9,20 +9,47 @@
 #include <vector>
 #include <string>
 #include <fstream>
+#include <iostream>
+
+class ModeloHuffman;
+class RegistroModelos;
+
+// Resultado de comprobar un .fabin: la cabecera y el CRC de cada bloque
+struct VerificacionFabin {
+    bool cabeceraValida;
+    bool usaModelo;                     // la tabla es un modelo externo
+    uint32_t modelo;                    // su identificador
+    bool faltaModelo;                   // y no estaba registrado
+    std::vector<std::string> descripciones;
+    std::vector<uint32_t> danadas;      // índices de las secuencias con el bloque dañado
+    uint64_t bytes;                     // bytes de bloques comprobados
+    VerificacionFabin() : cabeceraValida(false), usaModelo(false), modelo(0), faltaModelo(false), bytes(0) {}
+};
 
 class Utilidades {
 public:
+    // Ancho de línea al guardar secuencias que no tienen uno (p. ej. vacías al cargar)
+    static const int ANCHO_LINEA_POR_DEFECTO = 60;
+    
     static bool cargarFASTA(const std::string& archivo, std::vector<Secuencia>& secuencias);
     static bool guardarFASTA(const std::string& archivo, const std::vector<Secuencia>& secuencias);
     static int contarSubsecuencias(const std::vector<Secuencia>& secuencias, const std::string& sub);
     static int enmascararSubsecuencias(std::vector<Secuencia>& secuencias, const std::string& sub);
     static std::map<char, uint64_t> calcularFrecuenciasGlobales(const std::vector<Secuencia>& secuencias);
-    static bool codificarHuffman(const std::string& archivo, const std::vector<Secuencia>& secuencias);
-    static bool decodificarHuffman(const std::string& archivo, std::vector<Secuencia>& secuencias);
+    // Con 'modelo' el archivo guarda su identificador en lugar de la tabla;
+    // falla si el modelo no cubre las secuencias
+    static bool codificarHuffman(const std::string& archivo, const std::vector<Secuencia>& secuencias,
+                                 const ModeloHuffman* modelo = nullptr);
+    // Falla en el primer bloque dañado sin tocar 'secuencias', salvo con
+    // 'rescatar', que carga los intactos y salta los demás. Los archivos
+    // codificados con un modelo lo buscan en 'modelos'.
+    static bool decodificarHuffman(const std::string& archivo, std::vector<Secuencia>& secuencias,
+                                   VerificacionFabin* informe = nullptr, bool rescatar = false,
+                                   const RegistroModelos* modelos = nullptr);
+    // false solo si no se puede leer el archivo
+    static bool verificarFabin(const std::string& archivo, VerificacionFabin& resultado, int numHilos);
 private:
-    static void escribirBits(std::ofstream& out, const std::string& bits, std::string& buffer);
-    static void finalizarBuffer(std::ofstream& out, std::string& buffer);
-    static std::string leerBits(std::ifstream& in, int numBits);
+    static void leerFASTA(std::istream& in, std::vector<Secuencia>& secuencias);
 };
 
 #endif
@@ -0,0 +1,424 @@
+// ============================================
+// ARCHIVO: benchmark.cpp
+// ============================================
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <cstdlib>
+#include <cstdio>
+#include <cmath>
+#include <cstring>
+#include <chrono>
+#include <random>
+#include <algorithm>
+#include <functional>
+#include <sys/resource.h>
+#include "Secuencia.h"
+#include "Grafo.h"
+#include "Utilidades.h"
+#include "PoolHilos.h"
+#include "GeneradorGenomas.h"
+#include "BusquedaAproximada.h"
+#include "BusquedaIUPAC.h"
+#include "Similitud.h"
+#include "Composicion.h"
+#include "Alineamiento.h"
+#include "Crc32c.h"
+#include "ModeloHuffman.h"
+#include "GrafoTeselado.h"
+
+using namespace std;
+
+struct ResultadoCaso {
+    string nombre;
+    uint64_t bytes;
+    vector<double> tiempos;
+    long rssMaxKB;
+};
+
+// Lo que ahorra un modelo entrenado en muchos .fabin pequeños: con tabla
+// propia cada archivo repite sus frecuencias en la cabecera
+struct TamanosFabin {
+    uint64_t archivos;
+    uint64_t bytesPropios, bytesModelo;
+    uint64_t cabeceraPropia, cabeceraModelo;
+};
+
+struct ResultadoSSSP {
+    int nodos, hilos;
+    double tDijkstra, tDelta;
+    bool iguales;
+};
+
+static double segundosDesde(chrono::steady_clock::time_point inicio) {
+    return chrono::duration<double>(chrono::steady_clock::now() - inicio).count();
+}
+
+static long rssMaximoKB() {
+    struct rusage uso;
+    getrusage(RUSAGE_SELF, &uso);
+    return uso.ru_maxrss;
+}
+
+// Percentil por rango más cercano sobre tiempos ordenados
+static double percentil(const vector<double>& ordenados, double p) {
+    if (ordenados.empty()) return 0;
+    size_t rango = (size_t)ceil(p / 100.0 * ordenados.size());
+    if (rango < 1) rango = 1;
+    return ordenados[rango - 1];
+}
+
+// Ejecuta preparar() sin medir y luego caso() midiendo, 'repeticiones' veces
+static ResultadoCaso medir(const string& nombre, uint64_t bytes, int repeticiones,
+                           const function<void()>& preparar, const function<void()>& caso) {
+    ResultadoCaso r;
+    r.nombre = nombre;
+    r.bytes = bytes;
+    for (int k = 0; k < repeticiones; k++) {
+        preparar();
+        auto inicio = chrono::steady_clock::now();
+        caso();
+        r.tiempos.push_back(segundosDesde(inicio));
+    }
+    sort(r.tiempos.begin(), r.tiempos.end());
+    r.rssMaxKB = rssMaximoKB();
+    cerr << "  " << left << setw(26) << nombre << right << fixed << setprecision(4)
+         << percentil(r.tiempos, 50) << " s (p50)" << endl;
+    return r;
+}
+
+// Suma el tamaño del .fabin y el largo de su cabecera (uint32 en el byte 12)
+static void sumarTamanoFabin(const string& archivo, uint64_t& bytes, uint64_t& cabecera) {
+    ifstream in(archivo.c_str(), ios::binary);
+    char prefijo[16];
+    uint32_t largo = 0;
+    if (in.read(prefijo, sizeof(prefijo))) memcpy(&largo, prefijo + 12, 4);
+    in.seekg(0, ios::end);
+    bytes += in.tellg();
+    cabecera += largo;
+}
+
+// Escalado del SSSP: Dijkstra secuencial contra delta-stepping con
+// 1, 2, 4, ... hilos, verificando que las distancias sean idénticas
+static vector<ResultadoSSSP> benchSSSP(int ladoMax, double delta) {
+    vector<ResultadoSSSP> resultados;
+    int maxHilos = PoolHilos::hilosPorDefecto();
+    
+    for (int lado = 64; lado <= ladoMax; lado *= 2) {
+        Secuencia sec = GeneradorGenomas::rejilla(lado, 42);
+        Grafo grafo;
+        grafo.construir(sec);
+        int origen = grafo.obtenerIndice(lado / 2, lado / 2);
+        
+        auto inicio = chrono::steady_clock::now();
+        vector<double> referencia = grafo.distanciasDesde(origen);
+        double tSecuencial = segundosDesde(inicio);
+        
+        for (int hilos = 1; hilos <= maxHilos; hilos *= 2) {
+            inicio = chrono::steady_clock::now();
+            vector<double> dist = grafo.distanciasDeltaStepping(origen, hilos, delta);
+            
+            ResultadoSSSP r;
+            r.tDelta = segundosDesde(inicio);
+            r.nodos = grafo.obtenerNumNodos();
+            r.hilos = hilos;
+            r.tDijkstra = tSecuencial;
+            r.iguales = dist == referencia;
+            resultados.push_back(r);
+            
+            cerr << "  sssp " << r.nodos << " nodos, " << hilos << " hilos: " << fixed
+                 << setprecision(4) << r.tDelta << " s" << (r.iguales ? "" : " DISTINTAS") << endl;
+        }
+    }
+    return resultados;
+}
+
+static string escaparJSON(const string& s) {
+    string r;
+    for (char c : s) {
+        if (c == '"' || c == '\\') r += '\\';
+        r += c;
+    }
+    return r;
+}
+
+static void escribirJSON(ostream& out, const ParametrosGenoma& params, int repeticiones,
+                         const vector<ResultadoCaso>& casos, const TamanosFabin& pequenos,
+                         const vector<ResultadoSSSP>& sssp) {
+    out << fixed << setprecision(6);
+    out << "{\n";
+    out << "  \"parametros\": {\"bases\": " << params.totalBases
+        << ", \"registros\": " << params.numRegistros
+        << ", \"ancho_linea\": " << params.anchoLinea
+        << ", \"tasa_n\": " << params.tasaN
+        << ", \"tasa_iupac\": " << params.tasaIUPAC
+        << ", \"semilla\": " << params.semilla
+        << ", \"repeticiones\": " << repeticiones
+        << ", \"hilos\": " << PoolHilos::hilosPorDefecto() << "},\n";
+    out << "  \"rss_max_kb\": " << rssMaximoKB() << ",\n";
+    out << "  \"casos\": [\n";
+    for (size_t k = 0; k < casos.size(); k++) {
+        const ResultadoCaso& c = casos[k];
+        double p50 = percentil(c.tiempos, 50);
+        out << "    {\"nombre\": \"" << escaparJSON(c.nombre) << "\""
+            << ", \"bytes\": " << c.bytes
+            << ", \"min_s\": " << c.tiempos.front()
+            << ", \"p50_s\": " << p50
+            << ", \"p90_s\": " << percentil(c.tiempos, 90)
+            << ", \"p99_s\": " << percentil(c.tiempos, 99)
+            << ", \"max_s\": " << c.tiempos.back()
+            << ", \"mb_por_s\": " << (p50 > 0 ? c.bytes / p50 / 1e6 : 0)
+            << ", \"rss_max_kb\": " << c.rssMaxKB << "}"
+            << (k + 1 < casos.size() ? "," : "") << "\n";
+    }
+    out << "  ],\n";
+    out << "  \"huffman_pequenos\": {\"archivos\": " << pequenos.archivos
+        << ", \"bytes_tabla_propia\": " << pequenos.bytesPropios
+        << ", \"bytes_modelo\": " << pequenos.bytesModelo
+        << ", \"cabecera_tabla_propia\": " << pequenos.cabeceraPropia
+        << ", \"cabecera_modelo\": " << pequenos.cabeceraModelo << "},\n";
+    out << "  \"sssp\": [\n";
+    for (size_t k = 0; k < sssp.size(); k++) {
+        const ResultadoSSSP& r = sssp[k];
+        out << "    {\"nodos\": " << r.nodos << ", \"hilos\": " << r.hilos
+            << ", \"dijkstra_s\": " << r.tDijkstra << ", \"delta_stepping_s\": " << r.tDelta
+            << ", \"iguales\": " << (r.iguales ? "true" : "false") << "}"
+            << (k + 1 < sssp.size() ? "," : "") << "\n";
+    }
+    out << "  ]\n";
+    out << "}\n";
+}
+
+static void mostrarUso() {
+    cerr << "USO: genomas_bench [opciones]" << endl;
+    cerr << "  --bases <n>          bases totales del genoma sintético (4000000)" << endl;
+    cerr << "  --registros <n>      número de registros FASTA (4)" << endl;
+    cerr << "  --ancho <n>          ancho de línea (60)" << endl;
+    cerr << "  --tasa-n <p>         probabilidad de iniciar una racha de N (0.0005)" << endl;
+    cerr << "  --tasa-iupac <p>     probabilidad de un código IUPAC (0.001)" << endl;
+    cerr << "  --semilla <n>        semilla del generador (2025)" << endl;
+    cerr << "  --repeticiones <n>   repeticiones por caso (5)" << endl;
+    cerr << "  --bases-grafo <n>    bases del registro usado en los casos de grafo (250000)" << endl;
+    cerr << "  --lado-sssp <n>      lado máximo de las rejillas del escalado SSSP (512)" << endl;
+    cerr << "  --delta <d>          delta del SSSP paralelo (0.5)" << endl;
+    cerr << "  --salida <archivo>   archivo JSON (por defecto, salida estándar)" << endl;
+    cerr << "  --generar <archivo>  solo escribe el genoma sintético en FASTA y termina" << endl;
+}
+
+int main(int argc, char* argv[]) {
+    ParametrosGenoma params;
+    int repeticiones = 5;
+    int basesGrafo = 250000;
+    int ladoSSSP = 512;
+    double delta = 0.5;
+    string salida, soloGenerar;
+    
+    for (int k = 1; k < argc; k++) {
+        string opcion = argv[k];
+        if (k + 1 >= argc) {
+            mostrarUso();
+            return 2;
+        }
+        string valor = argv[++k];
+        if (opcion == "--bases") params.totalBases = strtoull(valor.c_str(), nullptr, 10);
+        else if (opcion == "--registros") params.numRegistros = atoi(valor.c_str());
+        else if (opcion == "--ancho") params.anchoLinea = atoi(valor.c_str());
+        else if (opcion == "--tasa-n") params.tasaN = atof(valor.c_str());
+        else if (opcion == "--tasa-iupac") params.tasaIUPAC = atof(valor.c_str());
+        else if (opcion == "--semilla") params.semilla = strtoull(valor.c_str(), nullptr, 10);
+        else if (opcion == "--repeticiones") repeticiones = max(1, atoi(valor.c_str()));
+        else if (opcion == "--bases-grafo") basesGrafo = atoi(valor.c_str());
+        else if (opcion == "--lado-sssp") ladoSSSP = atoi(valor.c_str());
+        else if (opcion == "--delta") delta = atof(valor.c_str());
+        else if (opcion == "--salida") salida = valor;
+        else if (opcion == "--generar") soloGenerar = valor;
+        else {
+            mostrarUso();
+            return 2;
+        }
+    }
+    if (params.anchoLinea < 1) params.anchoLinea = 60;
+    
+    vector<Secuencia> genoma = GeneradorGenomas::generar(params);
+    if (!soloGenerar.empty()) {
+        return Utilidades::guardarFASTA(soloGenerar, genoma) ? 0 : 1;
+    }
+    
+    const string archivoFASTA = "bench_sintetico.fa";
+    const string archivoSalidaFASTA = "bench_salida.fa";
+    const string archivoFabin = "bench_sintetico.fabin";
+    Utilidades::guardarFASTA(archivoFASTA, genoma);
+    
+    uint64_t totalBases = 0;
+    for (const auto& sec : genoma) totalBases += sec.obtenerNumBases();
+    
+    vector<ResultadoCaso> casos;
+    vector<Secuencia> trabajo;
+    auto nada = [] {};
+    auto copiarGenoma = [&] { trabajo = genoma; };
+    
+    cerr << "Genoma sintético: " << totalBases << " bases en " << genoma.size() << " registros" << endl;
+    
+    casos.push_back(medir("cargarFASTA", totalBases, repeticiones, nada, [&] {
+        Utilidades::cargarFASTA(archivoFASTA, trabajo);
+    }));
+    casos.push_back(medir("guardarFASTA", totalBases, repeticiones, nada, [&] {
+        Utilidades::guardarFASTA(archivoSalidaFASTA, genoma);
+    }));
+    casos.push_back(medir("calcularHistograma", totalBases, repeticiones, nada, [&] {
+        for (const auto& sec : genoma) sec.calcularHistograma();
+    }));
+    casos.push_back(medir("indiceComposicion", totalBases, repeticiones, nada, [&] {
+        for (const auto& sec : genoma) IndiceComposicion indice(sec);
+    }));
+    vector<IndiceComposicion> indices;
+    for (const auto& sec : genoma) indices.emplace_back(sec);
+    casos.push_back(medir("ventanasComposicion", totalBases, repeticiones, nada, [&] {
+        for (const auto& indice : indices) Composicion::ventanas(indice, 1000, 100);
+    }));
+    casos.push_back(medir("contarSubsecuencias", totalBases, repeticiones, nada, [&] {
+        Utilidades::contarSubsecuencias(genoma, "ACGTAC");
+    }));
+    casos.push_back(medir("busquedaAproximada", totalBases, repeticiones, nada, [&] {
+        BusquedaAproximada::contar(genoma, "ACGTACGTACGTACGTACGT", 2, DISTANCIA_EDICION,
+                                   PoolHilos::hilosPorDefecto());
+    }));
+    casos.push_back(medir("busquedaIUPAC", totalBases, repeticiones, nada, [&] {
+        BusquedaIUPAC::contar(genoma, "GANTTCRY", 0, DISTANCIA_EDICION, PoolHilos::hilosPorDefecto());
+    }));
+    casos.push_back(medir("bocetosMinHash", totalBases, repeticiones, nada, [&] {
+        Similitud similitud;
+        int calculados;
+        similitud.bocetar(genoma, Similitud::K_POR_DEFECTO, Similitud::TAMANO_POR_DEFECTO,
+                          PoolHilos::hilosPorDefecto(), calculados);
+    }));
+    // Todos contra todos entre 1000 bocetos que comparten parte de sus hashes
+    vector<shared_ptr<const Boceto>> bocetos;
+    mt19937_64 genBocetos(17);
+    vector<uint64_t> comunes(Similitud::TAMANO_POR_DEFECTO);
+    for (auto& h : comunes) h = genBocetos();
+    for (int b = 0; b < 1000; b++) {
+        Boceto boceto;
+        boceto.identidad = b;
+        boceto.version = 0;
+        boceto.k = Similitud::K_POR_DEFECTO;
+        boceto.tamano = Similitud::TAMANO_POR_DEFECTO;
+        boceto.numKmers = 0;
+        for (uint64_t h : comunes) boceto.hashes.push_back(genBocetos() % 4 == 0 ? genBocetos() : h);
+        sort(boceto.hashes.begin(), boceto.hashes.end());
+        bocetos.push_back(make_shared<const Boceto>(boceto));
+    }
+    casos.push_back(medir("similitudTodosContraTodos", (uint64_t)bocetos.size() * bocetos.size() / 2 *
+                          Similitud::TAMANO_POR_DEFECTO * sizeof(uint64_t), repeticiones, nada, [&] {
+        Similitud::todosContraTodos(bocetos, 0, PoolHilos::hilosPorDefecto());
+    }));
+    // Local solo puntaje entre dos tramos de 20000 bases; bytes son celdas
+    string tramoA = genoma[0].obtenerDatos().substr(0, 20000), tramoB = genoma[0].obtenerDatos().substr(10000, 20000);
+    ParametrosAlineamiento soloPuntaje;
+    soloPuntaje.soloPuntaje = true;
+    casos.push_back(medir("alineamientoLocal", (uint64_t)tramoA.length() * tramoB.length(), repeticiones, nada, [&] {
+        ResultadoAlineamiento r;
+        string error;
+        Alineamiento::alinear(tramoA.data(), tramoA.length(), tramoB.data(), tramoB.length(), soloPuntaje, r, error);
+    }));
+    casos.push_back(medir("enmascararSubsecuencias", totalBases, repeticiones, copiarGenoma, [&] {
+        Utilidades::enmascararSubsecuencias(trabajo, "ACGTAC");
+    }));
+    casos.push_back(medir("codificarHuffman", totalBases, repeticiones, nada, [&] {
+        Utilidades::codificarHuffman(archivoFabin, genoma);
+    }));
+    casos.push_back(medir("decodificarHuffman", totalBases, repeticiones, nada, [&] {
+        Utilidades::decodificarHuffman(archivoFabin, trabajo);
+    }));
+    vector<vector<Secuencia>> amplicones = GeneradorGenomas::amplicones(genoma[0], 2000, 300, 29);
+    vector<Secuencia> corpusAmplicones;
+    for (const auto& lote : amplicones) corpusAmplicones.push_back(lote[0]);
+    shared_ptr<const ModeloHuffman> modeloAmplicones = ModeloHuffman::entrenar(corpusAmplicones);
+    casos.push_back(medir("huffmanPequenos", 2000 * 300, repeticiones, nada, [&] {
+        for (const auto& lote : amplicones) Utilidades::codificarHuffman(archivoFabin, lote);
+    }));
+    casos.push_back(medir("huffmanPequenosModelo", 2000 * 300, repeticiones, nada, [&] {
+        for (const auto& lote : amplicones) Utilidades::codificarHuffman(archivoFabin, lote, modeloAmplicones.get());
+    }));
+    // El modelo no acelera la codificación; lo que cambia es el tamaño
+    TamanosFabin pequenos = {amplicones.size(), 0, 0, 0, 0};
+    for (const auto& lote : amplicones) {
+        Utilidades::codificarHuffman(archivoFabin, lote);
+        sumarTamanoFabin(archivoFabin, pequenos.bytesPropios, pequenos.cabeceraPropia);
+        Utilidades::codificarHuffman(archivoFabin, lote, modeloAmplicones.get());
+        sumarTamanoFabin(archivoFabin, pequenos.bytesModelo, pequenos.cabeceraModelo);
+    }
+    cerr << "  " << left << setw(26) << "tamanoHuffmanPequenos" << right << pequenos.bytesPropios << " -> "
+         << pequenos.bytesModelo << " bytes (cabeceras " << pequenos.cabeceraPropia << " -> "
+         << pequenos.cabeceraModelo << ")" << endl;
+    casos.push_back(medir("crc32c", totalBases, repeticiones, nada, [&] {
+        for (const auto& sec : genoma) Crc32c::calcular(sec.obtenerBases(), sec.obtenerNumBases());
+    }));
+    casos.push_back(medir("verificarFabin", totalBases, repeticiones, nada, [&] {
+        VerificacionFabin v;
+        Utilidades::verificarFabin(archivoFabin, v, PoolHilos::hilosPorDefecto());
+    }));
+    
+    // Casos de grafo sobre un registro recortado a basesGrafo bases
+    string datosGrafo = genoma[0].obtenerDatos().substr(0, basesGrafo);
+    Secuencia secGrafo(genoma[0].obtenerDescripcion(), datosGrafo, genoma[0].obtenerAnchoLinea());
+    Grafo grafo;
+    int ultimo = secGrafo.obtenerNumBases() - 1;
+    int filaFin = ultimo / secGrafo.obtenerColumnas();
+    int colFin = ultimo % secGrafo.obtenerColumnas();
+    
+    casos.push_back(medir("Grafo::construir", datosGrafo.length(), repeticiones, nada, [&] {
+        grafo.construir(secGrafo);
+    }));
+    int origen = grafo.obtenerIndice(0, 0);
+    int destino = grafo.obtenerIndice(filaFin, colFin);
+    casos.push_back(medir("dijkstra", datosGrafo.length(), repeticiones, nada, [&] {
+        double costo;
+        grafo.dijkstra(origen, destino, costo);
+    }));
+    casos.push_back(medir("base_remota", datosGrafo.length(), repeticiones, nada, [&] {
+        vector<double> dist = grafo.distanciasDeltaStepping(origen, PoolHilos::hilosPorDefecto(), delta);
+        int remota = grafo.baseRemota(origen, dist);
+        double costo;
+        if (remota != -1) grafo.dijkstra(origen, remota, costo);
+    }));
+    // La misma ruta leyendo el registro del disco por teselas
+    const string archivoTeselas = "bench_teselas.fa";
+    Utilidades::guardarFASTA(archivoTeselas, vector<Secuencia>(1, secGrafo));
+    OrigenTeselas origenTeselas;
+    string errorTeselas;
+    GrafoTeselado::ubicar(archivoTeselas, secGrafo.obtenerDescripcion(), origenTeselas, errorTeselas);
+    casos.push_back(medir("dijkstraTeselado", datosGrafo.length(), repeticiones, nada, [&] {
+        GrafoTeselado teselado(origenTeselas, GrafoTeselado::FILAS_POR_TESELA, GrafoTeselado::CACHE_POR_DEFECTO);
+        double costo;
+        EstadisticasTeselas est;
+        vector<Nodo> camino;
+        string error;
+        teselado.rutaMasCorta(0, 0, filaFin, colFin, camino, costo, est, error);
+    }));
+    remove(archivoTeselas.c_str());
+    remove((archivoTeselas + ".fai").c_str());
+    
+    vector<ResultadoSSSP> sssp = benchSSSP(ladoSSSP, delta);
+    
+    remove(archivoFASTA.c_str());
+    remove(archivoSalidaFASTA.c_str());
+    remove(archivoFabin.c_str());
+    
+    if (salida.empty()) {
+        escribirJSON(cout, params, repeticiones, casos, pequenos, sssp);
+    } else {
+        ofstream out(salida.c_str());
+        if (!out.is_open()) {
+            cerr << "Error guardando en " << salida << "." << endl;
+            return 1;
+        }
+        escribirJSON(out, params, repeticiones, casos, pequenos, sssp);
+    }
+    
+    for (const auto& r : sssp) {
+        if (!r.iguales) return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,85 @@
+// ============================================
+// ARCHIVO: cliente.cpp
+// ============================================
+#include <iostream>
+#include <string>
+#include <cstring>
+#include <cerrno>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+using namespace std;
+
+static const char FIN_RESPUESTA = '\x04';
+
+// Envía un comando y copia la respuesta a cout hasta la línea de fin
+static bool consultar(int fd, const string& comando, string& pendiente) {
+    string linea = comando + "\n";
+    size_t enviado = 0;
+    while (enviado < linea.length()) {
+        ssize_t n = send(fd, linea.data() + enviado, linea.length() - enviado, MSG_NOSIGNAL);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return false;
+        enviado += n;
+    }
+    
+    char bloque[4096];
+    while (true) {
+        size_t fin;
+        while ((fin = pendiente.find('\n')) != string::npos) {
+            string respuesta = pendiente.substr(0, fin);
+            pendiente.erase(0, fin + 1);
+            if (respuesta.length() == 1 && respuesta[0] == FIN_RESPUESTA) return true;
+            cout << respuesta << "\n";
+        }
+        
+        ssize_t n = recv(fd, bloque, sizeof(bloque), 0);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return false;
+        pendiente.append(bloque, n);
+    }
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        cerr << "USO: genomas_cliente <socket> [comando ...]" << endl;
+        cerr << "Sin comando, envía cada línea de la entrada estándar." << endl;
+        return 2;
+    }
+    
+    sockaddr_un direccion;
+    memset(&direccion, 0, sizeof(direccion));
+    direccion.sun_family = AF_UNIX;
+    strncpy(direccion.sun_path, argv[1], sizeof(direccion.sun_path) - 1);
+    
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0 || connect(fd, (sockaddr*)&direccion, sizeof(direccion)) < 0) {
+        cerr << "No se puede conectar con el servidor en " << argv[1] << "." << endl;
+        return 1;
+    }
+    
+    string pendiente;
+    bool correcto = true;
+    
+    if (argc > 2) {
+        string comando = argv[2];
+        for (int k = 3; k < argc; k++) comando += string(" ") + argv[k];
+        correcto = consultar(fd, comando, pendiente);
+    } else {
+        string linea;
+        while (correcto && getline(cin, linea)) {
+            if (linea.empty()) continue;
+            if (linea == "salir") break;
+            correcto = consultar(fd, linea, pendiente);
+            cout.flush();
+        }
+    }
+    
+    close(fd);
+    if (!correcto) {
+        cerr << "Se perdió la conexión con el servidor." << endl;
+        return 1;
+    }
+    return 0;
+}
@@ -5,47 +5,186 @@
 #include <iostream>
 #include <sstream>
 #include <iomanip>
+#include <fstream>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include <set>
 #include "Secuencia.h"
 #include "Utilidades.h"
 #include "Grafo.h"
 #include "Punto.h"
+#include "PoolHilos.h"
+#include "MapaRemoto.h"
+#include "CacheGrafos.h"
+#include "Instrumentacion.h"
+#include "Servidor.h"
+#include "CerrojoLectorEscritor.h"
+#include "Sesion.h"
+#include "ContadorKmers.h"
+#include "BusquedaAproximada.h"
+#include "BusquedaIUPAC.h"
+#include "Similitud.h"
+#include "Composicion.h"
+#include "Alineamiento.h"
+#include "Catalogo.h"
+#include "Crc32c.h"
+#include "ModeloHuffman.h"
+#include "GrafoTeselado.h"
+#include "Comandos.h"
 
 using namespace std;
 
 vector<Secuencia> secuenciasEnMemoria;
-map<string, Grafo> grafos;
+Catalogo catalogo;
+CacheGrafos grafos;
+Similitud similitud;
+Composicion composicion;
+RegistroModelos modelos;
+
+// Grafos por teselas de registros en disco, por "archivo:nombre"
+map<string, shared_ptr<GrafoTeselado>> grafosEnDisco;
+
+// Estados anteriores (identidad, estado) de las secuencias que cambió cada
+// comando, para deshacer
+vector<vector<pair<uint64_t, int>>> pilaDeshacer;
+
+// Contadores del mantenimiento incremental de grafos
+long reconstruccionesGrafo = 0;
+long reconstruccionesEvitadas = 0;
+long celdasParcheadas = 0;
+
+// Hilos para las operaciones paralelas y delta del SSSP de base_remota
+int numHilos = PoolHilos::hilosPorDefecto();
+double deltaSSSP = 0.5;
+
+// Salida de los comandos: cout, o el buffer propio del comando cuando
+// se ejecuta en paralelo en modo lote
+thread_local ostream* salidaHilo = &cout;
+ostream& salida() { return *salidaHilo; }
 
 void mostrarAyuda();
 void mostrarAyudaComando(const string& comando);
 void procesarComando(const string& linea);
 
+// Modo lote
+int ejecutarScript(istream& in, int concurrencia);
+void mostrarUso();
+
+// Modo servidor
+CerrojoLectorEscritor cerrojoEstado;
+mutex mutexGrafos;
+mutex mutexArchivos;
+void ejecutarComandoCompartido(const string& linea, ostream& out);
+
 // Comandos del Componente 1
-void cmdCargar(const string& archivo);
+void cmdCargar(const string& archivo, bool anadir);
+void cmdDescargar(const string& archivo);
 void cmdListarSecuencias();
-void cmdHistograma(const string& descripcion);
-void cmdEsSubsecuencia(const string& subsecuencia);
-void cmdEnmascarar(const string& subsecuencia);
+void cmdHistograma(const string& argumentos);
+void cmdComposicion(const string& descripcion, int ventana, int paso, const string& archivoCSV);
+void cmdEsSubsecuencia(const string& subsecuencia, int k, TipoDistancia tipo, bool posiciones, bool iupac);
+void cmdEnmascarar(const string& subsecuencia, bool iupac);
+void cmdKmers(int k, int numMasFrecuentes, const string& megabytes);
+void cmdSimilitud(const string& argumentos);
+void cmdAlinear(const string& argumentos);
 void cmdGuardar(const string& archivo);
+void cmdDeshacer();
+void cmdVersiones(const string& argumentos);
 
 // Comandos del Componente 2
-void cmdCodificar(const string& archivo);
-void cmdDecodificar(const string& archivo);
+void cmdCodificar(const string& archivo, const string& archivoModelo);
+void cmdDecodificar(const string& archivo, bool rescatar, const string& archivoModelo);
+void cmdVerificar(const string& archivo);
+void cmdEntrenarModelo(const string& archivoModelo, const string& lista);
+void cmdCodificarLote(const string& archivoModelo, const string& lista, const string& directorio);
 
 // Comandos del Componente 3
 void cmdRutaMasCorta(const string& descripcion, int i, int j, int x, int y);
+void cmdRutaMasCortaDisco(const string& argumentos);
 void cmdBaseRemota(const string& descripcion, int i, int j);
+void cmdRutasLote(const string& archivoConsultas, const string& archivoSalida);
+void cmdMapaRemoto(const string& descripcion, const string& archivo, int paso, const string& archivoCSV);
+void cmdEstadoGrafos();
+void cmdPresupuestoGrafos(const string& megabytes);
+void cmdEstadisticas(const string& opcion);
+
+// Sesiones
+void cmdGuardarSesion(const string& archivo);
+void cmdAbrirSesion(const string& archivo, bool verificar);
 
-int main() {
+// Historial de cambios
+vector<int> estadosActuales();
+void registrarCambios(const vector<int>& estadosPrevios);
+
+// Búsqueda en el catálogo; 'clave' recibe el nombre que identifica a la
+// secuencia en la caché de grafos
+Secuencia* buscarSecuencia(const string& nombre, string* clave = nullptr);
+
+// Mantenimiento de grafos
+void actualizarGrafos();
+Grafo& obtenerGrafo(const string& descripcion, const Secuencia& sec);
+
+int main(int argc, char* argv[]) {
+    string archivoScript, rutaSocket;
+    bool silencioso = false;
+    int concurrencia = numHilos;
+    
+    for (int k = 1; k < argc; k++) {
+        string opcion = argv[k];
+        if (opcion == "-f" && k + 1 < argc) {
+            archivoScript = argv[++k];
+        } else if (opcion == "-j" && k + 1 < argc) {
+            concurrencia = max(1, atoi(argv[++k]));
+        } else if (opcion == "-t" && k + 1 < argc) {
+            numHilos = max(1, atoi(argv[++k]));
+        } else if (opcion == "-d" && k + 1 < argc) {
+            deltaSSSP = atof(argv[++k]);
+            if (!(deltaSSSP > 0)) {
+                cerr << "El delta del SSSP debe ser positivo." << endl;
+                return 2;
+            }
+        } else if (opcion == "-s" && k + 1 < argc) {
+            rutaSocket = argv[++k];
+        } else if (opcion == "-q") {
+            silencioso = true;
+        } else {
+            mostrarUso();
+            return 2;
+        }
+    }
+    
+    if (!rutaSocket.empty()) {
+        if (!Servidor::ejecutar(rutaSocket, ejecutarComandoCompartido)) {
+            cerr << "No se puede abrir el socket " << rutaSocket << "." << endl;
+            return 1;
+        }
+        return 0;
+    }
+    
+    if (!archivoScript.empty()) {
+        if (archivoScript == "-") return ejecutarScript(cin, concurrencia);
+        
+        ifstream script(archivoScript.c_str());
+        if (!script.is_open()) {
+            cerr << archivoScript << " no se encuentra o no puede leerse." << endl;
+            return 1;
+        }
+        return ejecutarScript(script, concurrencia);
+    }
+    
     string linea;
     
-    cout << "Sistema de Manipulación de Genomas" << endl;
-    cout << "Estructuras de Datos - Proyecto 2025-30" << endl;
-    cout << "Escriba 'ayuda' para ver los comandos disponibles" << endl;
-    cout << endl;
+    if (!silencioso) {
+        cout << "Sistema de Manipulación de Genomas" << endl;
+        cout << "Estructuras de Datos - Proyecto 2025-30" << endl;
+        cout << "Escriba 'ayuda' para ver los comandos disponibles" << endl;
+        cout << endl;
+    }
     
     while (true) {
-        cout << "$ ";
-        getline(cin, linea);
+        if (!silencioso) cout << "$ ";
+        if (!getline(cin, linea)) break;
         
         if (linea.empty()) continue;
         procesarComando(linea);
@@ -54,10 +193,105 @@ int main() {
     return 0;
 }
 
+void mostrarUso() {
+    cerr << "USO: genomas [-q] [-f script|-] [-j n] [-t n] [-d delta] [-s socket]" << endl;
+    cerr << "  -q          sin cabecera ni prompt en modo interactivo" << endl;
+    cerr << "  -f script   ejecuta los comandos del archivo ('-' = entrada estándar) y termina" << endl;
+    cerr << "  -j n        comandos de solo lectura simultáneos en modo lote" << endl;
+    cerr << "  -t n        hilos de cada operación paralela (por defecto, los núcleos)" << endl;
+    cerr << "  -d delta    ancho de cubeta del SSSP paralelo de base_remota (0.5)" << endl;
+    cerr << "  -s socket   modo servidor: atiende comandos en un socket Unix (ver genomas_cliente)" << endl;
+}
+
+// ==================== MODO LOTE ====================
+
+static string primeraPalabra(const string& linea) {
+    istringstream iss(linea);
+    string palabra;
+    iss >> palabra;
+    return palabra;
+}
+
+int ejecutarScript(istream& in, int concurrencia) {
+    vector<string> lineas;
+    string linea;
+    while (getline(in, linea)) {
+        string comando = primeraPalabra(linea);
+        if (comando.empty() || comando[0] == '#') continue;
+        if (comando == "salir") break;
+        lineas.push_back(linea);
+    }
+    
+    PoolHilos pool(concurrencia);
+    size_t k = 0;
+    
+    while (k < lineas.size()) {
+        if (Comandos::clasificar(primeraPalabra(lineas[k])) == CMD_ESCRITURA) {
+            procesarComando(lineas[k]);
+            cout.flush();
+            k++;
+            continue;
+        }
+        
+        // Tramo de comandos que no modifican las secuencias
+        const size_t inicio = k;
+        size_t fin = k;
+        while (fin < lineas.size() && Comandos::clasificar(primeraPalabra(lineas[fin])) != CMD_ESCRITURA) {
+            fin++;
+        }
+        
+        size_t total = fin - inicio;
+        vector<string> salidas(total);
+        vector<char> listas(total, 0);
+        mutex mtx;
+        condition_variable cv;
+        
+        auto ejecutar = [&](size_t idx) {
+            ostringstream buffer;
+            salidaHilo = &buffer;
+            procesarComando(lineas[inicio + idx]);
+            salidaHilo = &cout;
+            
+            lock_guard<mutex> lock(mtx);
+            salidas[idx] = buffer.str();
+            listas[idx] = 1;
+            cv.notify_all();
+        };
+        
+        vector<size_t> enOrden;
+        for (size_t idx = 0; idx < total; idx++) {
+            TipoComando tipo = Comandos::clasificar(primeraPalabra(lineas[inicio + idx]));
+            if (tipo == CMD_GRAFOS || tipo == CMD_ARCHIVOS) {
+                enOrden.push_back(idx);
+            } else {
+                pool.encolar([&, idx](int) { ejecutar(idx); });
+            }
+        }
+        if (!enOrden.empty()) {
+            pool.encolar([&](int) {
+                for (size_t idx : enOrden) ejecutar(idx);
+            });
+        }
+        
+        // Imprimir en el orden del script a medida que terminan
+        for (size_t idx = 0; idx < total; idx++) {
+            unique_lock<mutex> lock(mtx);
+            cv.wait(lock, [&] { return listas[idx] != 0; });
+            cout << salidas[idx];
+            cout.flush();
+        }
+        pool.esperarTodo();
+        k = fin;
+    }
+    
+    return 0;
+}
+
 void procesarComando(const string& linea) {
     istringstream iss(linea);
     string comando;
     iss >> comando;
+    MEDIR_FASE_DINAMICA("comando." + comando);
     
     if (comando == "salir") {
         exit(0);
@@ -71,11 +305,25 @@ void procesarComando(const string& linea) {
         }
     }
     else if (comando == "cargar") {
+        string archivo;
+        bool anadir = false;
+        if ((iss >> archivo) && archivo == "--anadir") {
+            anadir = true;
+            archivo.clear();
+            iss >> archivo;
+        }
+        if (!archivo.empty()) {
+            cmdCargar(archivo, anadir);
+        } else {
+            salida() << "Error: debe especificar un nombre de archivo" << endl;
+        }
+    }
+    else if (comando == "descargar") {
         string archivo;
         if (iss >> archivo) {
-            cmdCargar(archivo);
+            cmdDescargar(archivo);
         } else {
-            cout << "Error: debe especificar un nombre de archivo" << endl;
+            salida() << "Error: debe especificar un nombre de archivo" << endl;
         }
     }
     else if (comando == "listar_secuencias") {
@@ -88,47 +336,143 @@ void procesarComando(const string& linea) {
             descripcion = descripcion.substr(1);
             cmdHistograma(descripcion);
         } else {
-            cout << "Error: debe especificar una descripción de secuencia" << endl;
+            salida() << "Error: debe especificar una descripción de secuencia" << endl;
+        }
+    }
+    else if (comando == "composicion") {
+        string descripcion, extra, archivoCSV;
+        int ventana, paso = 0;
+        if (iss >> descripcion >> ventana) {
+            while (iss >> extra) {
+                if (extra == "--csv") iss >> archivoCSV;
+                else paso = atoi(extra.c_str());
+            }
+            cmdComposicion(descripcion, ventana, paso > 0 ? paso : ventana, archivoCSV);
+        } else {
+            salida() << "Error: formato incorrecto. Uso: composicion desc ventana [paso] [--csv archivo]" << endl;
         }
     }
     else if (comando == "es_subsecuencia") {
         string subsecuencia;
         if (iss >> subsecuencia) {
-            cmdEsSubsecuencia(subsecuencia);
+            int k = 0;
+            TipoDistancia tipo = DISTANCIA_EDICION;
+            bool posiciones = false;
+            bool iupac = false;
+            string extra;
+            while (iss >> extra) {
+                if (extra == "--hamming") tipo = DISTANCIA_HAMMING;
+                else if (extra == "--posiciones") posiciones = true;
+                else if (extra == "--iupac") iupac = true;
+                else k = atoi(extra.c_str());
+            }
+            cmdEsSubsecuencia(subsecuencia, k, tipo, posiciones, iupac);
         } else {
-            cout << "Error: debe especificar una subsecuencia" << endl;
+            salida() << "Error: debe especificar una subsecuencia" << endl;
         }
     }
     else if (comando == "enmascarar") {
         string subsecuencia;
         if (iss >> subsecuencia) {
-            cmdEnmascarar(subsecuencia);
+            string extra;
+            bool iupac = false;
+            while (iss >> extra) {
+                if (extra == "--iupac") iupac = true;
+            }
+            cmdEnmascarar(subsecuencia, iupac);
         } else {
-            cout << "Error: debe especificar una subsecuencia" << endl;
+            salida() << "Error: debe especificar una subsecuencia" << endl;
         }
     }
+    else if (comando == "deshacer") {
+        cmdDeshacer();
+    }
+    else if (comando == "versiones") {
+        string argumentos;
+        getline(iss, argumentos);
+        if (!argumentos.empty()) argumentos = argumentos.substr(1);
+        cmdVersiones(argumentos);
+    }
+    else if (comando == "kmers") {
+        int k;
+        if (iss >> k) {
+            int numMasFrecuentes = 10;
+            string megabytes, extra;
+            while (iss >> extra) {
+                if (extra == "--memoria") iss >> megabytes;
+                else numMasFrecuentes = atoi(extra.c_str());
+            }
+            cmdKmers(k, numMasFrecuentes, megabytes);
+        } else {
+            salida() << "Error: formato incorrecto. Uso: kmers k [n] [--memoria MB]" << endl;
+        }
+    }
+    else if (comando == "similitud") {
+        string argumentos;
+        getline(iss, argumentos);
+        cmdSimilitud(argumentos);
+    }
+    else if (comando == "alinear") {
+        string argumentos;
+        getline(iss, argumentos);
+        cmdAlinear(argumentos);
+    }
     else if (comando == "guardar") {
         string archivo;
         if (iss >> archivo) {
             cmdGuardar(archivo);
         } else {
-            cout << "Error: debe especificar un nombre de archivo" << endl;
+            salida() << "Error: debe especificar un nombre de archivo" << endl;
         }
     }
-    else if (comando == "codificar") {
-        string archivo;
-        if (iss >> archivo) {
-            cmdCodificar(archivo);
+    else if (comando == "codificar" || comando == "decodificar") {
+        string archivo, archivoModelo, palabra;
+        bool rescatar = false, correcto = true;
+        while (iss >> palabra) {
+            if (palabra == "--modelo") {
+                correcto = correcto && (bool)(iss >> archivoModelo);
+            } else if (palabra == "--rescatar" && comando == "decodificar") {
+                rescatar = true;
+            } else if (archivo.empty()) {
+                archivo = palabra;
+            } else {
+                correcto = false;
+            }
+        }
+        if (!correcto || archivo.empty()) {
+            salida() << "Error: formato incorrecto. Uso: " << comando
+                     << (comando == "decodificar" ? " [--rescatar]" : "") << " <archivo.fabin> [--modelo archivo.fabm]"
+                     << endl;
+        } else if (comando == "codificar") {
+            cmdCodificar(archivo, archivoModelo);
         } else {
-            cout << "Error: debe especificar un nombre de archivo" << endl;
+            cmdDecodificar(archivo, rescatar, archivoModelo);
         }
     }
-    else if (comando == "decodificar") {
+    else if (comando == "entrenar_modelo") {
+        string archivoModelo, lista;
+        if (iss >> archivoModelo) {
+            iss >> lista;
+            cmdEntrenarModelo(archivoModelo, lista);
+        } else {
+            salida() << "Error: formato incorrecto. Uso: entrenar_modelo <modelo.fabm> [lista]" << endl;
+        }
+    }
+    else if (comando == "codificar_lote") {
+        string archivoModelo, lista, directorio;
+        if (iss >> archivoModelo >> lista) {
+            iss >> directorio;
+            cmdCodificarLote(archivoModelo, lista, directorio);
+        } else {
+            salida() << "Error: formato incorrecto. Uso: codificar_lote <modelo.fabm> <lista> [directorio]" << endl;
+        }
+    }
+    else if (comando == "verificar") {
         string archivo;
         if (iss >> archivo) {
-            cmdDecodificar(archivo);
+            cmdVerificar(archivo);
         } else {
-            cout << "Error: debe especificar un nombre de archivo" << endl;
+            salida() << "Error: debe especificar un nombre de archivo" << endl;
         }
     }
     else if (comando == "ruta_mas_corta") {
@@ -137,347 +481,1567 @@ void procesarComando(const string& linea) {
         if (iss >> descripcion >> i >> j >> x >> y) {
             cmdRutaMasCorta(descripcion, i, j, x, y);
         } else {
-            cout << "Error: formato incorrecto. Uso: ruta_mas_corta descripcion i j x y" << endl;
+            salida() << "Error: formato incorrecto. Uso: ruta_mas_corta descripcion i j x y" << endl;
         }
     }
+    else if (comando == "ruta_mas_corta_disco") {
+        string argumentos;
+        getline(iss, argumentos);
+        cmdRutaMasCortaDisco(argumentos);
+    }
     else if (comando == "base_remota") {
         string descripcion;
         int i, j;
         if (iss >> descripcion >> i >> j) {
             cmdBaseRemota(descripcion, i, j);
         } else {
-            cout << "Error: formato incorrecto. Uso: base_remota descripcion i j" << endl;
+            salida() << "Error: formato incorrecto. Uso: base_remota descripcion i j" << endl;
+        }
+    }
+    else if (comando == "rutas_lote") {
+        string archivoConsultas, archivoSalida;
+        if (iss >> archivoConsultas) {
+            iss >> archivoSalida;
+            cmdRutasLote(archivoConsultas, archivoSalida);
+        } else {
+            salida() << "Error: formato incorrecto. Uso: rutas_lote archivo_consultas [archivo_salida]" << endl;
+        }
+    }
+    else if (comando == "mapa_remoto") {
+        string descripcion, archivo, archivoCSV;
+        int paso = 1;
+        if (iss >> descripcion >> archivo) {
+            string extra;
+            while (iss >> extra) {
+                if (extra == "--csv") iss >> archivoCSV;
+                else paso = atoi(extra.c_str());
+            }
+            cmdMapaRemoto(descripcion, archivo, paso, archivoCSV);
+        } else {
+            salida() << "Error: formato incorrecto. Uso: mapa_remoto descripcion archivo [paso] [--csv archivo.csv]" << endl;
+        }
+    }
+    else if (comando == "estado_grafos") {
+        cmdEstadoGrafos();
+    }
+    else if (comando == "estadisticas") {
+        string opcion;
+        iss >> opcion;
+        cmdEstadisticas(opcion);
+    }
+    else if (comando == "presupuesto_grafos") {
+        string megabytes;
+        if (iss >> megabytes) {
+            cmdPresupuestoGrafos(megabytes);
+        } else {
+            salida() << "Error: debe especificar el presupuesto en MB" << endl;
+        }
+    }
+    else if (comando == "guardar_sesion") {
+        string archivo;
+        if (iss >> archivo) {
+            cmdGuardarSesion(archivo);
+        } else {
+            salida() << "Error: debe especificar un nombre de archivo" << endl;
+        }
+    }
+    else if (comando == "abrir_sesion") {
+        string archivo;
+        bool verificar = false;
+        if ((iss >> archivo) && archivo == "--verificar") {
+            verificar = true;
+            archivo.clear();
+            iss >> archivo;
+        }
+        if (!archivo.empty()) {
+            cmdAbrirSesion(archivo, verificar);
+        } else {
+            salida() << "Error: debe especificar un nombre de archivo" << endl;
         }
     }
     else {
-        cout << "Comando no reconocido: " << comando << endl;
-        cout << "Escriba 'ayuda' para ver los comandos disponibles" << endl;
+        salida() << "Comando no reconocido: " << comando << endl;
+        salida() << "Escriba 'ayuda' para ver los comandos disponibles" << endl;
     }
 }
 
+// ==================== MODO SERVIDOR ====================
+
+// Los comandos de lectura comparten el cerrojo; los de grafos además se
+// serializan entre sí por la caché y, como algunos escriben archivos, con
+// los de archivos; los de escritura son exclusivos.
+void ejecutarComandoCompartido(const string& linea, ostream& out) {
+    salidaHilo = &out;
+    switch (Comandos::clasificar(primeraPalabra(linea))) {
+        case CMD_ESCRITURA: {
+            EscrituraExclusiva escritura(cerrojoEstado);
+            procesarComando(linea);
+            break;
+        }
+        case CMD_GRAFOS: {
+            LecturaCompartida lectura(cerrojoEstado);
+            lock_guard<mutex> lock(mutexGrafos);
+            lock_guard<mutex> lockArchivos(mutexArchivos);
+            procesarComando(linea);
+            break;
+        }
+        case CMD_ARCHIVOS: {
+            LecturaCompartida lectura(cerrojoEstado);
+            lock_guard<mutex> lock(mutexArchivos);
+            procesarComando(linea);
+            break;
+        }
+        default: {
+            LecturaCompartida lectura(cerrojoEstado);
+            procesarComando(linea);
+        }
+    }
+    salidaHilo = &cout;
+}
+
+// ==================== GRAFOS EN MEMORIA ====================
+
+// Tras una mutación, los grafos de secuencias que siguen existiendo con las
+// mismas dimensiones se parchean; los demás se descartan y se reconstruyen
+// cuando se vuelvan a consultar.
+void actualizarGrafos() {
+    for (const string& descripcion : grafos.descripciones()) {
+        const Secuencia* secPtr = buscarSecuencia(descripcion);
+        
+        // Registrar puede haber desalojado este grafo en una vuelta anterior
+        Grafo* grafo = grafos.obtener(descripcion);
+        if (!grafo) continue;
+        
+        int parcheadas = 0;
+        if (secPtr && grafo->sincronizar(*secPtr, parcheadas)) {
+            if (parcheadas > 0) reconstruccionesEvitadas++;
+            celdasParcheadas += parcheadas;
+            // Un grafo mapeado se copia a memoria propia al parchearlo
+            grafos.registrar(descripcion);
+        } else {
+            grafos.eliminar(descripcion);
+        }
+    }
+}
+
+Grafo& obtenerGrafo(const string& descripcion, const Secuencia& sec) {
+    Grafo* existente = grafos.buscar(descripcion);
+    if (existente) return *existente;
+    
+    Grafo& grafo = grafos.reservar(descripcion);
+    grafo.construir(sec);
+    grafos.registrar(descripcion);
+    reconstruccionesGrafo++;
+    return grafo;
+}
+
+static string formatearBytes(size_t bytes) {
+    ostringstream oss;
+    oss << fixed << setprecision(1) << bytes / (1024.0 * 1024.0) << " MB";
+    return oss.str();
+}
+
+void cmdEstadoGrafos() {
+    salida() << "Grafos en memoria: " << grafos.obtenerNumGrafos() << " ("
+         << formatearBytes(grafos.obtenerBytesTotales()) << " de "
+         << formatearBytes(grafos.obtenerPresupuesto()) << ")" << endl;
+    for (const string& descripcion : grafos.descripciones()) {
+        salida() << "  " << descripcion << " : " << grafos.obtener(descripcion)->obtenerNumNodos()
+             << " nodos, " << grafos.obtenerBytes(descripcion) << " bytes" << endl;
+    }
+    salida() << "Aciertos: " << grafos.obtenerAciertos() << endl;
+    salida() << "Fallos: " << grafos.obtenerFallos() << endl;
+    salida() << "Desalojos: " << grafos.obtenerDesalojos() << endl;
+    salida() << "Construcciones completas: " << reconstruccionesGrafo << endl;
+    salida() << "Reconstrucciones evitadas: " << reconstruccionesEvitadas << endl;
+    salida() << "Celdas parcheadas: " << celdasParcheadas << endl;
+    if (grafosEnDisco.empty()) return;
+    salida() << "Grafos en disco: " << grafosEnDisco.size() << endl;
+    for (const auto& par : grafosEnDisco) {
+        const CacheTeselas& cache = par.second->obtenerCache();
+        salida() << "  " << par.first << " : " << cache.obtenerNumTeselas() << " de "
+             << cache.obtenerMaxTeselas() << " teselas de " << cache.obtenerFilasPorTesela()
+             << " filas, " << cache.obtenerAciertos() << " aciertos, " << cache.obtenerFallos()
+             << " fallos, " << cache.obtenerDesalojos() << " desalojos, "
+             << formatearBytes(cache.obtenerBytesLeidos()) << " leídos" << endl;
+    }
+}
+
+void cmdPresupuestoGrafos(const string& megabytes) {
+    char* fin = nullptr;
+    double mb = strtod(megabytes.c_str(), &fin);
+    if (fin == megabytes.c_str() || *fin != '\0' || mb <= 0) {
+        salida() << "Error: el presupuesto debe ser un número positivo de MB" << endl;
+        return;
+    }
+    
+    long antes = grafos.obtenerDesalojos();
+    grafos.fijarPresupuesto((size_t)(mb * 1024 * 1024));
+    salida() << "Presupuesto de grafos fijado en " << formatearBytes(grafos.obtenerPresupuesto())
+         << " (" << grafos.obtenerDesalojos() - antes << " grafos desalojados)." << endl;
+}
+
+// ==================== INSTRUMENTACIÓN ====================
+
+void cmdEstadisticas(const string& opcion) {
+#ifdef GENOMAS_INSTRUMENTACION
+    if (opcion == "reiniciar") {
+        Instrumentacion::reiniciar();
+        salida() << "Estadísticas reiniciadas." << endl;
+        return;
+    }
+    Instrumentacion::imprimir(salida());
+#else
+    (void)opcion;
+    salida() << "La instrumentación no está habilitada. Compile con 'make clean && make INSTRUMENTAR=1'." << endl;
+#endif
+}
+
 // ==================== COMPONENTE 1 ====================
 
-void cmdCargar(const string& archivo) {
+Secuencia* buscarSecuencia(const string& nombre, string* clave) {
+    long i = catalogo.buscar(nombre);
+    if (i < 0) return nullptr;
+    if (clave) *clave = catalogo.nombre(secuenciasEnMemoria, i);
+    return &secuenciasEnMemoria[i];
+}
+
+static void avisarRepetidas(int repetidas) {
+    if (repetidas == 0) return;
+    const vector<string>& nombres = catalogo.obtenerRepetidas();
+    salida() << "Aviso: " << repetidas << " secuencia" << (repetidas == 1 ? " repite" : "s repiten")
+             << " una descripción ya cargada (p. ej. " << nombres.back() << "); use archivo:descripcion"
+             << " para distinguirlas." << endl;
+}
+
+void cmdCargar(const string& archivo, bool anadir) {
+    if (anadir) {
+        if (catalogo.contieneArchivo(archivo)) {
+            salida() << "Error: " << archivo << " ya está cargado; use descargar antes de volver a cargarlo." << endl;
+            return;
+        }
+        // Las secuencias ya cargadas se mueven, no se copian ni se releen
+        vector<Secuencia> nuevas;
+        if (!Utilidades::cargarFASTA(archivo, nuevas)) {
+            salida() << archivo << " no se encuentra o no puede leerse." << endl;
+            return;
+        }
+        size_t desde = secuenciasEnMemoria.size();
+        secuenciasEnMemoria.reserve(desde + nuevas.size());
+        for (auto& sec : nuevas) secuenciasEnMemoria.push_back(std::move(sec));
+        int repetidas = catalogo.anadir(secuenciasEnMemoria, desde, archivo);
+        actualizarGrafos();
+        salida() << nuevas.size() << " secuencia" << (nuevas.size() == 1 ? " añadida" : "s añadidas")
+                 << " desde " << archivo << "; hay " << secuenciasEnMemoria.size() << " en memoria." << endl;
+        avisarRepetidas(repetidas);
+        return;
+    }
+    
     if (Utilidades::cargarFASTA(archivo, secuenciasEnMemoria)) {
-        grafos.clear();
+        int repetidas = catalogo.reemplazar(secuenciasEnMemoria, archivo);
+        actualizarGrafos();
         
         if (secuenciasEnMemoria.empty()) {
-            cout << archivo << " no contiene ninguna secuencia." << endl;
+            salida() << archivo << " no contiene ninguna secuencia." << endl;
         } else if (secuenciasEnMemoria.size() == 1) {
-            cout << "1 secuencia cargada correctamente desde " << archivo << "." << endl;
+            salida() << "1 secuencia cargada correctamente desde " << archivo << "." << endl;
         } else {
-            cout << secuenciasEnMemoria.size() << " secuencias cargadas correctamente desde " 
+            salida() << secuenciasEnMemoria.size() << " secuencias cargadas correctamente desde " 
                  << archivo << "." << endl;
         }
+        avisarRepetidas(repetidas);
     } else {
-        cout << archivo << " no se encuentra o no puede leerse." << endl;
+        salida() << archivo << " no se encuentra o no puede leerse." << endl;
     }
 }
 
+void cmdDescargar(const string& archivo) {
+    vector<string> nombres = catalogo.descargar(secuenciasEnMemoria, archivo);
+    if (nombres.empty()) {
+        salida() << "No hay secuencias cargadas desde " << archivo << "." << endl;
+        return;
+    }
+    for (const string& nombre : nombres) grafos.eliminar(nombre);
+    actualizarGrafos();
+    salida() << nombres.size() << " secuencia" << (nombres.size() == 1 ? "" : "s") << " de " << archivo
+             << " descargada" << (nombres.size() == 1 ? "" : "s") << "; quedan " << secuenciasEnMemoria.size()
+             << " en memoria." << endl;
+}
+
 void cmdListarSecuencias() {
     if (secuenciasEnMemoria.empty()) {
-        cout << "No hay secuencias cargadas en memoria." << endl;
+        salida() << "No hay secuencias cargadas en memoria." << endl;
         return;
     }
     
-    cout << "Hay " << secuenciasEnMemoria.size() << " secuencias cargadas en memoria:" << endl;
-    for (const auto& sec : secuenciasEnMemoria) {
-        cout << "Secuencia " << sec.obtenerDescripcion();
+    salida() << "Hay " << secuenciasEnMemoria.size() << " secuencias cargadas en memoria:" << endl;
+    bool variosArchivos = catalogo.numArchivos() > 1;
+    for (size_t i = 0; i < secuenciasEnMemoria.size(); i++) {
+        const Secuencia& sec = secuenciasEnMemoria[i];
+        salida() << "Secuencia " << sec.obtenerDescripcion();
+        if (variosArchivos) salida() << " (" << catalogo.origen(i) << ")";
         if (sec.esCompleta()) {
-            cout << " contiene " << sec.obtenerNumBases() << " bases." << endl;
+            salida() << " contiene " << sec.obtenerNumBases() << " bases." << endl;
         } else {
             int bases = 0;
             for (char c : sec.obtenerDatos()) {
                 if (c != '-') bases++;
             }
-            cout << " contiene al menos " << bases << " bases." << endl;
+            salida() << " contiene al menos " << bases << " bases." << endl;
         }
     }
 }
 
-void cmdHistograma(const string& descripcion) {
-    bool encontrada = false;
-
-    for (const auto& sec : secuenciasEnMemoria) {
-        if (sec.obtenerDescripcion() == descripcion) {
-            encontrada = true;
-
-            auto histograma = sec.calcularHistograma();
-            const char orden[] = "ACGTURYKMSWBDHVNX-";
-
-            for (char c : orden) {
-                if (histograma.count(c) > 0) {
-                    cout << c << " : " << histograma.at(c) << endl;
-                }
+// "desc" o "desc inicio fin"; la descripción puede tener espacios
+void cmdHistograma(const string& argumentos) {
+    const Secuencia* secPtr = buscarSecuencia(argumentos);
+    long inicio = 0, fin = -1;
+    if (!secPtr) {
+        size_t corte = argumentos.find_last_of(' ');
+        size_t corte2 = corte == string::npos || corte == 0 ? string::npos : argumentos.find_last_of(' ', corte - 1);
+        if (corte2 != string::npos) {
+            char *fin1 = nullptr, *fin2 = nullptr;
+            string a = argumentos.substr(corte2 + 1, corte - corte2 - 1), b = argumentos.substr(corte + 1);
+            inicio = strtol(a.c_str(), &fin1, 10);
+            fin = strtol(b.c_str(), &fin2, 10);
+            if (!a.empty() && !b.empty() && *fin1 == '\0' && *fin2 == '\0') {
+                secPtr = buscarSecuencia(argumentos.substr(0, corte2));
             }
-
-            break;
         }
     }
+    if (!secPtr) {
+        salida() << "Secuencia inválida." << endl;
+        return;
+    }
+    
+    long numBases = secPtr->obtenerNumBases();
+    if (fin < 0) fin = numBases;
+    if (inicio < 0 || fin > numBases || inicio > fin) {
+        salida() << "Error: la región debe cumplir 0 <= inicio <= fin <= " << numBases << "." << endl;
+        return;
+    }
+    
+    composicion.podar(secuenciasEnMemoria);
+    uint64_t histograma[256];
+    composicion.obtener(*secPtr)->contar(inicio, fin, histograma);
+    const char orden[] = "ACGTURYKMSWBDHVNX-";
+    
+    for (char c : orden) {
+        if (c != '\0' && histograma[(unsigned char)c] > 0) {
+            salida() << c << " : " << histograma[(unsigned char)c] << endl;
+        }
+    }
+}
 
-    if (!encontrada) {
-        cout << "Secuencia inválida." << endl;
+void cmdComposicion(const string& descripcion, int ventana, int paso, const string& archivoCSV) {
+    const Secuencia* secPtr = buscarSecuencia(descripcion);
+    if (!secPtr) {
+        salida() << "La secuencia " << descripcion << " no existe." << endl;
+        return;
+    }
+    if (ventana < 1 || paso < 1) {
+        salida() << "Error: la ventana y el paso deben ser enteros positivos." << endl;
+        return;
+    }
+    
+    composicion.podar(secuenciasEnMemoria);
+    vector<VentanaComposicion> ventanas = Composicion::ventanas(*composicion.obtener(*secPtr), ventana, paso);
+    
+    if (!archivoCSV.empty()) {
+        ofstream out(archivoCSV.c_str());
+        if (!out.is_open()) {
+            salida() << "Error guardando en " << archivoCSV << "." << endl;
+            return;
+        }
+        out << "inicio,fin,gc,desvio_gc,desvio_acumulado\n";
+        for (const auto& v : ventanas) {
+            out << v.inicio << "," << v.fin << "," << v.gc << "," << v.desvio << "," << v.desvioAcumulado << "\n";
+        }
+        out.close();
+        salida() << ventanas.size() << " ventanas de " << descripcion << " guardadas en " << archivoCSV << "." << endl;
+        return;
+    }
+    
+    salida() << "Ventanas de " << descripcion << " (inicio-fin : GC, desvío GC, desvío acumulado):" << endl;
+    for (const auto& v : ventanas) {
+        ostringstream oss;
+        oss << "  " << v.inicio << "-" << v.fin << " : " << fixed << setprecision(2) << v.gc * 100 << "% "
+            << setprecision(4) << v.desvio << " " << v.desvioAcumulado;
+        salida() << oss.str() << endl;
     }
 }
 
 
-void cmdEsSubsecuencia(const string& subsecuencia) {
+void cmdEsSubsecuencia(const string& subsecuencia, int k, TipoDistancia tipo, bool posiciones, bool iupac) {
     if (secuenciasEnMemoria.empty()) {
-        cout << "No hay secuencias cargadas en memoria." << endl;
+        salida() << "No hay secuencias cargadas en memoria." << endl;
+        return;
+    }
+    
+    if (k < 0) {
+        salida() << "Error: el número de diferencias no puede ser negativo." << endl;
+        return;
+    }
+    
+    if (k > 0 || posiciones || iupac) {
+        vector<Coincidencia> coincidencias;
+        ConteoHebras conteo;
+        if (iupac) {
+            conteo = BusquedaIUPAC::contar(secuenciasEnMemoria, subsecuencia, k, tipo, numHilos,
+                                           posiciones ? &coincidencias : nullptr);
+        } else {
+            conteo.directa = BusquedaAproximada::contar(secuenciasEnMemoria, subsecuencia, k, tipo, numHilos,
+                                                        posiciones ? &coincidencias : nullptr);
+        }
+        uint64_t total = conteo.total();
+        string medida = tipo == DISTANCIA_HAMMING ? "Hamming" : "edición";
+        if (iupac) medida += ", IUPAC en ambas hebras";
+        if (total == 0) {
+            salida() << "La subsecuencia dada no aparece con a lo sumo " << k << " diferencias ("
+                     << medida << ") dentro de las secuencias cargadas en memoria." << endl;
+            return;
+        }
+        salida() << "La subsecuencia dada aparece " << total << " veces con a lo sumo " << k
+                 << " diferencias (" << medida << ") dentro de las secuencias cargadas en memoria." << endl;
+        if (iupac) {
+            salida() << "  Hebra directa (+): " << conteo.directa << endl;
+            salida() << "  Hebra reversa (-): " << conteo.reversa << endl;
+        }
+        
+        string extremo = tipo == DISTANCIA_HAMMING || k == 0 ? "empieza" : "termina";
+        for (const Coincidencia& c : coincidencias) {
+            const Secuencia& sec = secuenciasEnMemoria[c.secuencia];
+            int ancho = max(sec.obtenerColumnas(), 1);
+            salida() << "  " << sec.obtenerDescripcion() << " " << extremo << " en " << c.posicion
+                     << " [" << c.posicion / ancho << "," << c.posicion % ancho << "]"
+                     << " distancia " << c.distancia;
+            if (iupac) salida() << " hebra " << (c.reversa ? '-' : '+');
+            salida() << endl;
+        }
         return;
     }
     
     int count = Utilidades::contarSubsecuencias(secuenciasEnMemoria, subsecuencia);
     
     if (count == 0) {
-        cout << "La subsecuencia dada no existe dentro de las secuencias cargadas en memoria." << endl;
+        salida() << "La subsecuencia dada no existe dentro de las secuencias cargadas en memoria." << endl;
     } else {
-        cout << "La subsecuencia dada se repite " << count 
+        salida() << "La subsecuencia dada se repite " << count 
              << " veces dentro de las secuencias cargadas en memoria." << endl;
     }
 }
 
-void cmdEnmascarar(const string& subsecuencia) {
+void cmdEnmascarar(const string& subsecuencia, bool iupac) {
     if (secuenciasEnMemoria.empty()) {
-        cout << "No hay secuencias cargadas en memoria." << endl;
+        salida() << "No hay secuencias cargadas en memoria." << endl;
+        return;
+    }
+    
+    vector<int> estadosPrevios = estadosActuales();
+    if (iupac) {
+        ConteoHebras conteo = BusquedaIUPAC::enmascarar(secuenciasEnMemoria, subsecuencia, numHilos);
+        registrarCambios(estadosPrevios);
+        actualizarGrafos();
+        if (conteo.total() == 0) {
+            salida() << "La subsecuencia dada no aparece (IUPAC, ambas hebras) dentro de las secuencias "
+                 << "cargadas en memoria, por tanto no se enmascara nada." << endl;
+        } else {
+            salida() << conteo.total() << " subsecuencias han sido enmascaradas (IUPAC, ambas hebras) "
+                 << "dentro de las secuencias cargadas en memoria." << endl;
+            salida() << "  Hebra directa (+): " << conteo.directa << endl;
+            salida() << "  Hebra reversa (-): " << conteo.reversa << endl;
+        }
         return;
     }
     
     int count = Utilidades::enmascararSubsecuencias(secuenciasEnMemoria, subsecuencia);
-    grafos.clear();
+    registrarCambios(estadosPrevios);
+    actualizarGrafos();
     
     if (count == 0) {
-        cout << "La subsecuencia dada no existe dentro de las secuencias cargadas en memoria, "
+        salida() << "La subsecuencia dada no existe dentro de las secuencias cargadas en memoria, "
              << "por tanto no se enmascara nada." << endl;
     } else {
-        cout << count << " subsecuencias han sido enmascaradas dentro de las secuencias "
+        salida() << count << " subsecuencias han sido enmascaradas dentro de las secuencias "
              << "cargadas en memoria." << endl;
     }
 }
 
+vector<int> estadosActuales() {
+    vector<int> estados;
+    for (const auto& sec : secuenciasEnMemoria) estados.push_back(sec.obtenerEstadoActual());
+    return estados;
+}
+
+void registrarCambios(const vector<int>& estadosPrevios) {
+    vector<pair<uint64_t, int>> cambios;
+    for (size_t i = 0; i < secuenciasEnMemoria.size() && i < estadosPrevios.size(); i++) {
+        if (secuenciasEnMemoria[i].obtenerEstadoActual() != estadosPrevios[i]) {
+            cambios.push_back(make_pair(secuenciasEnMemoria[i].obtenerIdentidad(), estadosPrevios[i]));
+        }
+    }
+    if (!cambios.empty()) pilaDeshacer.push_back(cambios);
+}
+
+void cmdDeshacer() {
+    // Los cambios de secuencias ya reemplazadas (cargar, abrir_sesion) no cuentan
+    while (!pilaDeshacer.empty()) {
+        vector<pair<uint64_t, int>> cambios = pilaDeshacer.back();
+        pilaDeshacer.pop_back();
+        int revertidas = 0;
+        for (const auto& c : cambios) {
+            for (auto& sec : secuenciasEnMemoria) {
+                if (sec.obtenerIdentidad() == c.first && sec.irAEstado(c.second)) {
+                    revertidas++;
+                    break;
+                }
+            }
+        }
+        if (revertidas > 0) {
+            actualizarGrafos();
+            salida() << "Se deshizo el último cambio en " << revertidas << " secuencia"
+                     << (revertidas == 1 ? "" : "s") << "." << endl;
+            return;
+        }
+    }
+    salida() << "No hay cambios que deshacer." << endl;
+}
+
+void cmdVersiones(const string& argumentos) {
+    if (secuenciasEnMemoria.empty()) {
+        salida() << "No hay secuencias cargadas en memoria." << endl;
+        return;
+    }
+    
+    if (argumentos.empty()) {
+        for (const auto& sec : secuenciasEnMemoria) {
+            salida() << sec.obtenerDescripcion() << ": estado " << sec.obtenerEstadoActual() << " de "
+                     << sec.obtenerNumEstados() << ", historial de " << sec.memoriaHistorial() << " bytes" << endl;
+        }
+        return;
+    }
+    
+    // "<descripcion> <n>" cambia de estado; la descripción puede tener espacios
+    string descripcion = argumentos;
+    int numero = -1;
+    size_t espacio = argumentos.find_last_of(' ');
+    if (espacio != string::npos && espacio + 1 < argumentos.length() &&
+        argumentos.find_first_not_of("0123456789", espacio + 1) == string::npos) {
+        descripcion = argumentos.substr(0, espacio);
+        numero = atoi(argumentos.c_str() + espacio + 1);
+    }
+    
+    Secuencia* secPtr = buscarSecuencia(descripcion);
+    if (!secPtr) {
+        salida() << "Secuencia inválida." << endl;
+        return;
+    }
+    Secuencia& sec = *secPtr;
+    if (numero < 0) {
+        salida() << "Estados de " << descripcion << " (historial de " << sec.memoriaHistorial()
+                 << " bytes):" << endl;
+        for (int e = 0; e < sec.obtenerNumEstados(); e++) {
+            int anterior;
+            size_t editadas, piezas;
+            sec.describirEstado(e, anterior, editadas, piezas);
+            salida() << (e == sec.obtenerEstadoActual() ? "* " : "  ") << e << ": ";
+            if (anterior < 0) salida() << "original" << endl;
+            else salida() << editadas << " bases escritas en " << piezas << " tramos sobre el estado "
+                          << anterior << endl;
+        }
+        return;
+    }
+    
+    int anterior = sec.obtenerEstadoActual();
+    if (!sec.irAEstado(numero)) {
+        salida() << "Estado inválido: " << descripcion << " tiene " << sec.obtenerNumEstados()
+                 << " estados." << endl;
+        return;
+    }
+    if (anterior != numero) {
+        pilaDeshacer.push_back(vector<pair<uint64_t, int>>(1, make_pair(sec.obtenerIdentidad(), anterior)));
+        actualizarGrafos();
+    }
+    salida() << "La secuencia " << descripcion << " está en el estado " << numero << "." << endl;
+}
+
+void cmdKmers(int k, int numMasFrecuentes, const string& megabytes) {
+    if (secuenciasEnMemoria.empty()) {
+        salida() << "No hay secuencias cargadas en memoria." << endl;
+        return;
+    }
+    if (k < 1 || k > ContadorKmers::K_MAXIMO) {
+        salida() << "Error: k debe estar entre 1 y " << ContadorKmers::K_MAXIMO << "." << endl;
+        return;
+    }
+    
+    size_t memoria = ContadorKmers::MEMORIA_POR_DEFECTO;
+    if (!megabytes.empty()) {
+        char* fin = nullptr;
+        double mb = strtod(megabytes.c_str(), &fin);
+        if (*fin != '\0' || !(mb > 0)) {
+            salida() << "Error: la memoria debe ser un número positivo de MB." << endl;
+            return;
+        }
+        memoria = (size_t)(mb * 1024 * 1024);
+    }
+    
+    ResultadoKmers r;
+    ContadorKmers::contar(secuenciasEnMemoria, k, numHilos, memoria, max(numMasFrecuentes, 0), r);
+    
+    salida() << "k-mers canónicos de longitud " << k << ": " << r.total << " en total, "
+             << r.distintos << " distintos, " << r.unicos << " únicos";
+    if (r.pasadas > 1) salida() << " (" << r.pasadas << " pasadas)";
+    salida() << "." << endl;
+    
+    if (!r.masFrecuentes.empty()) {
+        salida() << "Más frecuentes:" << endl;
+        for (const auto& par : r.masFrecuentes) {
+            salida() << "  " << ContadorKmers::decodificar(par.first, k) << " : " << par.second << endl;
+        }
+    }
+    if (!r.histograma.empty()) {
+        salida() << "Histograma (apariciones : k-mers distintos):" << endl;
+        for (const auto& par : r.histograma) {
+            salida() << "  " << par.first << " : " << par.second << endl;
+        }
+    }
+}
+
+void cmdSimilitud(const string& argumentos) {
+    int k = Similitud::K_POR_DEFECTO, tamano = Similitud::TAMANO_POR_DEFECTO, numPares = 10;
+    double minimo = 0;
+    istringstream iss(argumentos);
+    string arg;
+    while (iss >> arg) {
+        string valor;
+        if (arg == "--k" || arg == "--boceto" || arg == "--minimo") {
+            if (!(iss >> valor)) {
+                salida() << "Error: falta el valor de " << arg << "." << endl;
+                return;
+            }
+        }
+        if (arg == "--k") k = atoi(valor.c_str());
+        else if (arg == "--boceto") tamano = atoi(valor.c_str());
+        else if (arg == "--minimo") minimo = atof(valor.c_str());
+        else numPares = atoi(arg.c_str());
+    }
+    
+    if (secuenciasEnMemoria.size() < 2) {
+        salida() << "Se necesitan al menos dos secuencias cargadas en memoria." << endl;
+        return;
+    }
+    if (k < 1 || k > 32) {
+        salida() << "Error: k debe estar entre 1 y 32." << endl;
+        return;
+    }
+    if (tamano < 1) {
+        salida() << "Error: el boceto debe tener al menos un hash." << endl;
+        return;
+    }
+    
+    int calculados = 0;
+    vector<shared_ptr<const Boceto>> bocetos = similitud.bocetar(secuenciasEnMemoria, k, tamano, numHilos, calculados);
+    vector<ParSimilar> pares = Similitud::todosContraTodos(bocetos, minimo, numHilos);
+    
+    salida() << "Bocetos de " << bocetos.size() << " secuencias (k=" << k << ", " << tamano << " hashes; "
+             << calculados << " calculados, " << bocetos.size() - calculados << " de la caché)." << endl;
+    if (pares.empty()) {
+        salida() << "Ningún par de secuencias comparte hashes del boceto." << endl;
+        return;
+    }
+    
+    salida() << pares.size() << " pares similares";
+    if ((int)pares.size() > numPares) salida() << ", los " << max(numPares, 0) << " más parecidos";
+    salida() << " (Jaccard, ANI estimada, hashes compartidos):" << endl;
+    for (int p = 0; p < (int)pares.size() && p < numPares; p++) {
+        const ParSimilar& par = pares[p];
+        ostringstream oss;
+        oss << "  " << secuenciasEnMemoria[par.a].obtenerDescripcion() << " ~ "
+            << secuenciasEnMemoria[par.b].obtenerDescripcion() << " : J=" << fixed << setprecision(4)
+            << par.jaccard << " ANI=" << setprecision(2) << par.ani * 100 << "% ("
+            << par.compartidos << "/" << par.comparados << ")";
+        salida() << oss.str() << endl;
+    }
+}
+
+void cmdAlinear(const string& argumentos) {
+    istringstream iss(argumentos);
+    string descripcion1, descripcion2, arg;
+    if (!(iss >> descripcion1 >> descripcion2)) {
+        salida() << "Error: formato incorrecto. Uso: alinear desc1 desc2 [--global] [--banda W] [--solo-puntaje]"
+                 << " [--puntajes c d a e]" << endl;
+        return;
+    }
+    
+    ParametrosAlineamiento p;
+    bool conBanda = false;
+    while (iss >> arg) {
+        if (arg == "--global") p.modo = ALINEAMIENTO_GLOBAL;
+        else if (arg == "--solo-puntaje") p.soloPuntaje = true;
+        else if (arg == "--banda" && (iss >> p.banda)) conBanda = true;
+        else if (arg == "--puntajes" && (iss >> p.coincidencia >> p.diferencia >> p.apertura >> p.extension)) continue;
+        else {
+            salida() << "Error: opción inválida " << arg << "." << endl;
+            return;
+        }
+    }
+    // -1 es "sin banda" solo como valor por omisión
+    if (conBanda && p.banda < 0) {
+        salida() << "Error: la banda debe ser un entero no negativo." << endl;
+        return;
+    }
+    if (p.coincidencia < 1 || p.coincidencia > 50 || p.diferencia < -50 || p.diferencia > -1 ||
+        p.apertura < 0 || p.extension < 1 || p.apertura + p.extension > 100) {
+        salida() << "Error: los puntajes deben cumplir 1 <= c <= 50, -50 <= d <= -1, a >= 0, e >= 1 y a + e <= 100."
+                 << endl;
+        return;
+    }
+    
+    const Secuencia* sec1 = buscarSecuencia(descripcion1);
+    const Secuencia* sec2 = buscarSecuencia(descripcion2);
+    if (!sec1 || !sec2) {
+        salida() << "La secuencia " << (sec1 ? descripcion2 : descripcion1) << " no existe." << endl;
+        return;
+    }
+    
+    ResultadoAlineamiento r;
+    string error;
+    if (!Alineamiento::alinear(sec1->obtenerBases(), sec1->obtenerNumBases(), sec2->obtenerBases(),
+                               sec2->obtenerNumBases(), p, r, error)) {
+        salida() << "Error: " << error << "." << endl;
+        return;
+    }
+    
+    ostringstream oss;
+    oss << "Alineamiento " << (p.modo == ALINEAMIENTO_LOCAL ? "local" : "global") << ": puntaje " << r.puntaje
+        << " (" << r.bits << " bits)." << endl;
+    if (!p.soloPuntaje || p.modo == ALINEAMIENTO_GLOBAL) {
+        oss << "  " << descripcion1 << " [" << r.inicio1 << ", " << r.fin1 << ") con " << descripcion2 << " ["
+            << r.inicio2 << ", " << r.fin2 << ")" << endl;
+    } else {
+        oss << "  Termina en la base " << r.fin1 << " de " << descripcion1 << " y " << r.fin2 << " de "
+            << descripcion2 << endl;
+    }
+    if (!p.soloPuntaje && r.columnas > 0) {
+        oss << "  Identidad: " << fixed << setprecision(2) << 100.0 * r.coincidencias / r.columnas << "% ("
+            << r.coincidencias << "/" << r.columnas << " columnas)" << endl;
+        oss << "  CIGAR: " << r.cigar << endl;
+    }
+    oss << "  " << r.celdas << " celdas en " << fixed << setprecision(4) << r.segundos << " s ("
+        << setprecision(2) << r.gcups() << " GCUPS)";
+    salida() << oss.str() << endl;
+}
+
 void cmdGuardar(const string& archivo) {
     if (secuenciasEnMemoria.empty()) {
-        cout << "No hay secuencias cargadas en memoria." << endl;
+        salida() << "No hay secuencias cargadas en memoria." << endl;
         return;
     }
     
     if (Utilidades::guardarFASTA(archivo, secuenciasEnMemoria)) {
-        cout << "Las secuencias han sido guardadas en " << archivo << "." << endl;
+        salida() << "Las secuencias han sido guardadas en " << archivo << "." << endl;
     } else {
-        cout << "Error guardando en " << archivo << "." << endl;
+        salida() << "Error guardando en " << archivo << "." << endl;
     }
 }
 
 // ==================== COMPONENTE 2 ====================
 
-void cmdCodificar(const string& archivo) {
+// Lee un modelo y lo deja registrado para decodificar los archivos que lo nombran
+shared_ptr<const ModeloHuffman> cargarModelo(const string& archivoModelo) {
+    shared_ptr<const ModeloHuffman> modelo = modelos.cargar(archivoModelo);
+    if (!modelo) salida() << archivoModelo << " no se encuentra o no es un modelo válido." << endl;
+    return modelo;
+}
+
+void cmdCodificar(const string& archivo, const string& archivoModelo) {
     if (secuenciasEnMemoria.empty()) {
-        cout << "No hay secuencias cargadas en memoria." << endl;
+        salida() << "No hay secuencias cargadas en memoria." << endl;
         return;
     }
+    shared_ptr<const ModeloHuffman> modelo;
+    if (!archivoModelo.empty() && !(modelo = cargarModelo(archivoModelo))) return;
+    if (modelo && !modelo->cubre(secuenciasEnMemoria)) {
+        salida() << "El modelo " << ModeloHuffman::nombreId(modelo->obtenerId())
+                 << " no tiene código para todos los símbolos; se usa la tabla propia." << endl;
+        modelo.reset();
+    }
     
-    if (Utilidades::codificarHuffman(archivo, secuenciasEnMemoria)) {
-        cout << "Secuencias codificadas y almacenadas en " << archivo << "." << endl;
+    if (Utilidades::codificarHuffman(archivo, secuenciasEnMemoria, modelo.get())) {
+        salida() << "Secuencias codificadas y almacenadas en " << archivo;
+        if (modelo) salida() << " con el modelo " << ModeloHuffman::nombreId(modelo->obtenerId());
+        salida() << "." << endl;
     } else {
-        cout << "No se pueden guardar las secuencias cargadas en " << archivo << "." << endl;
+        salida() << "No se pueden guardar las secuencias cargadas en " << archivo << "." << endl;
     }
 }
 
-void cmdDecodificar(const string& archivo) {
-    if (Utilidades::decodificarHuffman(archivo, secuenciasEnMemoria)) {
-        grafos.clear();
-        cout << "Secuencias decodificadas desde " << archivo << " y cargadas en memoria." << endl;
+// "secuencia 'seq1' (2 de 3)"
+string nombrarBloque(const VerificacionFabin& r, uint32_t indice) {
+    ostringstream oss;
+    oss << "secuencia '" << r.descripciones[indice] << "' (" << indice + 1 << " de "
+        << r.descripciones.size() << ")";
+    return oss.str();
+}
+
+void cmdDecodificar(const string& archivo, bool rescatar, const string& archivoModelo) {
+    if (!archivoModelo.empty() && !cargarModelo(archivoModelo)) return;
+    VerificacionFabin informe;
+    if (Utilidades::decodificarHuffman(archivo, secuenciasEnMemoria, &informe, rescatar, &modelos)) {
+        catalogo.reemplazar(secuenciasEnMemoria, archivo);
+        actualizarGrafos();
+        salida() << "Secuencias decodificadas desde " << archivo << " y cargadas en memoria." << endl;
+        if (!informe.danadas.empty()) {
+            salida() << informe.danadas.size() << " secuencias dañadas omitidas; la primera es la "
+                     << nombrarBloque(informe, informe.danadas[0]) << "." << endl;
+        }
+    } else if (informe.faltaModelo) {
+        salida() << archivo << " se codificó con el modelo " << ModeloHuffman::nombreId(informe.modelo)
+                 << ", que no está cargado. Indíquelo con --modelo <archivo.fabm>." << endl;
+    } else if (!informe.danadas.empty()) {
+        salida() << "No se pueden cargar las secuencias desde " << archivo << ": la "
+                 << nombrarBloque(informe, informe.danadas[0]) << " está dañada. "
+                 << "Use decodificar --rescatar para cargar las demás." << endl;
+    } else if (informe.cabeceraValida) {
+        salida() << "No se pueden cargar las secuencias desde " << archivo << "." << endl;
     } else {
-        cout << "No se pueden cargar las secuencias desde " << archivo << "." << endl;
+        salida() << "No se pueden cargar las secuencias desde " << archivo
+                 << ": no existe, no es un .fabin o su cabecera está dañada." << endl;
     }
 }
 
-// ==================== COMPONENTE 3 ====================
+void cmdVerificar(const string& archivo) {
+    VerificacionFabin r;
+    auto inicio = chrono::steady_clock::now();
+    if (!Utilidades::verificarFabin(archivo, r, numHilos)) {
+        salida() << "No se puede leer " << archivo << "." << endl;
+        return;
+    }
+    double segundos = chrono::duration<double>(chrono::steady_clock::now() - inicio).count();
+    if (!r.cabeceraValida) {
+        salida() << "La cabecera de " << archivo << " está dañada o no es un .fabin; "
+                 << "no se pueden ubicar las secuencias." << endl;
+        return;
+    }
+    ostringstream oss;
+    if (r.danadas.empty()) {
+        oss << "Las " << r.descripciones.size() << " secuencias de " << archivo << " están intactas";
+    } else {
+        oss << r.danadas.size() << " de " << r.descripciones.size() << " secuencias de " << archivo
+            << " están dañadas; la primera es la " << nombrarBloque(r, r.danadas[0]);
+    }
+    oss << " (" << fixed << setprecision(1) << r.bytes / 1e6 << " MB en " << setprecision(3) << segundos
+        << " s, CRC32C " << (Crc32c::porHardware() ? "SSE4.2" : "por tablas") << ").";
+    if (r.usaModelo) oss << "\nCodificado con el modelo " << ModeloHuffman::nombreId(r.modelo) << ".";
+    for (size_t k = 1; k < r.danadas.size() && k < 10; k++) {
+        oss << "\n  " << nombrarBloque(r, r.danadas[k]);
+    }
+    salida() << oss.str() << endl;
+}
 
-void cmdRutaMasCorta(const string& descripcion, int i, int j, int x, int y) {
-    Secuencia* secPtr = nullptr;
+// Una ruta por línea; se ignoran las vacías y las que empiezan con '#'
+bool leerListaArchivos(const string& lista, vector<string>& archivos) {
+    ifstream in(lista.c_str());
+    if (!in.is_open()) {
+        salida() << lista << " no se encuentra o no puede leerse." << endl;
+        return false;
+    }
+    string linea;
+    while (getline(in, linea)) {
+        if (!linea.empty() && linea[0] != '#') archivos.push_back(linea);
+    }
+    return true;
+}
+
+void cmdEntrenarModelo(const string& archivoModelo, const string& lista) {
+    shared_ptr<const ModeloHuffman> modelo;
+    vector<string> archivos, fallidos;
+    if (lista.empty()) {
+        if (secuenciasEnMemoria.empty()) {
+            salida() << "No hay secuencias cargadas en memoria." << endl;
+            return;
+        }
+        modelo = ModeloHuffman::entrenar(secuenciasEnMemoria);
+    } else {
+        if (!leerListaArchivos(lista, archivos)) return;
+        modelo = ModeloHuffman::entrenar(archivos, numHilos, fallidos);
+    }
+    if (modelo->vacio()) {
+        salida() << "El corpus no tiene bases; no se guarda el modelo." << endl;
+        return;
+    }
+    if (!modelo->guardar(archivoModelo)) {
+        salida() << "No se puede guardar el modelo en " << archivoModelo << "." << endl;
+        return;
+    }
+    modelos.registrar(modelo);
     
-    for (auto& sec : secuenciasEnMemoria) {
-        if (sec.obtenerDescripcion() == descripcion) {
-            secPtr = &sec;
-            break;
+    ostringstream oss;
+    oss << "Modelo " << ModeloHuffman::nombreId(modelo->obtenerId()) << " guardado en " << archivoModelo
+        << ", entrenado con ";
+    if (lista.empty()) {
+        oss << secuenciasEnMemoria.size() << " secuencias en memoria";
+    } else {
+        oss << archivos.size() - fallidos.size() << " archivos";
+    }
+    oss << " (" << fixed << setprecision(3) << modelo->bitsPorSimbolo() << " bits por base).";
+    if (!fallidos.empty()) {
+        oss << "\n" << fallidos.size() << " archivos no se pudieron leer; el primero es " << fallidos[0] << ".";
+    }
+    salida() << oss.str() << endl;
+}
+
+// directorio/base.fabin, donde base es el nombre sin directorio ni
+// extensiones (.fa, .fa.gz, ...)
+string nombreCodificado(const string& archivo, const string& directorio) {
+    size_t barra = archivo.find_last_of('/');
+    string base = barra == string::npos ? archivo : archivo.substr(barra + 1);
+    size_t punto = base.find('.');
+    if (punto != string::npos && punto > 0) base = base.substr(0, punto);
+    string destino = !directorio.empty() ? directorio : barra == string::npos ? "." : archivo.substr(0, barra);
+    return destino + "/" + base + ".fabin";
+}
+
+// Cada hilo lee y codifica archivos completos con el mismo modelo; los que
+// tienen símbolos fuera del modelo llevan su propia tabla
+void cmdCodificarLote(const string& archivoModelo, const string& lista, const string& directorio) {
+    shared_ptr<const ModeloHuffman> modelo = cargarModelo(archivoModelo);
+    if (!modelo) return;
+    vector<string> archivos;
+    if (!leerListaArchivos(lista, archivos)) return;
+    
+    auto inicio = chrono::steady_clock::now();
+    vector<char> correcto(archivos.size(), 0);
+    vector<uint64_t> bases(archivos.size(), 0);
+    vector<char> conTablaPropia(archivos.size(), 0);
+    {
+        PoolHilos pool(numHilos);
+        for (size_t k = 0; k < archivos.size(); k++) {
+            pool.encolar([&, k](int) {
+                vector<Secuencia> secuencias;
+                if (!Utilidades::cargarFASTA(archivos[k], secuencias)) return;
+                for (const auto& sec : secuencias) bases[k] += sec.obtenerNumBases();
+                conTablaPropia[k] = !modelo->cubre(secuencias);
+                correcto[k] = Utilidades::codificarHuffman(nombreCodificado(archivos[k], directorio), secuencias,
+                                                           conTablaPropia[k] ? nullptr : modelo.get());
+            });
         }
+        pool.esperarTodo();
     }
+    double segundos = chrono::duration<double>(chrono::steady_clock::now() - inicio).count();
+    
+    size_t codificados = 0, propios = 0, primerFallo = archivos.size();
+    uint64_t totalBases = 0;
+    for (size_t k = 0; k < archivos.size(); k++) {
+        if (correcto[k]) {
+            codificados++;
+            propios += conTablaPropia[k];
+            totalBases += bases[k];
+        } else if (primerFallo == archivos.size()) {
+            primerFallo = k;
+        }
+    }
+    ostringstream oss;
+    oss << codificados << " de " << archivos.size() << " archivos codificados con el modelo "
+        << ModeloHuffman::nombreId(modelo->obtenerId()) << " (" << totalBases << " bases en " << fixed
+        << setprecision(3) << segundos << " s).";
+    if (propios > 0) oss << "\n" << propios << " tienen símbolos fuera del modelo y llevan su propia tabla.";
+    if (primerFallo < archivos.size()) {
+        oss << "\nNo se pudo leer o escribir " << archivos[primerFallo]
+            << (archivos.size() - codificados > 1 ? " ni otros." : ".");
+    }
+    salida() << oss.str() << endl;
+}
+
+// ==================== COMPONENTE 3 ====================
+
+string describirRuta(const string& descripcion, char base1, char base2, long long i, long long j,
+                     long long x, long long y, const vector<Nodo>& camino, double costo) {
+    ostringstream oss;
+    oss << "Para la secuencia " << descripcion << ", la ruta más corta entre "
+        << "la base " << base1 << " en [" << i << "," << j << "] y "
+        << "la base " << base2 << " en [" << x << "," << y << "] es: ";
+    
+    for (size_t k = 0; k < camino.size(); k++) {
+        oss << camino[k].base;
+        if (k < camino.size() - 1) oss << " -> ";
+    }
+    
+    oss << ". El costo total de la ruta es: " << fixed << setprecision(4) << costo;
+    return oss.str();
+}
+
+void cmdRutaMasCorta(const string& descripcion, int i, int j, int x, int y) {
+    string clave;
+    Secuencia* secPtr = buscarSecuencia(descripcion, &clave);
     
     if (!secPtr) {
-        cout << "La secuencia " << descripcion << " no existe." << endl;
+        salida() << "La secuencia " << descripcion << " no existe." << endl;
         return;
     }
     
     if (!secPtr->posicionValida(i, j)) {
-        cout << "La base en la posición [" << i << "," << j << "] no existe." << endl;
+        salida() << "La base en la posición [" << i << "," << j << "] no existe." << endl;
         return;
     }
     
     if (!secPtr->posicionValida(x, y)) {
-        cout << "La base en la posición [" << x << "," << y << "] no existe." << endl;
+        salida() << "La base en la posición [" << x << "," << y << "] no existe." << endl;
         return;
     }
     
-    if (grafos.find(descripcion) == grafos.end()) {
-        grafos[descripcion].construir(*secPtr);
-    }
-    
-    Grafo& grafo = grafos[descripcion];
+    Grafo& grafo = obtenerGrafo(clave, *secPtr);
     int origen = grafo.obtenerIndice(i, j);
     int destino = grafo.obtenerIndice(x, y);
     
     double costo;
     vector<Nodo> camino = grafo.dijkstra(origen, destino, costo);
     
-    char baseOrigen = secPtr->obtenerBase(i, j);
-    char baseDestino = secPtr->obtenerBase(x, y);
+    salida() << describirRuta(descripcion, secPtr->obtenerBase(i, j), secPtr->obtenerBase(x, y), i, j, x, y,
+                             camino, costo) << endl;
+}
+
+void cmdRutaMasCortaDisco(const string& argumentos) {
+    istringstream iss(argumentos);
+    string archivo, nombre, arg;
+    long long i, j, x, y;
+    int filasPorTesela = GrafoTeselado::FILAS_POR_TESELA;
+    double megabytes = GrafoTeselado::CACHE_POR_DEFECTO / (1024.0 * 1024.0);
+    if (!(iss >> archivo >> nombre >> i >> j >> x >> y)) {
+        salida() << "Error: formato incorrecto. Uso: ruta_mas_corta_disco archivo desc i j x y"
+                 << " [--tesela F] [--cache MB]" << endl;
+        return;
+    }
+    while (iss >> arg) {
+        if (arg == "--tesela" && (iss >> filasPorTesela) && filasPorTesela > 0) continue;
+        else if (arg == "--cache" && (iss >> megabytes) && megabytes > 0) continue;
+        else {
+            salida() << "Error: opción inválida " << arg << "." << endl;
+            return;
+        }
+    }
     
-    cout << "Para la secuencia " << descripcion << ", la ruta más corta entre "
-         << "la base " << baseOrigen << " en [" << i << "," << j << "] y "
-         << "la base " << baseDestino << " en [" << x << "," << y << "] es: ";
+    OrigenTeselas origen;
+    string error;
+    if (!GrafoTeselado::ubicar(archivo, nombre, origen, error)) {
+        salida() << "Error: " << error << endl;
+        return;
+    }
     
-    for (size_t k = 0; k < camino.size(); k++) {
-        cout << camino[k].base;
-        if (k < camino.size() - 1) cout << " -> ";
+    // Se conserva el grafo (y su caché de teselas) entre consultas mientras
+    // no cambien el archivo ni los parámetros
+    size_t bytesCache = (size_t)(megabytes * 1024 * 1024);
+    shared_ptr<GrafoTeselado>& grafo = grafosEnDisco[archivo + ":" + origen.nombre];
+    if (!grafo || grafo->obtenerOrigen().archivo != origen.archivo ||
+        grafo->obtenerOrigen().desplazamiento != origen.desplazamiento ||
+        grafo->obtenerOrigen().numBases != origen.numBases ||
+        grafo->obtenerCache().obtenerFilasPorTesela() != filasPorTesela ||
+        grafo->obtenerCache().obtenerMaxTeselas() !=
+            max((size_t)2, bytesCache / ((size_t)filasPorTesela * origen.ancho))) {
+        grafo = make_shared<GrafoTeselado>(origen, filasPorTesela, bytesCache);
+    }
+    if (!grafo->posicionValida(i, j)) {
+        salida() << "La base en la posición [" << i << "," << j << "] no existe." << endl;
+        return;
+    }
+    if (!grafo->posicionValida(x, y)) {
+        salida() << "La base en la posición [" << x << "," << y << "] no existe." << endl;
+        return;
     }
     
-    cout << ". El costo total de la ruta es: " << fixed << setprecision(4) << costo << endl;
+    double costo;
+    EstadisticasTeselas est;
+    vector<Nodo> camino;
+    if (!grafo->rutaMasCorta(i, j, x, y, camino, costo, est, error)) {
+        // Una caché que falló no se reutiliza
+        grafosEnDisco.erase(archivo + ":" + origen.nombre);
+        salida() << "Error: " << error << endl;
+        return;
+    }
+    
+    ostringstream oss;
+    oss << describirRuta(nombre, camino.front().base, camino.back().base, i, j, x, y, camino, costo) << "\n"
+        << "Teselas de " << filasPorTesela << " filas: " << est.aciertos << " aciertos, "
+        << est.fallos << " fallos, " << est.desalojos << " desalojos, "
+        << formatearBytes(est.bytesLeidos) << " leídos; la búsqueda tocó " << est.teselasExploradas
+        << " teselas (" << formatearBytes(est.bytesEstado) << " de estado) y liquidó "
+        << est.nodosLiquidados << " nodos.";
+    salida() << oss.str() << endl;
 }
 
 void cmdBaseRemota(const string& descripcion, int i, int j) {
-    Secuencia* secPtr = nullptr;
-    
-    for (auto& sec : secuenciasEnMemoria) {
-        if (sec.obtenerDescripcion() == descripcion) {
-            secPtr = &sec;
-            break;
-        }
-    }
+    string clave;
+    Secuencia* secPtr = buscarSecuencia(descripcion, &clave);
     
     if (!secPtr) {
-        cout << "La secuencia " << descripcion << " no existe." << endl;
+        salida() << "La secuencia " << descripcion << " no existe." << endl;
         return;
     }
     
     if (!secPtr->posicionValida(i, j)) {
-        cout << "La base en la posición [" << i << "," << j << "] no existe." << endl;
+        salida() << "La base en la posición [" << i << "," << j << "] no existe." << endl;
         return;
     }
     
-    if (grafos.find(descripcion) == grafos.end()) {
-        grafos[descripcion].construir(*secPtr);
+    Grafo& grafo = obtenerGrafo(clave, *secPtr);
+    int origen = grafo.obtenerIndice(i, j);
+    
+    // Un solo SSSP paralelo para todos los candidatos; la ruta se reconstruye
+    // después con Dijkstra secuencial hacia el destino elegido, y el costo
+    // que se informa es el mismo con el que se eligió
+    vector<double> dist = grafo.distanciasDeltaStepping(origen, numHilos, deltaSSSP);
+    int mejorDestino = grafo.baseRemota(origen, dist);
+    double costoRuta;
+    
+    if (mejorDestino == -1) {
+        salida() << "No hay bases remotas del mismo tipo." << endl;
+        return;
     }
     
-    Grafo& grafo = grafos[descripcion];
-    int origen = grafo.obtenerIndice(i, j);
-    char baseOrigen = secPtr->obtenerBase(i, j);
+    vector<Nodo> mejorCamino = grafo.dijkstra(origen, mejorDestino, costoRuta);
+    
+    Nodo nodoRemoto = grafo.obtenerNodo(mejorDestino);
     
-    vector<int> basesIguales = grafo.encontrarBasesIguales(baseOrigen);
+    salida() << "Para la secuencia " << descripcion << ", la base remota está ubicada "
+         << "en [" << nodoRemoto.fila << "," << nodoRemoto.col << "], y la ruta entre "
+         << "la base en [" << i << "," << j << "] y la base remota en ["
+         << nodoRemoto.fila << "," << nodoRemoto.col << "] es: ";
     
-    double maxCosto = -1;
-    int mejorDestino = -1;
-    vector<Nodo> mejorCamino;
+    for (size_t k = 0; k < mejorCamino.size(); k++) {
+        salida() << mejorCamino[k].base;
+        if (k < mejorCamino.size() - 1) salida() << " -> ";
+    }
     
-    for (int destino : basesIguales) {
-        if (destino == origen) continue;
+    salida() << ". El costo total de la ruta es: " << fixed << setprecision(4) 
+         << dist[mejorDestino] << endl;
+}
+
+struct ConsultaRuta {
+    string descripcion, clave;
+    int i, j, x, y;
+    const Secuencia* sec;
+    Grafo* grafo;
+};
+
+// Resuelve un archivo de consultas "desc i j x y" en paralelo. Las consultas
+// con la misma secuencia y el mismo origen comparten una sola búsqueda; cada
+// hilo usa su propio EspacioBusqueda sobre los grafos compartidos.
+void cmdRutasLote(const string& archivoConsultas, const string& archivoSalida) {
+    ifstream in(archivoConsultas.c_str());
+    if (!in.is_open()) {
+        salida() << archivoConsultas << " no se encuentra o no puede leerse." << endl;
+        return;
+    }
+    
+    vector<ConsultaRuta> consultas;
+    vector<string> resultados;
+    vector<bool> pendiente;
+    string linea;
+    int numLinea = 0;
+    
+    while (getline(in, linea)) {
+        numLinea++;
+        if (linea.empty() || linea[0] == '#') continue;
         
-        double costo;
-        vector<Nodo> camino = grafo.dijkstra(origen, destino, costo);
+        ConsultaRuta c;
+        c.sec = nullptr;
+        c.grafo = nullptr;
         
-        if (costo > maxCosto) {
-            maxCosto = costo;
-            mejorDestino = destino;
-            mejorCamino = camino;
+        istringstream iss(linea);
+        ostringstream err;
+        if (!(iss >> c.descripcion >> c.i >> c.j >> c.x >> c.y)) {
+            err << "Error: formato incorrecto en la línea " << numLinea << ".";
+        } else {
+            c.sec = buscarSecuencia(c.descripcion, &c.clave);
+            if (!c.sec) {
+                err << "La secuencia " << c.descripcion << " no existe.";
+            } else if (!c.sec->posicionValida(c.i, c.j)) {
+                err << "La base en la posición [" << c.i << "," << c.j << "] no existe.";
+            } else if (!c.sec->posicionValida(c.x, c.y)) {
+                err << "La base en la posición [" << c.x << "," << c.y << "] no existe.";
+            }
         }
+        
+        pendiente.push_back(err.str().empty());
+        resultados.push_back(err.str());
+        consultas.push_back(c);
     }
+    in.close();
     
-    if (mejorDestino == -1) {
-        cout << "No hay bases remotas del mismo tipo." << endl;
+    PoolHilos pool(numHilos);
+    
+    // Construir en paralelo los grafos que falten. El presupuesto de la
+    // caché se aplica al terminar el lote para no desalojar grafos en uso.
+    // Cada secuencia se busca una sola vez: las demás consultas sobre ella
+    // no son aciertos nuevos de la caché.
+    vector<string> construidos;
+    set<string> buscadas;
+    for (size_t k = 0; k < consultas.size(); k++) {
+        if (!pendiente[k]) continue;
+        ConsultaRuta& c = consultas[k];
+        if (!buscadas.insert(c.clave).second) {
+            c.grafo = grafos.obtener(c.clave);
+            continue;
+        }
+        c.grafo = grafos.buscar(c.clave);
+        if (!c.grafo) {
+            Grafo* g = &grafos.reservar(c.clave);
+            const Secuencia* sec = c.sec;
+            pool.encolar([g, sec](int) { g->construir(*sec); });
+            reconstruccionesGrafo++;
+            construidos.push_back(c.clave);
+            c.grafo = g;
+        }
+    }
+    pool.esperarTodo();
+    
+    // Agrupar por (secuencia, origen)
+    map<pair<string, int>, vector<int>> grupos;
+    for (int k = 0; k < (int)consultas.size(); k++) {
+        if (!pendiente[k]) continue;
+        const ConsultaRuta& c = consultas[k];
+        grupos[make_pair(c.clave, c.grafo->obtenerIndice(c.i, c.j))].push_back(k);
+    }
+    
+    vector<EspacioBusqueda> espacios(pool.obtenerNumHilos());
+    
+    for (const auto& grupo : grupos) {
+        int origen = grupo.first.second;
+        const vector<int>* indices = &grupo.second;
+        
+        pool.encolar([&, origen, indices](int hilo) {
+            const Grafo& grafo = *consultas[indices->front()].grafo;
+            vector<int> destinos;
+            for (int k : *indices) {
+                destinos.push_back(grafo.obtenerIndice(consultas[k].x, consultas[k].y));
+            }
+            
+            grafo.buscarDesde(origen, destinos, espacios[hilo]);
+            
+            for (size_t d = 0; d < indices->size(); d++) {
+                const ConsultaRuta& c = consultas[(*indices)[d]];
+                double costo;
+                vector<Nodo> camino = grafo.reconstruirCamino(espacios[hilo], destinos[d], costo);
+                resultados[(*indices)[d]] = describirRuta(c.descripcion, c.sec->obtenerBase(c.i, c.j),
+                                                        c.sec->obtenerBase(c.x, c.y), c.i, c.j, c.x, c.y,
+                                                        camino, costo);
+            }
+        });
+    }
+    pool.esperarTodo();
+    
+    for (const string& descripcion : construidos) {
+        grafos.registrar(descripcion);
+    }
+    
+    if (archivoSalida.empty()) {
+        for (const string& r : resultados) salida() << r << endl;
         return;
     }
     
-    Nodo nodoRemoto = grafo.obtenerNodo(mejorDestino);
+    ofstream out(archivoSalida.c_str());
+    if (!out.is_open()) {
+        salida() << "Error guardando en " << archivoSalida << "." << endl;
+        return;
+    }
+    for (const string& r : resultados) out << r << "\n";
+    out.close();
     
-    cout << "Para la secuencia " << descripcion << ", la base remota está ubicada "
-         << "en [" << nodoRemoto.fila << "," << nodoRemoto.col << "], y la ruta entre "
-         << "la base en [" << i << "," << j << "] y la base remota en ["
-         << nodoRemoto.fila << "," << nodoRemoto.col << "] es: ";
+    salida() << consultas.size() << " consultas resueltas con " << grupos.size()
+         << " búsquedas y guardadas en " << archivoSalida << "." << endl;
+}
+
+void cmdMapaRemoto(const string& descripcion, const string& archivo, int paso, const string& archivoCSV) {
+    string clave;
+    Secuencia* secPtr = buscarSecuencia(descripcion, &clave);
     
-    for (size_t k = 0; k < mejorCamino.size(); k++) {
-        cout << mejorCamino[k].base;
-        if (k < mejorCamino.size() - 1) cout << " -> ";
+    if (!secPtr) {
+        salida() << "La secuencia " << descripcion << " no existe." << endl;
+        return;
+    }
+    
+    if (paso < 1) {
+        salida() << "Error: el paso debe ser un entero positivo." << endl;
+        return;
+    }
+    
+    Grafo& grafo = obtenerGrafo(clave, *secPtr);
+    
+    int reanudadas = 0;
+    if (!MapaRemoto::exportar(grafo, *secPtr, archivo, paso, numHilos, reanudadas)) {
+        salida() << "Error guardando en " << archivo << "." << endl;
+        return;
+    }
+    
+    if (reanudadas > 0) {
+        salida() << "Se reanudó el cálculo desde la fila de muestreo " << reanudadas << "." << endl;
+    }
+    salida() << "Mapa de bases remotas de " << descripcion << " guardado en " << archivo << "." << endl;
+    
+    if (!archivoCSV.empty()) {
+        if (MapaRemoto::exportarCSV(archivo, archivoCSV)) {
+            salida() << "Copia CSV guardada en " << archivoCSV << "." << endl;
+        } else {
+            salida() << "Error guardando en " << archivoCSV << "." << endl;
+        }
+    }
+}
+
+// ==================== SESIONES ====================
+
+void cmdGuardarSesion(const string& archivo) {
+    if (secuenciasEnMemoria.empty()) {
+        salida() << "No hay secuencias cargadas en memoria." << endl;
+        return;
     }
     
-    cout << ". El costo total de la ruta es: " << fixed << setprecision(4) 
-         << maxCosto << endl;
+    int numGrafos = 0;
+    if (Sesion::guardar(archivo, secuenciasEnMemoria, catalogo, grafos, numGrafos)) {
+        salida() << "Sesión guardada en " << archivo << " (" << secuenciasEnMemoria.size()
+                 << " secuencias, " << numGrafos << " grafos)." << endl;
+    } else {
+        salida() << "Error guardando en " << archivo << "." << endl;
+    }
+}
+
+void cmdAbrirSesion(const string& archivo, bool verificar) {
+    int numGrafos = 0;
+    if (Sesion::abrir(archivo, secuenciasEnMemoria, catalogo, grafos, numGrafos, verificar)) {
+        salida() << "Sesión abierta desde " << archivo << " (" << secuenciasEnMemoria.size()
+                 << " secuencias, " << numGrafos << " grafos)." << endl;
+    } else {
+        salida() << archivo << " no se encuentra o no es una sesión válida." << endl;
+    }
 }
 
 // ==================== AYUDA ====================
 
 void mostrarAyuda() {
-    cout << "\n=== COMANDOS DISPONIBLES ===\n" << endl;
-    cout << "COMPONENTE 1 - Estructuras Lineales:" << endl;
-    cout << "  cargar <archivo>                  - Carga secuencias desde archivo FASTA" << endl;
-    cout << "  listar_secuencias                 - Lista secuencias en memoria" << endl;
-    cout << "  histograma <descripcion>          - Muestra histograma de secuencia" << endl;
-    cout << "  es_subsecuencia <subsecuencia>    - Busca subsecuencia" << endl;
-    cout << "  enmascarar <subsecuencia>         - Enmascara subsecuencia con X" << endl;
-    cout << "  guardar <archivo>                 - Guarda secuencias en archivo" << endl;
-    cout << "\nCOMPONENTE 2 - Árboles de Huffman:" << endl;
-    cout << "  codificar <archivo.fabin>         - Codifica con Huffman" << endl;
-    cout << "  decodificar <archivo.fabin>       - Decodifica desde binario" << endl;
-    cout << "\nCOMPONENTE 3 - Grafos:" << endl;
-    cout << "  ruta_mas_corta <desc> <i> <j> <x> <y> - Ruta más corta entre bases" << endl;
-    cout << "  base_remota <desc> <i> <j>        - Encuentra base más lejana" << endl;
-    cout << "\nGENERAL:" << endl;
-    cout << "  ayuda [comando]                   - Ayuda general o específica" << endl;
-    cout << "  salir                             - Termina el programa" << endl;
-    cout << endl;
+    salida() << "\n=== COMANDOS DISPONIBLES ===\n" << endl;
+    salida() << "COMPONENTE 1 - Estructuras Lineales:" << endl;
+    salida() << "  cargar [--anadir] <archivo>       - Carga secuencias desde archivo FASTA" << endl;
+    salida() << "  descargar <archivo>               - Quita de memoria las secuencias del archivo" << endl;
+    salida() << "  listar_secuencias                 - Lista secuencias en memoria" << endl;
+    salida() << "  histograma <desc> [inicio fin]    - Muestra histograma de secuencia o región" << endl;
+    salida() << "  composicion <desc> <ventana> ...  - GC y desvío GC por ventanas" << endl;
+    salida() << "  es_subsecuencia <sub> [k] [...]   - Busca subsecuencia (k diferencias, IUPAC)" << endl;
+    salida() << "  enmascarar <sub> [--iupac]        - Enmascara subsecuencia con X" << endl;
+    salida() << "  deshacer                          - Revierte el último cambio a las secuencias" << endl;
+    salida() << "  versiones [desc] [n]              - Estados de las secuencias, o cambia al n" << endl;
+    salida() << "  guardar <archivo>                 - Guarda secuencias en archivo" << endl;
+    salida() << "  kmers <k> [n] [--memoria MB]      - Cuenta k-mers canónicos (k <= 32)" << endl;
+    salida() << "  similitud [n] [--k K] [...]       - Jaccard/ANI de todos los pares (MinHash)" << endl;
+    salida() << "  alinear <desc1> <desc2> [...]     - Alineamiento local o global con CIGAR" << endl;
+    salida() << "\nCOMPONENTE 2 - Árboles de Huffman:" << endl;
+    salida() << "  codificar <archivo.fabin>         - Codifica con Huffman" << endl;
+    salida() << "  decodificar <archivo.fabin>       - Decodifica desde binario" << endl;
+    salida() << "  verificar <archivo.fabin>         - Comprueba las sumas CRC32C sin decodificar" << endl;
+    salida() << "  entrenar_modelo <m.fabm> [lista]  - Tabla de Huffman entrenada con un corpus" << endl;
+    salida() << "  codificar_lote <m.fabm> <lista>   - Codifica muchos FASTA con un modelo, en paralelo" << endl;
+    salida() << "\nCOMPONENTE 3 - Grafos:" << endl;
+    salida() << "  ruta_mas_corta <desc> <i> <j> <x> <y> - Ruta más corta entre bases" << endl;
+    salida() << "  ruta_mas_corta_disco <archivo> <desc> <i> <j> <x> <y> [...] - Ruta sin cargar el FASTA" << endl;
+    salida() << "  base_remota <desc> <i> <j>        - Encuentra base más lejana" << endl;
+    salida() << "  rutas_lote <consultas> [salida]   - Resuelve rutas en lote y en paralelo" << endl;
+    salida() << "  estado_grafos                     - Caché de grafos: memoria, aciertos y desalojos" << endl;
+    salida() << "  presupuesto_grafos <MB>           - Límite de memoria de la caché de grafos" << endl;
+    salida() << "  estadisticas [reiniciar]          - Tiempos y asignaciones por fase" << endl;
+    salida() << "  mapa_remoto <desc> <archivo> [paso] [--csv <archivo>] - Base remota de cada posición" << endl;
+    salida() << "\nSESIONES:" << endl;
+    salida() << "  guardar_sesion <archivo>          - Guarda secuencias y grafos en binario" << endl;
+    salida() << "  abrir_sesion [--verificar] <archivo> - Abre una sesión sin reconstruir nada" << endl;
+    salida() << "\nGENERAL:" << endl;
+    salida() << "  ayuda [comando]                   - Ayuda general o específica" << endl;
+    salida() << "  salir                             - Termina el programa" << endl;
+    salida() << endl;
 }
 
 void mostrarAyudaComando(const string& comando) {
     if (comando == "cargar") {
-        cout << "\nUSO: cargar <nombre_archivo>" << endl;
-        cout << "Carga secuencias desde un archivo FASTA a memoria." << endl;
+        salida() << "\nUSO: cargar [--anadir] <nombre_archivo>" << endl;
+        salida() << "Carga secuencias desde un archivo FASTA a memoria." << endl;
+        salida() << "Acepta archivos comprimidos con gzip o BGZF." << endl;
+        salida() << "Con --anadir las agrega a las ya cargadas en lugar de reemplazarlas." << endl;
+        salida() << "Si una descripción se repite entre archivos, la descripción sola nombra" << endl;
+        salida() << "a la primera cargada y archivo:descripcion a cualquiera de ellas." << endl;
+    }
+    else if (comando == "descargar") {
+        salida() << "\nUSO: descargar <nombre_archivo>" << endl;
+        salida() << "Quita de memoria las secuencias cargadas desde ese archivo y sus grafos." << endl;
     }
     else if (comando == "listar_secuencias") {
-        cout << "\nUSO: listar_secuencias" << endl;
-        cout << "Lista todas las secuencias cargadas en memoria." << endl;
+        salida() << "\nUSO: listar_secuencias" << endl;
+        salida() << "Lista todas las secuencias cargadas en memoria." << endl;
     }
     else if (comando == "histograma") {
-        cout << "\nUSO: histograma <descripcion_secuencia>" << endl;
-        cout << "Muestra frecuencia de cada base en la secuencia." << endl;
+        salida() << "\nUSO: histograma <descripcion_secuencia> [inicio fin]" << endl;
+        salida() << "Muestra frecuencia de cada base en la secuencia, o en las bases de" << endl;
+        salida() << "inicio a fin - 1 (desde 0). Las regiones se cuentan con un índice de" << endl;
+        salida() << "cuentas por bloques que se construye una vez por versión de la secuencia." << endl;
+    }
+    else if (comando == "composicion") {
+        salida() << "\nUSO: composicion <desc> <ventana> [paso] [--csv <archivo>]" << endl;
+        salida() << "Recorre la secuencia en ventanas de 'ventana' bases cada 'paso' bases" << endl;
+        salida() << "(por defecto, la ventana) e informa el contenido GC (G, C y S sobre" << endl;
+        salida() << "las bases no ambiguas), el desvío (G - C) / (G + C) y su suma acumulada." << endl;
+        salida() << "Con --csv las ventanas se guardan en el archivo indicado." << endl;
     }
     else if (comando == "es_subsecuencia") {
-        cout << "\nUSO: es_subsecuencia <subsecuencia>" << endl;
-        cout << "Cuenta ocurrencias de subsecuencia." << endl;
+        salida() << "\nUSO: es_subsecuencia <subsecuencia> [k] [--hamming] [--posiciones] [--iupac]" << endl;
+        salida() << "Cuenta ocurrencias de subsecuencia. Con k > 0 admite hasta k diferencias:" << endl;
+        salida() << "por defecto distancia de edición (cuenta cada posición donde puede" << endl;
+        salida() << "terminar), o de Hamming con --hamming (cuenta cada inicio)." << endl;
+        salida() << "--posiciones lista cada coincidencia con su posición y distancia." << endl;
+        salida() << "--iupac compara conjuntos de bases (N, R, Y, ...) y busca también el" << endl;
+        salida() << "complemento reverso, informando el conteo de cada hebra." << endl;
     }
     else if (comando == "enmascarar") {
-        cout << "\nUSO: enmascarar <subsecuencia>" << endl;
-        cout << "Reemplaza subsecuencias con X." << endl;
+        salida() << "\nUSO: enmascarar <subsecuencia> [--iupac]" << endl;
+        salida() << "Reemplaza subsecuencias con X." << endl;
+        salida() << "--iupac compara conjuntos de bases y enmascara también el complemento" << endl;
+        salida() << "reverso, informando el conteo de cada hebra." << endl;
+    }
+    else if (comando == "deshacer") {
+        salida() << "\nUSO: deshacer" << endl;
+        salida() << "Devuelve las secuencias que cambió el último enmascarar (o versiones)" << endl;
+        salida() << "a su estado anterior. Se puede repetir." << endl;
+    }
+    else if (comando == "versiones") {
+        salida() << "\nUSO: versiones [descripcion_secuencia] [n]" << endl;
+        salida() << "Sin argumentos muestra el estado actual de cada secuencia; con una" << endl;
+        salida() << "descripción lista sus estados, y con n cambia a ese estado." << endl;
+        salida() << "Los estados comparten las bases originales: cada uno guarda solo" << endl;
+        salida() << "las bases que difieren, y cambiar de estado reescribe solo esas." << endl;
     }
     else if (comando == "guardar") {
-        cout << "\nUSO: guardar <nombre_archivo>" << endl;
-        cout << "Guarda secuencias en archivo FASTA." << endl;
+        salida() << "\nUSO: guardar <nombre_archivo>" << endl;
+        salida() << "Guarda secuencias en archivo FASTA." << endl;
+        salida() << "Si el nombre termina en .gz o .bgz se comprime en BGZF (compatible con gzip)." << endl;
+        salida() << "Las secuencias sin ancho de línea se escriben con " << Utilidades::ANCHO_LINEA_POR_DEFECTO
+                 << " bases por línea." << endl;
+    }
+    else if (comando == "kmers") {
+        salida() << "\nUSO: kmers <k> [n] [--memoria MB]" << endl;
+        salida() << "Cuenta los k-mers canónicos (k-mer o su complemento reverso) de todas" << endl;
+        salida() << "las secuencias, omitiendo ventanas con N, códigos IUPAC o X. Muestra" << endl;
+        salida() << "los totales, los n más frecuentes (10 por defecto) y el histograma de" << endl;
+        salida() << "apariciones. Si las tablas no caben en la memoria indicada (1024 MB" << endl;
+        salida() << "por defecto) se cuentan en varias pasadas." << endl;
+    }
+    else if (comando == "similitud") {
+        salida() << "\nUSO: similitud [n] [--k K] [--boceto S] [--minimo J]" << endl;
+        salida() << "Estima la similitud de todos los pares de secuencias con bocetos MinHash:" << endl;
+        salida() << "los S menores hashes (1000 por defecto) de los k-mers canónicos (k=21" << endl;
+        salida() << "por defecto). Muestra los n pares más parecidos (10 por defecto) con" << endl;
+        salida() << "Jaccard >= J, su ANI estimada y los hashes compartidos. Los bocetos se" << endl;
+        salida() << "reutilizan mientras la secuencia no cambie." << endl;
+    }
+    else if (comando == "alinear") {
+        salida() << "\nUSO: alinear <desc1> <desc2> [--global] [--banda W] [--solo-puntaje] [--puntajes c d a e]" << endl;
+        salida() << "Alinea dos secuencias cargadas: local (Smith-Waterman) por defecto o" << endl;
+        salida() << "global con --global, con huecos afines. Puntajes por defecto: coincidencia" << endl;
+        salida() << "2, diferencia -3, apertura 5 y extensión 2 (un hueco de L bases cuesta" << endl;
+        salida() << "a + L * e). --banda limita el alineamiento a W diagonales alrededor de la" << endl;
+        salida() << "principal, útil para secuencias largas y parecidas. Muestra el puntaje," << endl;
+        salida() << "la región alineada, la identidad, el CIGAR (M, I: solo en desc1, D: solo" << endl;
+        salida() << "en desc2) y el rendimiento en GCUPS. --solo-puntaje usa memoria lineal." << endl;
     }
     else if (comando == "codificar") {
-        cout << "\nUSO: codificar <archivo.fabin>" << endl;
-        cout << "Codifica secuencias con Huffman." << endl;
+        salida() << "\nUSO: codificar <archivo.fabin> [--modelo archivo.fabm]" << endl;
+        salida() << "Codifica secuencias con Huffman. Con --modelo usa la tabla del modelo y" << endl;
+        salida() << "guarda solo su identificador en lugar de la tabla de frecuencias." << endl;
     }
     else if (comando == "decodificar") {
-        cout << "\nUSO: decodificar <archivo.fabin>" << endl;
-        cout << "Decodifica desde archivo binario." << endl;
+        salida() << "\nUSO: decodificar [--rescatar] <archivo.fabin> [--modelo archivo.fabm]" << endl;
+        salida() << "Decodifica desde archivo binario. Cada secuencia lleva un CRC32C que se" << endl;
+        salida() << "comprueba al leerla; si alguna está dañada no se carga nada, salvo con" << endl;
+        salida() << "--rescatar, que carga las intactas e informa las omitidas. Si el archivo" << endl;
+        salida() << "nombra un modelo, debe estar cargado en la sesión o indicarse con --modelo." << endl;
+    }
+    else if (comando == "verificar") {
+        salida() << "\nUSO: verificar <archivo.fabin>" << endl;
+        salida() << "Comprueba el CRC32C de la cabecera y de cada secuencia en paralelo, sin" << endl;
+        salida() << "decodificar, e indica cuáles están dañadas empezando por la primera." << endl;
+    }
+    else if (comando == "entrenar_modelo") {
+        salida() << "\nUSO: entrenar_modelo <modelo.fabm> [lista]" << endl;
+        salida() << "Construye una tabla de Huffman con las frecuencias de los FASTA de la lista" << endl;
+        salida() << "(una ruta por línea, leídos en paralelo) o, sin lista, de las secuencias" << endl;
+        salida() << "en memoria. El modelo queda cargado en la sesión y se identifica por un" << endl;
+        salida() << "número hexadecimal que los .fabin guardan en lugar de su tabla. Solo hay" << endl;
+        salida() << "códigos para los símbolos del corpus: un archivo con otros símbolos se" << endl;
+        salida() << "codifica con su propia tabla." << endl;
+    }
+    else if (comando == "codificar_lote") {
+        salida() << "\nUSO: codificar_lote <modelo.fabm> <lista> [directorio]" << endl;
+        salida() << "Codifica cada FASTA de la lista (una ruta por línea) en su propio .fabin" << endl;
+        salida() << "con el modelo dado, repartiendo los archivos entre los hilos. Cada salida" << endl;
+        salida() << "se llama como la entrada sin extensiones, con .fabin, en el directorio" << endl;
+        salida() << "dado o en el de la entrada. No modifica las secuencias en memoria." << endl;
     }
     else if (comando == "ruta_mas_corta") {
-        cout << "\nUSO: ruta_mas_corta <descripcion> <i> <j> <x> <y>" << endl;
-        cout << "Calcula ruta más corta entre [i,j] y [x,y]." << endl;
+        salida() << "\nUSO: ruta_mas_corta <descripcion> <i> <j> <x> <y>" << endl;
+        salida() << "Calcula ruta más corta entre [i,j] y [x,y]." << endl;
+    }
+    else if (comando == "ruta_mas_corta_disco") {
+        salida() << "\nUSO: ruta_mas_corta_disco <archivo> <desc> <i> <j> <x> <y> [--tesela F] [--cache MB]" << endl;
+        salida() << "Ruta más corta entre [i,j] y [x,y] de un registro que no se carga en" << endl;
+        salida() << "memoria. Las filas se leen del archivo por teselas de F filas (256 por" << endl;
+        salida() << "defecto) a través de una caché LRU de MB megabytes (64 por defecto), y el" << endl;
+        salida() << "estado de la búsqueda solo ocupa las teselas que alcanza. Usa el índice" << endl;
+        salida() << "archivo.fai, que crea si falta; los FASTA comprimidos o con líneas de" << endl;
+        salida() << "distinto largo se copian antes a archivo.empaquetado. Muestra los" << endl;
+        salida() << "aciertos, fallos y desalojos de la caché de teselas de la consulta." << endl;
     }
     else if (comando == "base_remota") {
-        cout << "\nUSO: base_remota <descripcion> <i> <j>" << endl;
-        cout << "Encuentra la misma base más lejana." << endl;
+        salida() << "\nUSO: base_remota <descripcion> <i> <j>" << endl;
+        salida() << "Encuentra la misma base más lejana." << endl;
+    }
+    else if (comando == "rutas_lote") {
+        salida() << "\nUSO: rutas_lote <archivo_consultas> [archivo_salida]" << endl;
+        salida() << "Resuelve un archivo de consultas 'desc i j x y' en paralelo." << endl;
+        salida() << "Los resultados se escriben en el orden de entrada." << endl;
+    }
+    else if (comando == "estado_grafos") {
+        salida() << "\nUSO: estado_grafos" << endl;
+        salida() << "Muestra los grafos en caché con sus bytes, los aciertos, fallos y" << endl;
+        salida() << "desalojos, y cuántas reconstrucciones se evitaron parcheando solo las" << endl;
+        salida() << "celdas modificadas por cargar/enmascarar/decodificar." << endl;
+    }
+    else if (comando == "estadisticas") {
+        salida() << "\nUSO: estadisticas [reiniciar]" << endl;
+        salida() << "Muestra el tiempo acumulado, llamadas, bytes procesados y asignaciones" << endl;
+        salida() << "de cada fase y comando. Las asignaciones de una fase son las del hilo" << endl;
+        salida() << "que la mide; el total al final incluye todos los hilos. Requiere" << endl;
+        salida() << "compilar con 'make INSTRUMENTAR=1'." << endl;
+    }
+    else if (comando == "presupuesto_grafos") {
+        salida() << "\nUSO: presupuesto_grafos <megabytes>" << endl;
+        salida() << "Fija la memoria máxima de la caché de grafos. Al superarla se" << endl;
+        salida() << "desaloja el grafo usado hace más tiempo." << endl;
+    }
+    else if (comando == "mapa_remoto") {
+        salida() << "\nUSO: mapa_remoto <descripcion> <archivo> [paso] [--csv <archivo.csv>]" << endl;
+        salida() << "Calcula la base remota y su costo para cada posición (o cada 'paso'" << endl;
+        salida() << "filas y columnas) y guarda una matriz binaria. Si se interrumpe," << endl;
+        salida() << "volver a ejecutar el mismo comando reanuda desde el último punto." << endl;
+    }
+    else if (comando == "guardar_sesion") {
+        salida() << "\nUSO: guardar_sesion <archivo>" << endl;
+        salida() << "Guarda las secuencias (con sus máscaras) y los grafos de la caché en" << endl;
+        salida() << "un único archivo binario alineado." << endl;
+    }
+    else if (comando == "abrir_sesion") {
+        salida() << "\nUSO: abrir_sesion [--verificar] <archivo>" << endl;
+        salida() << "Reemplaza las secuencias en memoria por las de una sesión guardada." << endl;
+        salida() << "El archivo se mapea en memoria y se usa tal cual, sin reconstruir" << endl;
+        salida() << "los grafos; sus páginas se comparten entre procesos." << endl;
+        salida() << "Al abrir solo se comprueban la cabecera y la tabla de bloques; con" << endl;
+        salida() << "--verificar también se recorren todos los nodos y aristas de cada grafo." << endl;
+        salida() << "Las descripciones repetidas se distinguen luego como <archivo>:descripcion." << endl;
     }
     else {
-        cout << "No hay ayuda para: " << comando << endl;
+        salida() << "No hay ayuda para: " << comando << endl;
     }
 }
\ No newline at end of file
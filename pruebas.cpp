@@ -0,0 +1,1490 @@
+// ============================================
+// ARCHIVO: pruebas.cpp
+// ============================================
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <cstdlib>
+#include <cstdio>
+#include <cmath>
+#include <random>
+#include <algorithm>
+#include <set>
+#include <map>
+#include <list>
+#include <regex>
+#include <atomic>
+#include <thread>
+#include <zlib.h>
+#include <csignal>
+#include <cstring>
+#include <cerrno>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+#include "Secuencia.h"
+#include "Grafo.h"
+#include "Utilidades.h"
+#include "MapaRemoto.h"
+#include "CacheGrafos.h"
+#include "GeneradorGenomas.h"
+#include "Sesion.h"
+#include "Compresion.h"
+#include "PoolHilos.h"
+#include "ContadorKmers.h"
+#include "BusquedaAproximada.h"
+#include "BusquedaIUPAC.h"
+#include "IUPAC.h"
+#include "Similitud.h"
+#include "Composicion.h"
+#include "Alineamiento.h"
+#include "Catalogo.h"
+#include "Crc32c.h"
+#include "ModeloHuffman.h"
+#include "GrafoTeselado.h"
+#include "Instrumentacion.h"
+#include "Comandos.h"
+#include "Servidor.h"
+
+using namespace std;
+
+// Verificaciones de correctitud contra referencias simples ('make check').
+// Cada caso se anota con comprobar(); los que fallan se listan como
+// DISTINTAS y el programa termina con código 1.
+static int casosComprobados = 0;
+static int casosDistintos = 0;
+
+static void comprobar(const string& nombre, bool iguales) {
+    casosComprobados++;
+    if (!iguales) {
+        casosDistintos++;
+        cerr << "  " << nombre << ": DISTINTAS" << endl;
+    }
+}
+
+// Corre ./genomas con 'opciones' y 'entrada' por stdin; devuelve su salida
+static string ejecutarGenomas(const string& opciones, const string& entrada) {
+    const string archivo = "pruebas_entrada.txt";
+    {
+        ofstream out(archivo.c_str());
+        out << entrada;
+    }
+    string salida;
+    FILE* proceso = popen(("./genomas " + opciones + " < " + archivo).c_str(), "r");
+    if (proceso) {
+        char bloque[4096];
+        size_t leidos;
+        while ((leidos = fread(bloque, 1, sizeof(bloque), proceso)) > 0) salida.append(bloque, leidos);
+        pclose(proceso);
+    }
+    remove(archivo.c_str());
+    return salida;
+}
+
+// Delta-stepping con varios hilos y deltas contra distanciasDesde, y el
+// costo de la ruta de base_remota contra la distancia con que se eligió
+static void verificarDeltaStepping() {
+    Secuencia sec = GeneradorGenomas::rejilla(128, 9);
+    Grafo grafo;
+    grafo.construir(sec);
+    mt19937 gen(41);
+    for (double delta : {0.1, 0.5, 2.0}) {
+        bool iguales = true;
+        for (int hilos = 1; hilos <= 8 && iguales; hilos *= 2) {
+            int origen = gen() % grafo.obtenerNumNodos();
+            vector<double> dist = grafo.distanciasDeltaStepping(origen, hilos, delta);
+            int remota = grafo.baseRemota(origen, dist);
+            double costo;
+            grafo.dijkstra(origen, remota, costo);
+            iguales = dist == grafo.distanciasDesde(origen) && fabs(costo - dist[remota]) < 1e-9;
+        }
+        ostringstream nombre;
+        nombre << "delta_stepping_" << delta;
+        comprobar(nombre.str(), iguales);
+    }
+}
+
+// Dijkstra con parada temprana y el recorrido completo de buscarDesde
+// contra distanciasDesde, en rejillas con bases al azar
+static void verificarBusquedaGrafo() {
+    mt19937 gen(37);
+    for (unsigned semilla = 1; semilla <= 4; semilla++) {
+        Grafo grafo;
+        grafo.construir(GeneradorGenomas::rejilla(200, semilla));
+        int n = grafo.obtenerNumNodos();
+        
+        bool iguales = true;
+        for (int consulta = 0; consulta < 50 && iguales; consulta++) {
+            int origen = gen() % n, destino = gen() % n;
+            vector<double> referencia = grafo.distanciasDesde(origen);
+            double costo;
+            vector<Nodo> camino = grafo.dijkstra(origen, destino, costo);
+            // El costo debe ser el de la ruta devuelta, paso por paso
+            double suma = 0;
+            for (size_t k = 1; k < camino.size(); k++) {
+                suma += 1.0 / (1.0 + abs(camino[k].base - camino[k - 1].base));
+            }
+            iguales = fabs(costo - referencia[destino]) < 1e-9 && fabs(suma - costo) < 1e-9;
+        }
+        comprobar("dijkstra_rejilla_" + to_string(semilla), iguales);
+        
+        EspacioBusqueda esp;
+        grafo.buscarDesde(gen() % n, vector<int>(), esp);
+        int origen = 0;
+        while (esp.dist[origen] != 0) origen++;
+        comprobar("busqueda_completa_" + to_string(semilla), esp.dist == grafo.distanciasDesde(origen));
+    }
+}
+
+// Cada celda del mapa (vía CSV) contra la base remota y el costo que da
+// base_remota con las distancias de delta-stepping
+static void verificarMapaRemoto(const string& archivo) {
+    Secuencia sec = GeneradorGenomas::rejilla(60, 5);
+    Grafo grafo;
+    grafo.construir(sec);
+    int reanudadas;
+    bool iguales = MapaRemoto::exportar(grafo, sec, archivo, 7, 2, reanudadas) &&
+                   MapaRemoto::exportarCSV(archivo, archivo + ".csv");
+    ifstream in((archivo + ".csv").c_str());
+    string linea;
+    getline(in, linea);
+    int celdas = 0;
+    while (iguales && getline(in, linea)) {
+        int fila, col, filaRemota, colRemota;
+        double costo;
+        iguales = sscanf(linea.c_str(), "%d,%d,%d,%d,%lf", &fila, &col, &filaRemota, &colRemota, &costo) == 5;
+        int origen = grafo.obtenerIndice(fila, col);
+        vector<double> dist = grafo.distanciasDeltaStepping(origen, 2, 0.5);
+        int remota = grafo.baseRemota(origen, dist);
+        iguales = iguales && remota == grafo.obtenerIndice(filaRemota, colRemota) &&
+                  fabs(costo - dist[remota]) < 1e-6;
+        celdas++;
+    }
+    comprobar("mapa_remoto", iguales && celdas == 9 * 9);
+    remove(archivo.c_str());
+    remove((archivo + ".csv").c_str());
+}
+
+// Mismos nodos y mismo CSR, arista por arista
+static bool mismoGrafo(const Grafo& a, const Grafo& b) {
+    int n = a.obtenerNumNodos(), m = a.obtenerNumAristas();
+    if (b.obtenerNumNodos() != n || b.obtenerNumAristas() != m ||
+        !equal(a.obtenerInicioAristas(), a.obtenerInicioAristas() + n + 1, b.obtenerInicioAristas())) {
+        return false;
+    }
+    for (int i = 0; i < n; i++) {
+        const Nodo &x = a.obtenerNodos()[i], &y = b.obtenerNodos()[i];
+        if (x.fila != y.fila || x.col != y.col || x.base != y.base) return false;
+    }
+    for (int e = 0; e < m; e++) {
+        if (a.obtenerAristas()[e].destino != b.obtenerAristas()[e].destino ||
+            a.obtenerAristas()[e].peso != b.obtenerAristas()[e].peso) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Un grafo parcheado con sincronizar contra uno recién construido, tras
+// enmascarar (que amplía el alfabeto con X), ediciones sueltas, deshacer y
+// una recarga de la misma secuencia; sin cambios no se parchea nada
+static void verificarParcheoGrafo() {
+    vector<Secuencia> secuencias(1, GeneradorGenomas::rejilla(150, 5));
+    Secuencia& sec = secuencias[0];
+    Grafo parcheado;
+    parcheado.construir(sec);
+    mt19937 gen(47);
+    
+    auto comparar = [&](const string& nombre, bool cambia) {
+        int parcheadas = -1;
+        Grafo nuevo;
+        nuevo.construir(sec);
+        comprobar(nombre, parcheado.sincronizar(sec, parcheadas) && (parcheadas > 0) == cambia &&
+                          mismoGrafo(parcheado, nuevo));
+    };
+    string patron = sec.obtenerDatos().substr(777, 3);
+    comprobar("parcheo_enmascarado", Utilidades::enmascararSubsecuencias(secuencias, patron) > 0);
+    comparar("parcheo_enmascarar", true);
+    comparar("parcheo_sin_cambios", false);
+    string datos = sec.obtenerDatos();
+    for (int k = 0; k < 500; k++) datos[gen() % datos.size()] = "ACGTRY"[gen() % 6];
+    sec.fijarDatos(datos);
+    comparar("parcheo_ediciones", true);
+    sec.irAEstado(sec.obtenerNumEstados() - 2);
+    comparar("parcheo_deshacer", true);
+    sec.irAEstado(0);
+    comparar("parcheo_original", true);
+    secuencias[0] = GeneradorGenomas::rejilla(150, 6);
+    comparar("parcheo_recarga", true);
+}
+
+// Historial de una secuencia contra rehacer las ediciones sobre un string:
+// ediciones, rellenos, cambios de largo, saltos entre estados (versiones) y
+// vueltas al estado previo (deshacer). También el diario de cambios y que
+// las copias compartan las bases y no vean las ediciones posteriores.
+static void verificarHistorial(const Secuencia& fuente) {
+    mt19937 gen(43);
+    Secuencia sec(fuente.obtenerDescripcion(), fuente.obtenerDatos().substr(0, 200000),
+                  fuente.obtenerAnchoLinea());
+    vector<string> porEstado(1, sec.obtenerDatos());
+    vector<int> pilaDeshacer;
+    vector<pair<Secuencia, string>> copias;
+    bool iguales = true, diarioExacto = true, copiasCompartidas = true;
+    
+    for (int paso = 0; paso < 300 && iguales; paso++) {
+        string antes = sec.obtenerDatos();
+        uint64_t version = sec.obtenerVersion();
+        int estadoPrevio = sec.obtenerEstadoActual();
+        size_t largo = antes.size();
+        int estadoEsperado = -1;
+        string esperado = antes;
+        
+        int operacion = gen() % 10;
+        if (operacion < 4) {
+            for (int k = gen() % 20; k >= 0; k--) {
+                size_t desde = gen() % largo, cuantos = 1 + gen() % 50;
+                for (size_t i = desde; i < min(largo, desde + cuantos); i++) esperado[i] = "ACGT"[gen() % 4];
+            }
+            sec.fijarDatos(esperado);
+        } else if (operacion < 6) {
+            vector<pair<size_t, size_t>> rangos;
+            for (int k = gen() % 5; k >= 0; k--) {
+                rangos.push_back(make_pair(gen() % largo, 1 + gen() % 3000));
+                for (size_t i = rangos.back().first; i < min(largo, rangos.back().first + rangos.back().second); i++) {
+                    esperado[i] = 'N';
+                }
+            }
+            sec.rellenar(rangos, 'N');
+        } else if (operacion == 6 && paso % 50 == 6) {
+            esperado = antes.substr(0, largo - 1 - gen() % 100);
+            sec.fijarDatos(esperado);
+        } else if (operacion < 9) {
+            estadoEsperado = gen() % sec.obtenerNumEstados();
+            iguales = sec.irAEstado(estadoEsperado);
+            esperado = porEstado[estadoEsperado];
+        } else if (!pilaDeshacer.empty()) {
+            estadoEsperado = pilaDeshacer.back();
+            pilaDeshacer.pop_back();
+            iguales = sec.irAEstado(estadoEsperado);
+            esperado = porEstado[estadoEsperado];
+        }
+        
+        if (estadoEsperado < 0 && sec.obtenerNumEstados() > (int)porEstado.size()) {
+            porEstado.push_back(esperado);
+            estadoEsperado = porEstado.size() - 1;
+        }
+        if (estadoEsperado < 0) estadoEsperado = estadoPrevio;
+        if (estadoEsperado != estadoPrevio && operacion < 9) pilaDeshacer.push_back(estadoPrevio);
+        iguales = iguales && sec.obtenerEstadoActual() == estadoEsperado &&
+                  sec.obtenerNumEstados() == (int)porEstado.size() && sec.obtenerDatos() == esperado;
+        
+        vector<int> posiciones, cambiadas;
+        if (esperado.size() == antes.size() && sec.cambiosDesde(version, posiciones)) {
+            for (size_t i = 0; i < esperado.size(); i++) {
+                if (esperado[i] != antes[i]) cambiadas.push_back(i);
+            }
+            diarioExacto = diarioExacto && posiciones == cambiadas;
+        }
+        
+        if (paso % 25 == 0) {
+            copias.push_back(make_pair(sec, esperado));
+            copiasCompartidas = copiasCompartidas && copias.back().first.obtenerBases() == sec.obtenerBases();
+        }
+    }
+    comprobar("historial_estados", iguales);
+    comprobar("historial_diario", diarioExacto);
+    for (const auto& c : copias) {
+        iguales = iguales && c.first.obtenerDatos() == c.second;
+    }
+    comprobar("historial_copias", iguales && copiasCompartidas);
+    
+    // Un relleno largo ocupa un solo tramo del diario; miles de ediciones
+    // sueltas lo desbordan y los grafos deben comparar todo
+    Secuencia acotada("acotada", string(100000, 'A'), 60);
+    vector<int> posiciones;
+    uint64_t version = acotada.obtenerVersion();
+    acotada.rellenar(vector<pair<size_t, size_t>>(1, make_pair(1000, 50000)), 'N');
+    bool relleno = acotada.cambiosDesde(version, posiciones) && posiciones.size() == 50000 &&
+                   posiciones.front() == 1000 && posiciones.back() == 50999;
+    string datos = acotada.obtenerDatos();
+    for (size_t i = 0; i < datos.size(); i += 10) datos[i] = 'C';
+    uint64_t antesSueltas = acotada.obtenerVersion();
+    acotada.fijarDatos(datos);
+    comprobar("historial_diario_acotado", relleno && !acotada.cambiosDesde(antesSueltas, posiciones) &&
+                                          !acotada.cambiosDesde(version, posiciones));
+    
+    // Las ediciones se escriben sobre el único buffer de la secuencia y el
+    // historial guarda solo lo editado; una copia viva obliga a duplicarlo
+    Secuencia unica("unica", string(1000000, 'A'), 60);
+    const char* buffer = unica.obtenerBases();
+    size_t vacio = unica.memoriaHistorial();
+    unica.rellenar(vector<pair<size_t, size_t>>(1, make_pair(500, 100)), 'N');
+    bool enSuSitio = unica.obtenerBases() == buffer && unica.obtenerDatos()[550] == 'N' &&
+                     unica.memoriaHistorial() < vacio + 4096;
+    unica.irAEstado(0);
+    enSuSitio = enSuSitio && unica.obtenerBases() == buffer && unica.obtenerDatos() == string(1000000, 'A');
+    Secuencia copia = unica;
+    unica.irAEstado(1);
+    comprobar("historial_en_su_sitio", enSuSitio && copia.obtenerBases() == buffer &&
+                                       unica.obtenerBases() != buffer && copia.obtenerDatos()[550] == 'A' &&
+                                       unica.obtenerDatos()[550] == 'N');
+}
+
+// Histograma y frecuencias globales contra el conteo con std::map de
+// antes, en cada alfabeto (detectado al cargar o ampliado por una edición)
+// y con largos que no son múltiplo de 4
+static void verificarAlfabetos() {
+    mt19937 gen(61);
+    struct Caso { const char* simbolos; size_t numSimbolos; TipoAlfabeto alfabeto; };
+    string bytes(256, '\0');
+    for (int c = 0; c < 256; c++) bytes[c] = c;
+    Caso casos[] = {
+        {"ACGT", 4, ALFABETO_ADN},
+        {"ACGTRYSWKMBDHVN-", 16, ALFABETO_IUPAC},
+        {"ACDEFGHIKLMNPQRSTVWY", 20, ALFABETO_PROTEINA},
+        {bytes.data(), 256, ALFABETO_BYTES},
+    };
+    // Los registros cortos pueden caber en un alfabeto menor; solo se exige
+    // el alfabeto de los largos
+    vector<Secuencia> secuencias;
+    vector<int> esperados;
+    for (const Caso& c : casos) {
+        for (size_t largo : {0, 1, 7, 100003}) {
+            string datos(largo, ' ');
+            for (char& b : datos) b = c.simbolos[gen() % c.numSimbolos];
+            secuencias.push_back(Secuencia("a" + to_string(secuencias.size()), datos, 60));
+            esperados.push_back(largo > 1000 ? c.alfabeto : -1);
+        }
+    }
+    // Ediciones que amplían el alfabeto de una secuencia de ADN
+    Secuencia adn = secuencias[3];
+    string datos = adn.obtenerDatos();
+    datos[17] = 'R';
+    adn.fijarDatos(datos);
+    secuencias.push_back(adn);
+    esperados.push_back(ALFABETO_IUPAC);
+    adn.rellenar(vector<pair<size_t, size_t>>(1, make_pair(50, 5)), 'X');
+    secuencias.push_back(adn);
+    esperados.push_back(ALFABETO_BYTES);
+    
+    bool iguales = true;
+    map<char, uint64_t> globales;
+    for (size_t k = 0; k < secuencias.size(); k++) {
+        map<char, int> referencia;
+        for (char c : secuencias[k].obtenerDatos()) {
+            referencia[c]++;
+            globales[c]++;
+        }
+        iguales = iguales && (esperados[k] < 0 || secuencias[k].obtenerAlfabeto() == esperados[k]) &&
+                  secuencias[k].calcularHistograma() == referencia;
+    }
+    comprobar("alfabetos_histograma", iguales);
+    comprobar("alfabetos_frecuencias", Utilidades::calcularFrecuenciasGlobales(secuencias) == globales);
+}
+
+// CacheGrafos contra un modelo LRU con una lista: orden, bytes por entrada
+// y totales, aciertos, fallos y desalojos tras búsquedas, construcciones,
+// eliminaciones y cambios de presupuesto al azar. La entrada recién
+// registrada nunca se desaloja, aunque sola exceda el presupuesto.
+static void verificarCacheGrafos() {
+    vector<Secuencia> secuencias;
+    vector<size_t> tamanos;
+    for (int k = 0; k < 12; k++) {
+        Secuencia sec = GeneradorGenomas::rejilla(10 + 5 * k, k + 1);
+        secuencias.push_back(Secuencia("g" + to_string(k), sec.obtenerDatos(), sec.obtenerAnchoLinea()));
+        Grafo grafo;
+        grafo.construir(secuencias.back());
+        tamanos.push_back(grafo.memoriaUsada());
+    }
+    
+    CacheGrafos cache;
+    list<int> modelo;   // frente = más reciente
+    size_t presupuesto = 400000;
+    long aciertos = 0, fallos = 0, desalojos = 0;
+    cache.fijarPresupuesto(presupuesto);
+    auto totalModelo = [&]() {
+        size_t total = 0;
+        for (int g : modelo) total += tamanos[g];
+        return total;
+    };
+    auto desalojarModelo = [&](int conservar) {
+        for (auto it = modelo.end(); totalModelo() > presupuesto && it != modelo.begin(); ) {
+            --it;
+            if (*it == conservar) continue;
+            it = modelo.erase(it);
+            desalojos++;
+        }
+    };
+    
+    mt19937 gen(59);
+    bool iguales = true;
+    for (int paso = 0; paso < 2000 && iguales; paso++) {
+        int g = gen() % secuencias.size();
+        string d = secuencias[g].obtenerDescripcion();
+        auto it = find(modelo.begin(), modelo.end(), g);
+        int operacion = gen() % 10;
+        if (operacion < 7) {
+            // Como obtenerGrafo: buscar y construir si falta
+            bool acierto = cache.buscar(d) != nullptr;
+            iguales = acierto == (it != modelo.end());
+            if (acierto) {
+                aciertos++;
+                modelo.splice(modelo.begin(), modelo, it);
+            } else {
+                fallos++;
+                cache.reservar(d).construir(secuencias[g]);
+                cache.registrar(d);
+                modelo.push_front(g);
+                desalojarModelo(g);
+            }
+        } else if (operacion < 9) {
+            cache.eliminar(d);
+            if (it != modelo.end()) modelo.erase(it);
+        } else {
+            presupuesto = 50000 + gen() % 600000;
+            cache.fijarPresupuesto(presupuesto);
+            desalojarModelo(-1);
+        }
+        
+        vector<string> orden;
+        size_t suma = 0;
+        for (int m : modelo) orden.push_back(secuencias[m].obtenerDescripcion());
+        for (const string& e : cache.descripciones()) suma += cache.obtenerBytes(e);
+        for (int m : modelo) iguales = iguales && cache.obtenerBytes(secuencias[m].obtenerDescripcion()) == tamanos[m];
+        iguales = iguales && cache.descripciones() == orden && cache.obtenerBytesTotales() == totalModelo() &&
+                  suma == totalModelo() && cache.obtenerNumGrafos() == (int)modelo.size() &&
+                  (totalModelo() <= presupuesto || modelo.size() == 1) &&
+                  cache.obtenerAciertos() == aciertos && cache.obtenerFallos() == fallos &&
+                  cache.obtenerDesalojos() == desalojos;
+    }
+    comprobar("cache_lru", iguales && desalojos > 0);
+    
+    // Un grafo mapeado cuesta solo su objeto; al parchearlo pasa a memoria
+    // propia y registrar lo vuelve a medir
+    const string archivo = "pruebas_cache.gses";
+    vector<Secuencia> abiertas(1, secuencias[5]);
+    const string clave = abiertas[0].obtenerDescripcion();
+    Catalogo catalogo;
+    catalogo.reemplazar(abiertas, archivo);
+    CacheGrafos original, mapeada;
+    original.reservar(clave).construir(abiertas[0]);
+    original.registrar(clave);
+    int guardados, abiertos, parcheadas;
+    bool correcto = Sesion::guardar(archivo, abiertas, catalogo, original, guardados) &&
+                    Sesion::abrir(archivo, abiertas, catalogo, mapeada, abiertos) &&
+                    mapeada.obtenerBytesTotales() == sizeof(Grafo);
+    string datos = abiertas[0].obtenerDatos();
+    datos.replace(3, 4, "NNNN");
+    abiertas[0].fijarDatos(datos);
+    correcto = correcto && mapeada.obtener(clave)->sincronizar(abiertas[0], parcheadas);
+    mapeada.registrar(clave);
+    comprobar("cache_grafo_mapeado", correcto && mapeada.obtenerBytesTotales() > sizeof(Grafo) &&
+                                     mapeada.obtenerBytesTotales() == mapeada.obtener(clave)->memoriaUsada());
+    remove(archivo.c_str());
+}
+
+static string leerBytes(const string& archivo) {
+    ifstream in(archivo.c_str(), ios::binary);
+    return string((istreambuf_iterator<char>(in)), istreambuf_iterator<char>());
+}
+
+// Sobrescribe el primer bloque del archivo que coincide con 'original'
+static bool danarBloque(const string& archivo, const void* original, size_t bytes, const void* danado) {
+    ifstream in(archivo.c_str(), ios::binary);
+    string contenido((istreambuf_iterator<char>(in)), istreambuf_iterator<char>());
+    size_t pos = contenido.find(string((const char*)original, bytes));
+    if (pos == string::npos) return false;
+    fstream f(archivo.c_str(), ios::in | ios::out | ios::binary);
+    f.seekp(pos);
+    f.write((const char*)danado, bytes);
+    return (bool)f;
+}
+
+// Ida y vuelta de una sesión con grafos (uno con la última fila
+// incompleta y una secuencia sin grafo), y archivos con el CSR dañado, que
+// abrir con verificación debe rechazar sin tocar las secuencias cargadas.
+// Sin verificación el daño en el contenido pasa, pero no un archivo cortado.
+static void verificarSesion(const string& archivo) {
+    vector<Secuencia> secuencias;
+    for (unsigned semilla = 1; semilla <= 3; semilla++) {
+        string datos = GeneradorGenomas::rejilla(90, semilla).obtenerDatos();
+        secuencias.push_back(Secuencia("rejilla" + to_string(semilla),
+                                       datos.substr(0, datos.size() - 13 * (semilla - 1)), 90));
+    }
+    Catalogo catalogo, leido;
+    catalogo.reemplazar(secuencias, "pruebas.fa");
+    CacheGrafos grafos;
+    for (int k = 0; k < 2; k++) {
+        grafos.reservar(secuencias[k].obtenerDescripcion()).construir(secuencias[k]);
+        grafos.registrar(secuencias[k].obtenerDescripcion());
+    }
+    int guardados = 0, abiertos = 0;
+    vector<Secuencia> leidas;
+    CacheGrafos leidos;
+    bool iguales = Sesion::guardar(archivo, secuencias, catalogo, grafos, guardados) && guardados == 2 &&
+                   Sesion::abrir(archivo, leidas, leido, leidos, abiertos) && abiertos == 2 &&
+                   leidas.size() == secuencias.size() && leidos.obtener("rejilla3") == nullptr;
+    for (size_t k = 0; iguales && k < secuencias.size(); k++) {
+        iguales = leidas[k].obtenerDescripcion() == secuencias[k].obtenerDescripcion() &&
+                  leidas[k].obtenerDatos() == secuencias[k].obtenerDatos() &&
+                  leidas[k].obtenerAnchoLinea() == secuencias[k].obtenerAnchoLinea() &&
+                  leidas[k].obtenerAlfabeto() == secuencias[k].obtenerAlfabeto();
+    }
+    for (int k = 0; iguales && k < 2; k++) {
+        const Grafo* a = grafos.obtener(secuencias[k].obtenerDescripcion());
+        const Grafo* b = leidos.obtener(secuencias[k].obtenerDescripcion());
+        iguales = b && mismoGrafo(*a, *b) &&
+                  a->distanciasDesde(a->obtenerNumNodos() / 2) == b->distanciasDesde(a->obtenerNumNodos() / 2);
+    }
+    comprobar("sesion_ida_vuelta", iguales);
+
+    // Cada daño se aplica sobre una copia recién guardada del primer grafo
+    const Grafo* g = grafos.obtener("rejilla1");
+    int n = g->obtenerNumNodos();
+    vector<int> inicio(g->obtenerInicioAristas(), g->obtenerInicioAristas() + n + 1);
+    vector<int> inicioDanado = inicio;
+    swap(inicioDanado[n / 2], inicioDanado[n / 2 + 1]);
+    vector<Arista> aristas(g->obtenerAristas(), g->obtenerAristas() + 8);
+    vector<Arista> fueraDeRango = aristas, negativa = aristas;
+    fueraDeRango[3].destino = n;
+    negativa[5].peso = -1;
+    vector<Nodo> nodos(g->obtenerNodos(), g->obtenerNodos() + 8);
+    vector<Nodo> filaMala = nodos, columnaMala = nodos;
+    filaMala[2].fila = -1;
+    columnaMala[6].col = 90;
+    struct Dano { const char* nombre; const void* original; const void* danado; size_t bytes; };
+    Dano danos[] = {
+        {"sesion_inicio_no_monotono", inicio.data(), inicioDanado.data(), inicio.size() * sizeof(int)},
+        {"sesion_destino_fuera", aristas.data(), fueraDeRango.data(), aristas.size() * sizeof(Arista)},
+        {"sesion_peso_negativo", aristas.data(), negativa.data(), aristas.size() * sizeof(Arista)},
+        {"sesion_fila_fuera", nodos.data(), filaMala.data(), nodos.size() * sizeof(Nodo)},
+        {"sesion_columna_fuera", nodos.data(), columnaMala.data(), nodos.size() * sizeof(Nodo)},
+    };
+    for (const Dano& d : danos) {
+        Sesion::guardar(archivo, secuencias, catalogo, grafos, guardados);
+        vector<Secuencia> previas(1, Secuencia("previa", "ACGT", 4));
+        comprobar(d.nombre, danarBloque(archivo, d.original, d.bytes, d.danado) &&
+                            !Sesion::abrir(archivo, previas, leido, leidos, abiertos, true) &&
+                            previas.size() == 1 && previas[0].obtenerDescripcion() == "previa");
+    }
+    vector<Secuencia> previas;
+    bool contenido = Sesion::abrir(archivo, previas, leido, leidos, abiertos) && previas.size() == 3;
+    string bytes = leerBytes(archivo);
+    ofstream(archivo.c_str(), ios::binary | ios::trunc).write(bytes.data(), bytes.size() - 1);
+    comprobar("sesion_apertura_sin_verificar",
+              contenido && !Sesion::abrir(archivo, previas, leido, leidos, abiertos));
+    
+    // Las sesiones de la versión 1 no guardaban el alfabeto
+    Sesion::guardar(archivo, secuencias, catalogo, grafos, guardados);
+    uint32_t version = 1;
+    {
+        fstream f(archivo.c_str(), ios::in | ios::out | ios::binary);
+        f.seekp(4);
+        f.write((const char*)&version, sizeof(version));
+    }
+    comprobar("sesion_version_anterior", !Sesion::abrir(archivo, previas, leido, leidos, abiertos));
+    
+    // La misma descripción en dos archivos: cada grafo va con su secuencia
+    // y vuelve bajo el nombre que el catálogo da a cada una al abrir
+    vector<Secuencia> repetidas;
+    repetidas.push_back(Secuencia("s", secuencias[0].obtenerDatos(), 90));
+    catalogo.reemplazar(repetidas, "a.fa");
+    repetidas.push_back(Secuencia("s", secuencias[1].obtenerDatos(), 90));
+    catalogo.anadir(repetidas, 1, "b.fa");
+    grafos.limpiar();
+    for (size_t k = 0; k < repetidas.size(); k++) {
+        grafos.reservar(catalogo.nombre(repetidas, k)).construir(repetidas[k]);
+        grafos.registrar(catalogo.nombre(repetidas, k));
+    }
+    bool separados = Sesion::guardar(archivo, repetidas, catalogo, grafos, guardados) && guardados == 2 &&
+                     Sesion::abrir(archivo, leidas, leido, leidos, abiertos, true) && abiertos == 2;
+    for (size_t k = 0; separados && k < leidas.size(); k++) {
+        Grafo nuevo;
+        nuevo.construir(repetidas[k]);
+        const Grafo* abierto = leidos.obtener(leido.nombre(leidas, k));
+        separados = abierto && mismoGrafo(*abierto, nuevo) &&
+                    leidas[k].obtenerDatos() == repetidas[k].obtenerDatos();
+    }
+    comprobar("sesion_nombres_repetidos", separados && leido.nombre(leidas, 1) == archivo + ":s");
+    remove(archivo.c_str());
+}
+
+// gzip normal con zlib; cada parte queda en un miembro propio
+static bool escribirGzip(const string& archivo, const vector<string>& partes) {
+    bool correcto = true;
+    for (size_t k = 0; k < partes.size(); k++) {
+        gzFile gz = gzopen(archivo.c_str(), k == 0 ? "wb" : "ab");
+        if (!gz) return false;
+        correcto = correcto && gzwrite(gz, partes[k].data(), partes[k].size()) == (int)partes[k].size();
+        correcto = gzclose(gz) == Z_OK && correcto;
+    }
+    return correcto;
+}
+
+// BGZF ida y vuelta (vacío, un byte, bloques justos, datos incompresibles
+// que se guardan sin comprimir), gzip de varios miembros, un archivo con
+// miembros BGZF y normales (se lee entero en un hilo), un bloque con el CRC
+// dañado y un gzip cortado, que deben rechazarse
+static void verificarCompresion(const vector<Secuencia>& genoma, const string& archivo) {
+    mt19937 gen(53);
+    string texto = genoma[0].obtenerDatos().substr(0, 3 * Compresion::BLOQUE_BGZF);
+    string azar(200000, '\0');
+    for (char& c : azar) c = gen();
+    vector<string> contenidos = {"", "A", texto, texto + azar + texto.substr(0, 1000)};
+    
+    bool iguales = true;
+    for (const string& contenido : contenidos) {
+        for (int hilos : {1, 4}) {
+            string leido = "x";
+            iguales = iguales && Compresion::comprimirBGZF(archivo, contenido, hilos) &&
+                      Compresion::esGzip(archivo) && Compresion::descomprimir(archivo, leido, hilos) &&
+                      leido == contenido;
+        }
+    }
+    comprobar("bgzf_ida_vuelta", iguales);
+    
+    string leido;
+    vector<string> partes = {texto.substr(0, 70000), azar, texto.substr(5)};
+    comprobar("gzip_varios_miembros", escribirGzip(archivo, partes) &&
+                                      Compresion::descomprimir(archivo, leido, 4) &&
+                                      leido == partes[0] + partes[1] + partes[2]);
+    
+    string bgzf = archivo + ".bgz";
+    Compresion::comprimirBGZF(bgzf, texto, 2);
+    escribirGzip(archivo, vector<string>(1, azar));
+    string mezcla = leerBytes(bgzf) + leerBytes(archivo);
+    ofstream(archivo.c_str(), ios::binary).write(mezcla.data(), mezcla.size());
+    comprobar("gzip_mezcla_bgzf", Compresion::descomprimir(archivo, leido, 4) && leido == texto + azar);
+    
+    // CRC del segundo bloque (los 4 bytes antes de su ISIZE)
+    string bytes = leerBytes(bgzf);
+    size_t primero = ((unsigned char)bytes[16] | ((unsigned char)bytes[17] << 8)) + 1;
+    size_t segundo = ((unsigned char)bytes[primero + 16] | ((unsigned char)bytes[primero + 17] << 8)) + 1;
+    bytes[primero + segundo - 8] ^= 0x01;
+    ofstream(bgzf.c_str(), ios::binary).write(bytes.data(), bytes.size());
+    comprobar("bgzf_crc_danado", !Compresion::descomprimir(bgzf, leido, 4));
+    
+    bytes = leerBytes(archivo);
+    bytes.resize(bytes.size() - 100);
+    ofstream(archivo.c_str(), ios::binary).write(bytes.data(), bytes.size());
+    comprobar("gzip_cortado", !Compresion::descomprimir(archivo, leido, 4));
+    remove(archivo.c_str());
+    remove(bgzf.c_str());
+}
+
+// guardarFASTA, plano y BGZF, contra el escritor línea a línea original,
+// con ancho 0 (se escribe con el ancho por defecto), registros vacíos, uno
+// editado y registros de varios tramos de 4 MB
+static void verificarGuardarFASTA(const vector<Secuencia>& genoma, const string& archivo) {
+    vector<Secuencia> registros(genoma);
+    string grande;
+    for (size_t k = 0; grande.size() < 5000000; k++) grande += genoma[k % genoma.size()].obtenerDatos();
+    registros.push_back(Secuencia("ancho_1", grande.substr(0, 2100000), 1));
+    registros.push_back(Secuencia("ancho_61", grande, 61));
+    registros.push_back(Secuencia("ancho_64", grande.substr(0, 4194304 + 17), 64));
+    registros.push_back(Secuencia("vacia", "", 60));
+    registros.push_back(Secuencia("ancho_80", grande.substr(5, 123457), 80));
+    registros.push_back(Secuencia("sin_ancho", grande.substr(0, 100001), 0));
+    registros.push_back(Secuencia("ancho_1000", grande.substr(9, 4200000), 1000));
+    string editado = registros.back().obtenerDatos();
+    editado.replace(4189000, 2000, 2000, 'N');
+    registros.back().fijarDatos(editado);
+    
+    ostringstream referencia;
+    for (const auto& sec : registros) {
+        referencia << ">" << sec.obtenerDescripcion() << "\n";
+        string datos = sec.obtenerDatos();
+        int ancho = sec.obtenerAnchoLinea() > 0 ? sec.obtenerAnchoLinea() : Utilidades::ANCHO_LINEA_POR_DEFECTO;
+        for (int i = 0; i < (int)datos.length(); i += ancho) {
+            int len = min(ancho, (int)datos.length() - i);
+            referencia << datos.substr(i, len) << "\n";
+        }
+    }
+    
+    string comprimido = archivo + ".gz", plano, descomprimido;
+    bool correcto = Utilidades::guardarFASTA(archivo, registros);
+    ifstream in(archivo.c_str(), ios::binary);
+    plano.assign(istreambuf_iterator<char>(in), istreambuf_iterator<char>());
+    comprobar("fasta_plano", correcto && plano == referencia.str());
+    correcto = Utilidades::guardarFASTA(comprimido, registros) &&
+               Compresion::descomprimir(comprimido, descomprimido, PoolHilos::hilosPorDefecto());
+    comprobar("fasta_bgzf", correcto && descomprimido == referencia.str());
+    remove(archivo.c_str());
+    remove(comprimido.c_str());
+}
+
+// Cuenta de k-mers canónicos con un mapa de strings: ventanas con algo
+// fuera de ACGT (mayúsculas o minúsculas) no cuentan
+static map<string, uint64_t> kmersIngenuos(const vector<Secuencia>& secuencias, int k) {
+    map<string, uint64_t> cuentas;
+    for (const auto& sec : secuencias) {
+        string datos = sec.obtenerDatos();
+        for (size_t i = 0; i + k <= datos.size(); i++) {
+            string directo = datos.substr(i, k), reverso(k, ' ');
+            bool valida = true;
+            for (int j = 0; j < k && valida; j++) {
+                directo[j] = toupper(directo[j]);
+                size_t c = string("ACGT").find(directo[j]);
+                valida = c != string::npos;
+                if (valida) reverso[k - 1 - j] = "TGCA"[c];
+            }
+            if (valida) cuentas[min(directo, reverso)]++;
+        }
+    }
+    return cuentas;
+}
+
+// ContadorKmers contra el conteo ingenuo, con uno y varios hilos, con la
+// memoria por defecto y con tan poca que hacen falta varias pasadas, sobre
+// un tramo del genoma y registros con N, IUPAC y minúsculas en las ventanas
+static void verificarKmers(const vector<Secuencia>& genoma) {
+    vector<Secuencia> secuencias(1, Secuencia("tramo", genoma[0].obtenerDatos().substr(0, 150000), 60));
+    secuencias.push_back(Secuencia("con_n", "ACGTNACGTACGTAANNacgtacgtRACGTTTTTTTTTTTTTTTTTTTTTTTTTTTTTTTTTTTTXGGA", 60));
+    string datos = genoma[1].obtenerDatos().substr(0, 50000);
+    for (size_t i = 0; i < datos.size(); i += 37) datos[i] = "NnRx"[i % 4];
+    for (size_t i = 5; i < datos.size(); i += 11) datos[i] = tolower(datos[i]);
+    secuencias.push_back(Secuencia("salpicada", datos, 60));
+    
+    for (int k : {1, 4, 11, 21, 32}) {
+        map<string, uint64_t> esperado = kmersIngenuos(secuencias, k);
+        uint64_t total = 0, unicos = 0;
+        map<uint64_t, uint64_t> histograma;
+        vector<pair<uint64_t, string>> orden;
+        for (const auto& par : esperado) {
+            total += par.second;
+            if (par.second == 1) unicos++;
+            histograma[par.second]++;
+            orden.push_back(make_pair(par.second, par.first));
+        }
+        sort(orden.begin(), orden.end(), [](const pair<uint64_t, string>& a, const pair<uint64_t, string>& b) {
+            return a.first != b.first ? a.first > b.first : a.second < b.second;
+        });
+        if (orden.size() > 20) orden.resize(20);
+        
+        for (size_t memoria : {ContadorKmers::MEMORIA_POR_DEFECTO, (size_t)256 << 10}) {
+            for (int hilos : {1, 4}) {
+                ResultadoKmers r;
+                bool iguales = ContadorKmers::contar(secuencias, k, hilos, memoria, 20, r) &&
+                               r.total == total && r.distintos == esperado.size() && r.unicos == unicos &&
+                               r.histograma == histograma && r.masFrecuentes.size() == orden.size();
+                for (size_t i = 0; iguales && i < orden.size(); i++) {
+                    iguales = r.masFrecuentes[i].second == orden[i].first &&
+                              ContadorKmers::decodificar(r.masFrecuentes[i].first, k) == orden[i].second;
+                }
+                // Con poca memoria, los k grandes no caben en una pasada
+                if (memoria != ContadorKmers::MEMORIA_POR_DEFECTO && k >= 11) iguales = iguales && r.pasadas > 1;
+                comprobar("kmers_k" + to_string(k) + "_" + to_string(memoria >> 10) + "k_" + to_string(hilos) + "h",
+                          iguales);
+            }
+        }
+    }
+}
+
+// Búsqueda aproximada contra la referencia ingenua sobre un tramo del
+// genoma, con patrones de una palabra y de varios bloques
+static void verificarBusquedaAproximada(const vector<Secuencia>& genoma) {
+    string datos = genoma[0].obtenerDatos().substr(0, 200000);
+    vector<Secuencia> muestra(1, Secuencia("muestra", datos, genoma[0].obtenerAnchoLinea()));
+    mt19937 gen(7);
+
+    for (int largo : {12, 64, 150}) {
+        // Patrón tomado del texto y mutado, para que haya coincidencias
+        string patron = datos.substr(gen() % (datos.length() - largo), largo);
+        patron[gen() % largo] = "ACGT"[gen() % 4];
+        for (int k : {0, 1, 3}) {
+            for (TipoDistancia tipo : {DISTANCIA_HAMMING, DISTANCIA_EDICION}) {
+                vector<Coincidencia> rapidas, ingenuas;
+                BusquedaAproximada::contar(muestra, patron, k, tipo, PoolHilos::hilosPorDefecto(), &rapidas);
+                BusquedaAproximada::contarIngenuo(muestra, patron, k, tipo, &ingenuas);
+
+                bool iguales = rapidas.size() == ingenuas.size();
+                for (size_t i = 0; iguales && i < rapidas.size(); i++) {
+                    iguales = rapidas[i].posicion == ingenuas[i].posicion &&
+                              rapidas[i].distancia == ingenuas[i].distancia;
+                }
+                ostringstream nombre;
+                nombre << "aproximada_" << (tipo == DISTANCIA_HAMMING ? "hamming" : "edicion")
+                       << "_m" << largo << "_k" << k;
+                comprobar(nombre.str(), iguales);
+            }
+        }
+    }
+}
+
+static bool mismasCoincidencias(const vector<Coincidencia>& a, const vector<Coincidencia>& b) {
+    if (a.size() != b.size()) return false;
+    for (size_t i = 0; i < a.size(); i++) {
+        if (a[i].posicion != b[i].posicion || a[i].distancia != b[i].distancia ||
+            a[i].reversa != b[i].reversa) return false;
+    }
+    return true;
+}
+
+// Búsqueda IUPAC en ambas hebras contra la referencia ingenua, con
+// ambigüedades en el texto y en el patrón, y enmascarado contra la
+// versión secuencial que enmascara sobre el texto ya modificado
+static void verificarBusquedaIUPAC(const vector<Secuencia>& genoma) {
+    mt19937 gen(11);
+    string datos = genoma[0].obtenerDatos().substr(0, 200000);
+    for (size_t i = 0; i < datos.length(); i += 1 + gen() % 500) datos[i] = "NRYX"[gen() % 4];
+    vector<Secuencia> muestra(1, Secuencia("muestra", datos, genoma[0].obtenerAnchoLinea()));
+
+    for (int largo : {4, 5, 17, 40}) {
+        string patron = datos.substr(gen() % (datos.length() - largo), largo);
+        patron[gen() % largo] = "NRYSWKMBDHV"[gen() % 11];
+        if (largo == 5) patron = "GANTC";   // su propio complemento reverso
+
+        vector<Coincidencia> rapidas, ingenuas;
+        BusquedaIUPAC::contar(muestra, patron, 0, DISTANCIA_EDICION, PoolHilos::hilosPorDefecto(), &rapidas);
+        BusquedaIUPAC::contarIngenuo(muestra, patron, &ingenuas);
+        comprobar("iupac_" + patron, mismasCoincidencias(rapidas, ingenuas));
+
+        // k > 0 con conjuntos IUPAC en las dos búsquedas aproximadas
+        for (TipoDistancia tipo : {DISTANCIA_HAMMING, DISTANCIA_EDICION}) {
+            BusquedaAproximada::contar(muestra, patron, 1, tipo, PoolHilos::hilosPorDefecto(), &rapidas, true);
+            BusquedaAproximada::contarIngenuo(muestra, patron, 1, tipo, &ingenuas, true);
+            comprobar(string("iupac_") + (tipo == DISTANCIA_HAMMING ? "hamming_" : "edicion_") + patron,
+                      mismasCoincidencias(rapidas, ingenuas));
+        }
+
+        string complemento = IUPAC::complementoReverso(patron);
+        string esperado = datos;
+        ConteoHebras conteoEsperado;
+        for (size_t i = 0; i + largo <= esperado.length(); i++) {
+            bool directa = true, reversa = true;
+            for (int p = 0; p < largo; p++) {
+                directa = directa && IUPAC::compatibles(esperado[i + p], patron[p]);
+                reversa = reversa && IUPAC::compatibles(esperado[i + p], complemento[p]);
+            }
+            if (!directa && !reversa) continue;
+            if (directa) conteoEsperado.directa++;
+            else conteoEsperado.reversa++;
+            for (int p = 0; p < largo; p++) esperado[i + p] = 'X';
+        }
+        vector<Secuencia> enmascarada = muestra;
+        ConteoHebras conteo = BusquedaIUPAC::enmascarar(enmascarada, patron, PoolHilos::hilosPorDefecto());
+        comprobar("iupac_enmascarar_" + patron,
+                  enmascarada[0].obtenerDatos() == esperado && conteo.directa == conteoEsperado.directa &&
+                  conteo.reversa == conteoEsperado.reversa);
+    }
+}
+
+// Jaccard exacta de los k-mers canónicos sin N ni códigos IUPAC
+static double jaccardExacta(const string& a, const string& b, int k) {
+    auto kmers = [k](const string& s) {
+        set<string> conjunto;
+        for (size_t i = 0; i + k <= s.length(); i++) {
+            string kmer = s.substr(i, k);
+            if (kmer.find_first_not_of("ACGT") != string::npos) continue;
+            conjunto.insert(min(kmer, IUPAC::complementoReverso(kmer)));
+        }
+        return conjunto;
+    };
+    set<string> x = kmers(a), y = kmers(b);
+    size_t comunes = 0;
+    for (const auto& kmer : x) comunes += y.count(kmer);
+    return (double)comunes / (x.size() + y.size() - comunes);
+}
+
+// Jaccard estimada contra la exacta en copias con mutaciones, y la caché
+// de bocetos cuando cambia una secuencia
+static void verificarSimilitud(const vector<Secuencia>& genoma) {
+    const int k = 21, tamano = 2000;
+    mt19937 gen(13);
+    string datos = genoma[0].obtenerDatos().substr(0, 100000);
+    vector<Secuencia> muestra(1, Secuencia("original", datos, genoma[0].obtenerAnchoLinea()));
+    for (int tasa : {0, 2, 10, 40}) {
+        string mutada = datos;
+        for (size_t i = 0; i < mutada.length(); i++) {
+            if ((int)(gen() % 1000) < tasa) mutada[i] = "ACGT"[gen() % 4];
+        }
+        muestra.push_back(Secuencia("mutada_" + to_string(tasa), mutada, genoma[0].obtenerAnchoLinea()));
+    }
+
+    Similitud similitud;
+    int calculados = 0;
+    vector<shared_ptr<const Boceto>> bocetos = similitud.bocetar(muestra, k, tamano, PoolHilos::hilosPorDefecto(),
+                                                                 calculados);
+    for (size_t m = 1; m < muestra.size(); m++) {
+        int compartidos, comparados;
+        Similitud::comparar(*bocetos[0], *bocetos[m], compartidos, comparados);
+        double exacta = jaccardExacta(datos, muestra[m].obtenerDatos(), k);
+        comprobar("similitud_" + muestra[m].obtenerDescripcion(),
+                  fabs((double)compartidos / comparados - exacta) < 0.05);
+    }
+
+    similitud.bocetar(muestra, k, tamano, PoolHilos::hilosPorDefecto(), calculados);
+    bool todosEnCache = calculados == 0;
+    muestra[2].fijarDatos(muestra[3].obtenerDatos());
+    bocetos = similitud.bocetar(muestra, k, tamano, PoolHilos::hilosPorDefecto(), calculados);
+    comprobar("similitud_cache", todosEnCache && calculados == 1 && bocetos[2]->hashes == bocetos[3]->hashes);
+}
+
+// Regiones al azar contadas con el índice contra el recorrido directo
+static void verificarComposicion(const vector<Secuencia>& genoma) {
+    mt19937 gen(19);
+    for (const auto& sec : genoma) {
+        IndiceComposicion indice(sec);
+        const char* bases = sec.obtenerBases();
+        size_t n = sec.obtenerNumBases();
+        bool iguales = true;
+        for (int q = 0; q < 200 && iguales; q++) {
+            size_t inicio = gen() % (n + 1), fin = gen() % (n + 1);
+            if (inicio > fin) swap(inicio, fin);
+            uint64_t cuentas[256], esperadas[256] = {};
+            indice.contar(inicio, fin, cuentas);
+            for (size_t i = inicio; i < fin; i++) esperadas[(unsigned char)bases[i]]++;
+            iguales = equal(cuentas, cuentas + 256, esperadas);
+        }
+        comprobar("composicion_" + sec.obtenerDescripcion(), iguales);
+    }
+}
+
+// Puntajes del método rayado y con banda contra la programación dinámica
+// escalar, y el CIGAR de la traza vuelto a puntuar
+static void verificarAlineamiento(const vector<Secuencia>& genoma) {
+    mt19937 gen(23);
+    string datos = genoma[0].obtenerDatos();
+    for (int caso = 0; caso < 8; caso++) {
+        size_t largo = caso < 4 ? 200 + gen() % 300 : 3000 + gen() % 2000;
+        string a = datos.substr(gen() % (datos.length() - largo), largo);
+        string b = a;
+        for (auto& c : b) {
+            if (gen() % 30 == 0) c = "ACGT"[gen() % 4];
+        }
+        b.erase(gen() % b.length(), gen() % 12);
+        if (caso % 2) b = b.substr(largo / 4) + datos.substr(gen() % (datos.length() - 100), 100);
+
+        bool iguales = true;
+        for (int modo = 0; modo < 2; modo++) {
+            ParametrosAlineamiento p;
+            p.modo = modo == 0 ? ALINEAMIENTO_LOCAL : ALINEAMIENTO_GLOBAL;
+            p.banda = caso < 4 ? -1 : 200;
+            ResultadoAlineamiento res;
+            string error;
+            int64_t esperado = Alineamiento::puntajeEscalar(a.data(), a.length(), b.data(), b.length(), p);
+            bool ok = Alineamiento::alinear(a.data(), a.length(), b.data(), b.length(), p, res, error);
+            iguales = iguales && ok && res.puntaje == esperado &&
+                      Alineamiento::puntuarCigar(a.data() + res.inicio1, b.data() + res.inicio2, res.cigar, p) ==
+                          esperado;
+        }
+        comprobar("alineamiento_" + to_string(caso), iguales);
+    }
+    
+    // El comando rechaza una banda negativa explícita, -1 incluido
+    const string archivo = "pruebas_alinear.fa";
+    vector<Secuencia> pares;
+    pares.push_back(Secuencia("a", datos.substr(0, 300), 60));
+    pares.push_back(Secuencia("b", datos.substr(7, 300), 60));
+    Utilidades::guardarFASTA(archivo, pares);
+    const string error = "la banda debe ser";
+    string cargar = "cargar " + archivo + "\n";
+    comprobar("alinear_banda_negativa",
+              ejecutarGenomas("-q", cargar + "alinear a b --banda -1\n").find(error) != string::npos &&
+              ejecutarGenomas("-q", cargar + "alinear a b --banda -5\n").find(error) != string::npos &&
+              ejecutarGenomas("-q", cargar + "alinear a b --banda 0\n").find(error) == string::npos &&
+              ejecutarGenomas("-q", cargar + "alinear a b\n").find("Alineamiento local") != string::npos);
+    remove(archivo.c_str());
+}
+
+// Catalogo contra una búsqueda lineal en una lista de (descripción,
+// archivo) tras cargas, cargas añadidas y descargas al azar, con
+// descripciones repetidas entre archivos y dentro de un mismo archivo
+static void verificarCatalogo() {
+    mt19937 gen(67);
+    const char* archivos[] = {"a.fa", "b.fa", "c.fa", "d.fa"};
+    auto leer = [&]() {
+        vector<Secuencia> leidas;
+        for (int k = gen() % 6; k >= 0; k--) leidas.push_back(Secuencia("s" + to_string(gen() % 8), "ACGT", 4));
+        return leidas;
+    };
+    // Primera posición con esa descripción o, si no hay, con ese archivo:descripción
+    auto buscarLineal = [](const vector<Secuencia>& secuencias, const vector<string>& origenes,
+                           const string& nombre) {
+        for (size_t i = 0; i < secuencias.size(); i++) {
+            if (secuencias[i].obtenerDescripcion() == nombre) return (long)i;
+        }
+        for (size_t i = 0; i < secuencias.size(); i++) {
+            if (Catalogo::nombreCalificado(origenes[i], secuencias[i].obtenerDescripcion()) == nombre) return (long)i;
+        }
+        return -1L;
+    };
+    
+    Catalogo catalogo;
+    vector<Secuencia> secuencias;
+    vector<string> origenes;
+    bool iguales = true, descargas = true;
+    for (int paso = 0; paso < 500 && iguales && descargas; paso++) {
+        string archivo = archivos[gen() % 4];
+        int operacion = gen() % 3;
+        if (operacion == 0) {
+            secuencias = leer();
+            origenes.assign(secuencias.size(), archivo);
+            catalogo.reemplazar(secuencias, archivo);
+        } else if (operacion == 1 && !catalogo.contieneArchivo(archivo)) {
+            size_t desde = secuencias.size();
+            for (auto& sec : leer()) secuencias.push_back(sec);
+            origenes.resize(secuencias.size(), archivo);
+            catalogo.anadir(secuencias, desde, archivo);
+        } else if (operacion == 2) {
+            vector<string> esperados;
+            vector<Secuencia> quedan;
+            vector<string> origenesQuedan;
+            for (size_t i = 0; i < secuencias.size(); i++) {
+                if (origenes[i] == archivo) {
+                    esperados.push_back(catalogo.nombre(secuencias, i));
+                } else {
+                    quedan.push_back(secuencias[i]);
+                    origenesQuedan.push_back(origenes[i]);
+                }
+            }
+            descargas = catalogo.descargar(secuencias, archivo) == esperados && secuencias.size() == quedan.size();
+            for (size_t i = 0; descargas && i < quedan.size(); i++) {
+                descargas = secuencias[i].obtenerIdentidad() == quedan[i].obtenerIdentidad();
+            }
+            origenes.swap(origenesQuedan);
+        }
+        
+        vector<string> repetidas;
+        for (size_t i = 0; i < secuencias.size() && iguales; i++) {
+            const string& d = secuencias[i].obtenerDescripcion();
+            if (buscarLineal(secuencias, origenes, d) != (long)i &&
+                find(repetidas.begin(), repetidas.end(), d) == repetidas.end()) {
+                repetidas.push_back(d);
+            }
+            string nombre = catalogo.nombre(secuencias, i);
+            iguales = catalogo.origen(i) == origenes[i] &&
+                      nombre == (buscarLineal(secuencias, origenes, d) == (long)i
+                                 ? d : Catalogo::nombreCalificado(origenes[i], d)) &&
+                      catalogo.buscar(nombre) == buscarLineal(secuencias, origenes, nombre);
+        }
+        for (int k = 0; k < 8 && iguales; k++) {
+            string d = "s" + to_string(k);
+            iguales = catalogo.buscar(d) == buscarLineal(secuencias, origenes, d);
+            for (const char* a : archivos) {
+                string calificado = Catalogo::nombreCalificado(a, d);
+                iguales = iguales && catalogo.buscar(calificado) == buscarLineal(secuencias, origenes, calificado);
+            }
+        }
+        set<string> distintos(origenes.begin(), origenes.end());
+        iguales = iguales && catalogo.obtenerRepetidas() == repetidas && catalogo.numArchivos() == distintos.size();
+    }
+    comprobar("catalogo_busqueda", iguales);
+    comprobar("catalogo_descarga", descargas);
+}
+
+// CRC32C con instrucción contra tablas, ida y vuelta del .fabin y un byte
+// dañado en el último bloque, que verificar y decodificar deben ubicar
+static void verificarFabin(const vector<Secuencia>& genoma, const string& archivo) {
+    bool iguales = true;
+    for (const auto& sec : genoma) {
+        for (size_t desde = 0; desde < 8; desde++) {
+            size_t n = sec.obtenerNumBases() - desde;
+            iguales = iguales && Crc32c::calcular(sec.obtenerBases() + desde, n) ==
+                                     Crc32c::calcularConTablas(sec.obtenerBases() + desde, n);
+        }
+    }
+    comprobar("crc32c_tablas", iguales);
+
+    vector<Secuencia> leidas;
+    VerificacionFabin v;
+    iguales = Utilidades::codificarHuffman(archivo, genoma) &&
+              Utilidades::verificarFabin(archivo, v, PoolHilos::hilosPorDefecto()) &&
+              v.cabeceraValida && v.danadas.empty() &&
+              Utilidades::decodificarHuffman(archivo, leidas) && leidas.size() == genoma.size();
+    for (size_t k = 0; iguales && k < genoma.size(); k++) {
+        iguales = leidas[k].obtenerDatos() == genoma[k].obtenerDatos() &&
+                  leidas[k].obtenerDescripcion() == genoma[k].obtenerDescripcion();
+    }
+    comprobar("fabin_ida_vuelta", iguales);
+
+    {
+        fstream f(archivo.c_str(), ios::in | ios::out | ios::binary);
+        f.seekg(-1, ios::end);
+        char c = f.get() ^ 0x10;
+        f.seekp(-1, ios::end);
+        f.put(c);
+    }
+    uint32_t ultima = genoma.size() - 1;
+    VerificacionFabin estricta, rescate;
+    comprobar("fabin_bloque_danado",
+              Utilidades::verificarFabin(archivo, v, PoolHilos::hilosPorDefecto()) &&
+              v.danadas == vector<uint32_t>(1, ultima) &&
+              !Utilidades::decodificarHuffman(archivo, leidas, &estricta) && estricta.danadas == v.danadas &&
+              Utilidades::decodificarHuffman(archivo, leidas, &rescate, true) &&
+              rescate.danadas == v.danadas && leidas.size() == genoma.size() - 1);
+    remove(archivo.c_str());
+}
+
+// Ida y vuelta con un modelo entrenado, que en conjunto ocupa menos que con
+// tablas propias, y un archivo con símbolos fuera del modelo, que debe
+// rechazarse
+static void verificarModeloHuffman(const vector<vector<Secuencia>>& lotes, const string& archivo) {
+    vector<Secuencia> corpus;
+    for (const auto& lote : lotes) corpus.insert(corpus.end(), lote.begin(), lote.end());
+    RegistroModelos registro;
+    shared_ptr<const ModeloHuffman> modelo = ModeloHuffman::entrenar(corpus);
+    registro.registrar(modelo);
+
+    bool iguales = true;
+    long tamanoPropio = 0, tamanoModelo = 0;
+    for (size_t k = 0; k < lotes.size() && k < 50 && iguales; k++) {
+        vector<Secuencia> leidas;
+        Utilidades::codificarHuffman(archivo, lotes[k]);
+        tamanoPropio += ifstream(archivo.c_str(), ios::binary | ios::ate).tellg();
+        iguales = Utilidades::codificarHuffman(archivo, lotes[k], modelo.get());
+        tamanoModelo += ifstream(archivo.c_str(), ios::binary | ios::ate).tellg();
+        iguales = iguales && !Utilidades::decodificarHuffman(archivo, leidas) &&
+                  Utilidades::decodificarHuffman(archivo, leidas, nullptr, false, &registro) &&
+                  leidas.size() == 1 && leidas[0].obtenerDatos() == lotes[k][0].obtenerDatos();
+    }
+    comprobar("modelo_ida_vuelta", iguales && tamanoModelo < tamanoPropio);
+
+    vector<Secuencia> ajena(1, Secuencia("ajena", "ACGT#ACGT", 60));
+    comprobar("modelo_sin_cobertura", !modelo->cubre(ajena) && !Utilidades::codificarHuffman(archivo, ajena, modelo.get()));
+    remove(archivo.c_str());
+}
+
+// Costos por teselas contra Grafo::dijkstra, desde el archivo plano y
+// desde una copia gzip (que se lee empaquetada aunque tenga un .fai propio,
+// como el que deja samtools para bgzip), con una caché de pocas teselas
+// para forzar desalojos; y errores si el archivo desaparece o se acorta
+static void verificarGrafoTeselado(const Secuencia& sec, const string& archivo) {
+    Grafo grafo;
+    grafo.construir(sec);
+    string comprimido = archivo + ".gz";
+    vector<Secuencia> registro(1, sec);
+    Utilidades::guardarFASTA(archivo, registro);
+    Utilidades::guardarFASTA(comprimido, registro);
+    ofstream(comprimido + ".fai") << sec.obtenerDescripcion() << "\t" << sec.obtenerNumBases() << "\t13\t"
+                                  << sec.obtenerColumnas() << "\t" << sec.obtenerColumnas() + 1 << "\n";
+    int columnas = sec.obtenerColumnas();
+    
+    mt19937 gen(31);
+    for (int variante = 0; variante < 2; variante++) {
+        OrigenTeselas origen;
+        string error;
+        bool iguales = GrafoTeselado::ubicar(variante == 0 ? archivo : comprimido, sec.obtenerDescripcion(),
+                                             origen, error);
+        if (iguales) {
+            GrafoTeselado teselado(origen, 4, 8 * 4 * columnas);
+            long desalojos = 0;
+            for (int consulta = 0; consulta < 6 && iguales; consulta++) {
+                int a = gen() % sec.obtenerNumBases(), b = gen() % sec.obtenerNumBases();
+                if (consulta == 0) b = min<int>(sec.obtenerNumBases() - 1, a + 40 * columnas);
+                double esperado, costo;
+                grafo.dijkstra(a, b, esperado);
+                vector<Nodo> camino;
+                EstadisticasTeselas est;
+                iguales = teselado.rutaMasCorta(a / columnas, a % columnas, b / columnas, b % columnas,
+                                                camino, costo, est, error) &&
+                          !camino.empty() && fabs(costo - esperado) < 1e-9;
+                desalojos += est.desalojos;
+            }
+            iguales = iguales && desalojos > 0;
+        }
+        comprobar(variante == 0 ? "teselas_fasta" : "teselas_gzip", iguales);
+    }
+    
+    // Con el índice ya creado, el archivo se acorta o desaparece
+    OrigenTeselas origen;
+    string error;
+    vector<Nodo> camino;
+    double costo;
+    EstadisticasTeselas est;
+    GrafoTeselado::ubicar(archivo, sec.obtenerDescripcion(), origen, error);
+    if (truncate(archivo.c_str(), sec.obtenerNumBases() / 2) == 0) {
+        GrafoTeselado acortado(origen, 4, 8 * 4 * columnas);
+        comprobar("teselas_archivo_corto",
+                  !acortado.rutaMasCorta(0, 0, origen.numBases / columnas - 1, 0, camino, costo, est, error) &&
+                  camino.empty());
+    }
+    remove(archivo.c_str());
+    GrafoTeselado ausente(origen, 4, 8 * 4 * columnas);
+    comprobar("teselas_archivo_ausente", !ausente.rutaMasCorta(0, 0, 1, 1, camino, costo, est, error));
+    
+    remove((archivo + ".fai").c_str());
+    remove(comprimido.c_str());
+    remove((comprimido + ".fai").c_str());
+    remove((comprimido + ".empaquetado").c_str());
+    remove((comprimido + ".empaquetado.fai").c_str());
+}
+
+// rutas_lote contra ruta_mas_corta consulta por consulta; el lote busca
+// cada grafo una sola vez en la caché, así que solo cuenta un fallo
+static void verificarRutasLote(const string& archivo) {
+    const string archivoConsultas = archivo + ".rutas";
+    Utilidades::guardarFASTA(archivo, vector<Secuencia>(1, GeneradorGenomas::rejilla(40, 3)));
+    mt19937 gen(53);
+    ostringstream consultas, sueltas;
+    for (int q = 0; q < 30; q++) {
+        int i = gen() % 40, j = gen() % 40, x = gen() % 40, y = gen() % 40;
+        consultas << "sintetica " << i << " " << j << " " << x << " " << y << "\n";
+        sueltas << "ruta_mas_corta sintetica " << i << " " << j << " " << x << " " << y << "\n";
+    }
+    {
+        ofstream out(archivoConsultas.c_str());
+        out << consultas.str();
+    }
+    string cargar = "cargar " + archivo + "\n";
+    string lote = ejecutarGenomas("-q", cargar + "rutas_lote " + archivoConsultas + "\nestado_grafos\n");
+    string una = ejecutarGenomas("-q", cargar + sueltas.str());
+    comprobar("rutas_lote_resultados", !una.empty() && lote.compare(0, una.size(), una) == 0);
+    comprobar("rutas_lote_cache", lote.find("Aciertos: 0\nFallos: 1\n") != string::npos);
+    remove(archivo.c_str());
+    remove(archivoConsultas.c_str());
+}
+
+// Conexión con un servidor 'genomas -s'; -1 si aún no escucha
+static int conectarServidor(const string& ruta) {
+    sockaddr_un direccion;
+    memset(&direccion, 0, sizeof(direccion));
+    direccion.sun_family = AF_UNIX;
+    strncpy(direccion.sun_path, ruta.c_str(), sizeof(direccion.sun_path) - 1);
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd >= 0 && connect(fd, (sockaddr*)&direccion, sizeof(direccion)) < 0) {
+        close(fd);
+        fd = -1;
+    }
+    return fd;
+}
+
+// Envía un comando y devuelve la respuesta sin la línea de fin
+static string consultarServidor(int fd, const string& comando) {
+    string linea = comando + "\n";
+    if (send(fd, linea.data(), linea.length(), MSG_NOSIGNAL) != (ssize_t)linea.length()) return "";
+    const string fin = string(1, Servidor::FIN_RESPUESTA) + "\n";
+    string respuesta;
+    char bloque[4096];
+    while (respuesta.length() < fin.length() ||
+           respuesta.compare(respuesta.length() - fin.length(), fin.length(), fin) != 0) {
+        ssize_t n = recv(fd, bloque, sizeof(bloque), 0);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return "";
+        respuesta.append(bloque, n);
+    }
+    return respuesta.substr(0, respuesta.length() - fin.length());
+}
+
+// Modo servidor: lectores concurrentes en varias conexiones mientras otra
+// enmascara el patrón que buscan. Cada lector ve el conteo completo hasta
+// que ve cero, nunca al revés; una conexión queda abierta y ociosa al
+// detener el servidor, que debe despertarla, esperar a su hilo y salir.
+static void verificarServidor(const string& archivo) {
+    const string ruta = "pruebas_servidor.sock";
+    Secuencia sec = GeneradorGenomas::rejilla(60, 11);
+    Utilidades::guardarFASTA(archivo, vector<Secuencia>(1, sec));
+    const string buscado = sec.obtenerDatos().substr(200, 4);
+    
+    remove(ruta.c_str());
+    pid_t servidor = fork();
+    if (servidor == 0) {
+        freopen("/dev/null", "w", stderr);
+        execl("./genomas", "genomas", "-s", ruta.c_str(), (char*)nullptr);
+        _exit(127);
+    }
+    int escritor = -1;
+    for (int intento = 0; intento < 500 && escritor < 0; intento++) {
+        escritor = conectarServidor(ruta);
+        if (escritor < 0) usleep(10000);
+    }
+    string carga = consultarServidor(escritor, "cargar " + archivo);
+    string antes = consultarServidor(escritor, "es_subsecuencia " + buscado);
+    
+    // Cada lector sigue consultando hasta ver la máscara y unas cuantas veces
+    // más; el escritor enmascara cuando todos llevan ya varias respuestas
+    const int lectores = 4, previas = 20, limite = 100000;
+    atomic<int> respondidas(0);
+    vector<string> fallos(lectores);
+    vector<thread> hilos;
+    for (int l = 0; l < lectores; l++) {
+        hilos.push_back(thread([&, l] {
+            int fd = conectarServidor(ruta);
+            int despues = 0, q = 0;
+            for (; q < limite && despues < previas && fallos[l].empty(); q++) {
+                string r = consultarServidor(fd, "es_subsecuencia " + buscado);
+                if (r.find("no existe dentro") != string::npos) despues++;
+                else if (despues > 0 || r != antes) fallos[l] = r.empty() ? "sin respuesta" : r;
+                if (q < previas) respondidas++;
+            }
+            // Un lector que falla antes no debe dejar esperando al escritor
+            if (q < previas) respondidas += previas - q;
+            bool enmascarado = despues > 0;
+            if (!enmascarado && fallos[l].empty()) fallos[l] = "nunca vio la máscara";
+            close(fd);
+        }));
+    }
+    while (respondidas < lectores * previas) this_thread::yield();
+    string mascara = consultarServidor(escritor, "enmascarar " + buscado);
+    for (thread& h : hilos) h.join();
+    
+    bool correcto = true;
+    for (const string& f : fallos) {
+        if (!f.empty()) cerr << "  lector: " << f << endl;
+        correcto = correcto && f.empty();
+    }
+    comprobar("servidor_lectores", carga.find("cargada") != string::npos &&
+                                   antes.find("se repite") != string::npos &&
+                                   mascara.find("han sido enmascaradas") != string::npos && correcto);
+    
+    // 'escritor' queda abierta y bloquea a su hilo en recv
+    kill(servidor, SIGTERM);
+    int estado = -1;
+    bool terminado = false;
+    for (int intento = 0; intento < 500 && !terminado; intento++) {
+        terminado = waitpid(servidor, &estado, WNOHANG) == servidor;
+        if (!terminado) usleep(10000);
+    }
+    if (!terminado) {
+        kill(servidor, SIGKILL);
+        waitpid(servidor, &estado, 0);
+    }
+    close(escritor);
+    comprobar("servidor_detencion", terminado && WIFEXITED(estado) && WEXITSTATUS(estado) == 0 &&
+                                    access(ruta.c_str(), F_OK) != 0);
+    remove(ruta.c_str());
+    remove(archivo.c_str());
+}
+
+// Modo lote: cada comando que atiende procesarComando (leído de main.cpp)
+// tiene clase, y un script con lecturas en paralelo y escrituras en medio
+// imprime lo mismo que el modo interactivo, en el orden del script. La
+// escritura es una barrera: las lecturas posteriores ven la secuencia
+// enmascarada, aunque haya más hilos que comandos en el tramo.
+static void verificarModoLote(const string& archivo) {
+    ifstream fuente("main.cpp");
+    string codigo((istreambuf_iterator<char>(fuente)), istreambuf_iterator<char>());
+    size_t inicio = codigo.find("void procesarComando(const string& linea) {");
+    string cuerpo = codigo.substr(inicio, codigo.find("\n}\n", inicio) - inicio);
+    regex patron("comando == \"([a-z_]+)\"");
+    int comandos = 0;
+    bool todos = inicio != string::npos;
+    for (sregex_iterator it(cuerpo.begin(), cuerpo.end(), patron), fin; it != fin; ++it) {
+        comandos++;
+        if (!Comandos::clasificado((*it)[1])) {
+            cerr << "  comando sin clase: " << (*it)[1] << endl;
+            todos = false;
+        }
+    }
+    comprobar("lote_clases", todos && comandos >= 30);
+
+    vector<Secuencia> secuencias;
+    for (unsigned semilla = 1; semilla <= 3; semilla++) {
+        Secuencia sec = GeneradorGenomas::rejilla(60, semilla);
+        secuencias.push_back(Secuencia("rejilla" + to_string(semilla), sec.obtenerDatos(), 60));
+    }
+    Utilidades::guardarFASTA(archivo, secuencias);
+    const string buscado = secuencias[0].obtenerDatos().substr(100, 4);
+    ostringstream script;
+    script << "cargar " << archivo << "\n";
+    for (int vuelta = 0; vuelta < 2; vuelta++) {
+        for (int k = 0; k < 8; k++) {
+            script << "es_subsecuencia " << secuencias[k % 3].obtenerDatos().substr(37 * k, 3 + k % 3) << "\n"
+                   << "histograma rejilla" << 1 + k % 3 << "\n"
+                   << "ruta_mas_corta rejilla" << 1 + k % 3 << " 0 " << k << " 59 " << 59 - k << "\n";
+        }
+        script << "listar_secuencias\n"
+               << "es_subsecuencia " << buscado << "\n";
+        if (vuelta == 0) script << "enmascarar " << buscado << "\n";
+    }
+    string interactivo = ejecutarGenomas("-q", script.str());
+    string lote = ejecutarGenomas("-f - -j 8", script.str());
+    size_t mascara = lote.find("han sido enmascaradas");
+    comprobar("lote_orden", !interactivo.empty() && lote == interactivo);
+    comprobar("lote_barrera", mascara != string::npos &&
+                              lote.find("no existe dentro", mascara) != string::npos);
+    remove(archivo.c_str());
+}
+
+#ifdef GENOMAS_INSTRUMENTACION
+// Las asignaciones de una fase son las del hilo que la mide, aunque otro
+// hilo asigne mientras tanto; el total global sí las incluye
+static void verificarInstrumentacion() {
+    FaseInstrumentada& fase = Instrumentacion::registrar("pruebas.asignaciones");
+    uint64_t totalesAntes = Instrumentacion::asignaciones();
+    atomic<long> ajenas(0);
+    atomic<bool> fin(false);
+    thread ruido([&] {
+        while (!fin) {
+            int* volatile p = new int(1);
+            delete p;
+            ajenas++;
+        }
+    });
+    vector<int*> propias(10);
+    {
+        TemporizadorFase medicion(fase);
+        for (auto& p : propias) {
+            int* volatile nuevo = new int(0);
+            p = nuevo;
+        }
+        for (long desde = ajenas; ajenas < desde + 1000; ) {}
+    }
+    fin = true;
+    ruido.join();
+    for (int* p : propias) delete p;
+    comprobar("instrumentacion_por_hilo", fase.asignaciones == 10 &&
+                                          Instrumentacion::asignaciones() - totalesAntes > 1000);
+}
+#endif
+
+static void mostrarUso() {
+    cerr << "USO: genomas_pruebas [opciones]" << endl;
+    cerr << "  --bases <n>          bases totales del genoma sintético (1000000)" << endl;
+    cerr << "  --semilla <n>        semilla del generador (2025)" << endl;
+}
+
+int main(int argc, char* argv[]) {
+    ParametrosGenoma params;
+    params.totalBases = 1000000;
+    for (int k = 1; k < argc; k++) {
+        string opcion = argv[k];
+        if (k + 1 >= argc) {
+            mostrarUso();
+            return 2;
+        }
+        string valor = argv[++k];
+        if (opcion == "--bases") params.totalBases = strtoull(valor.c_str(), nullptr, 10);
+        else if (opcion == "--semilla") params.semilla = strtoull(valor.c_str(), nullptr, 10);
+        else {
+            mostrarUso();
+            return 2;
+        }
+    }
+
+    vector<Secuencia> genoma = GeneradorGenomas::generar(params);
+    const string archivoFabin = "pruebas_sintetico.fabin";
+
+    verificarDeltaStepping();
+    verificarBusquedaGrafo();
+    verificarMapaRemoto("pruebas_mapa.grmr");
+    verificarParcheoGrafo();
+    verificarHistorial(genoma[1]);
+    verificarCacheGrafos();
+    verificarSesion("pruebas_sesion.gses");
+    verificarCompresion(genoma, "pruebas_compresion.gz");
+    verificarGuardarFASTA(genoma, "pruebas_guardar.fa");
+    verificarKmers(genoma);
+    verificarBusquedaAproximada(genoma);
+    verificarBusquedaIUPAC(genoma);
+    verificarAlfabetos();
+    verificarSimilitud(genoma);
+    verificarComposicion(genoma);
+    verificarAlineamiento(genoma);
+    verificarCatalogo();
+    verificarFabin(genoma, archivoFabin);
+    verificarModeloHuffman(GeneradorGenomas::amplicones(genoma[0], 2000, 300, 29), archivoFabin);
+    Secuencia secGrafo(genoma[0].obtenerDescripcion(), genoma[0].obtenerDatos().substr(0, 250000),
+                       genoma[0].obtenerAnchoLinea());
+    verificarGrafoTeselado(secGrafo, "pruebas_teselas.fa");
+    verificarRutasLote("pruebas_rutas.fa");
+    verificarModoLote("pruebas_lote.fa");
+    verificarServidor("pruebas_servidor.fa");
+#ifdef GENOMAS_INSTRUMENTACION
+    verificarInstrumentacion();
+#endif
+
+    cerr << casosComprobados - casosDistintos << " de " << casosComprobados << " casos iguales" << endl;
+    return casosDistintos == 0 ? 0 : 1;
+}